@@ -10,7 +10,10 @@ MAX_PACKET_SIZE = 48
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    SetIPCProfilerEnabled = 3,
+    ResetIPCProfiler = 4,
+    ReadIPCProfile = 5
 
 
 CITRA_PORT = 45987
@@ -99,6 +102,45 @@ class Citra:
                 return False
         return True
 
+    def _send_simple_request(self, request_type, address, size):
+        request_data = struct.pack('II', address, size)
+        request, request_id = self._generate_header(
+            request_type, len(request_data))
+        request += request_data
+        self.socket.sendto(request, (self.address, self.port))
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        return self._read_and_validate_header(raw_reply, request_id, request_type)
+
+    def set_ipc_profiler_enabled(self, enabled):
+        '''
+        >>> c.set_ipc_profiler_enabled(True)
+        True
+        '''
+        return None != self._send_simple_request(
+            RequestType.SetIPCProfilerEnabled, 1 if enabled else 0, 0)
+
+    def reset_ipc_profiler(self):
+        '''
+        >>> c.reset_ipc_profiler()
+        True
+        '''
+        return None != self._send_simple_request(RequestType.ResetIPCProfiler, 0, 0)
+
+    def read_ipc_profile(self):
+        '''
+        Returns the HLE service call profile as text, sorted by total host time.
+        '''
+        result = bytes()
+        while True:
+            reply_data = self._send_simple_request(
+                RequestType.ReadIPCProfile, len(result), MAX_REQUEST_DATA_SIZE)
+            if reply_data is None:
+                return None
+            if len(reply_data) == 0:
+                return result.decode('utf-8')
+            result += reply_data
+
 
 if __name__ == '__main__':
     import doctest
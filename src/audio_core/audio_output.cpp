@@ -0,0 +1,106 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "audio_core/audio_output.h"
+#include "core/settings.h"
+
+namespace AudioCore {
+
+AudioOutput::AudioOutput() = default;
+AudioOutput::~AudioOutput() = default;
+
+void AudioOutput::SetOutputSampleRate(unsigned int sample_rate) {
+    time_stretcher.SetOutputSampleRate(sample_rate);
+}
+
+void AudioOutput::EnableStretching(bool enable) {
+    if (perform_time_stretching == enable) {
+        return;
+    }
+
+    if (!enable) {
+        flushing_time_stretcher = true;
+    }
+
+    perform_time_stretching = enable;
+}
+
+void AudioOutput::Push(const s16* samples, std::size_t num_frames) {
+    fifo.Push(samples, num_frames);
+}
+
+void AudioOutput::Pull(s16* buffer, std::size_t num_frames) {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::size_t frames_written;
+    if (perform_time_stretching) {
+        const std::size_t num_in = fifo.Pop(stretch_scratch.data(), RingSize);
+        frames_written = time_stretcher.Process(stretch_scratch.data(), num_in, buffer, num_frames);
+    } else if (flushing_time_stretcher) {
+        time_stretcher.Flush();
+        frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
+        frames_written += fifo.Pop(buffer + 2 * frames_written, num_frames - frames_written);
+        flushing_time_stretcher = false;
+    } else {
+        frames_written = fifo.Pop(buffer, num_frames);
+    }
+
+    if (frames_written > 0) {
+        std::memcpy(&last_frame[0], buffer + 2 * (frames_written - 1), 2 * sizeof(s16));
+    }
+
+    // Hold last emitted frame; this prevents popping.
+    for (std::size_t i = frames_written; i < num_frames; i++) {
+        std::memcpy(buffer + 2 * i, &last_frame[0], 2 * sizeof(s16));
+    }
+
+    // Implementation of the hardware volume slider with a dynamic range of 60 dB
+    const float linear_volume = std::clamp(Settings::values.volume, 0.0f, 1.0f);
+    if (linear_volume != 1.0) {
+        const float volume_scale_factor =
+            linear_volume == 0 ? 0 : std::exp(6.90775f * linear_volume) * 0.001f;
+        for (std::size_t i = 0; i < num_frames; i++) {
+            buffer[i * 2 + 0] = static_cast<s16>(buffer[i * 2 + 0] * volume_scale_factor);
+            buffer[i * 2 + 1] = static_cast<s16>(buffer[i * 2 + 1] * volume_scale_factor);
+        }
+    }
+
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+    if (frames_written < num_frames) {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        underrun_frames.fetch_add(num_frames - frames_written, std::memory_order_relaxed);
+    }
+    const u64 ns = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - start)
+                                        .count());
+    total_callback_ns.fetch_add(ns, std::memory_order_relaxed);
+    // Only the sink thread writes the maximum, so a plain compare is enough
+    if (ns > max_callback_ns.load(std::memory_order_relaxed)) {
+        max_callback_ns.store(ns, std::memory_order_relaxed);
+    }
+}
+
+AudioOutput::Stats AudioOutput::GetStats() const {
+    Stats stats;
+    stats.callbacks = callbacks.load(std::memory_order_relaxed);
+    stats.underruns = underruns.load(std::memory_order_relaxed);
+    stats.underrun_frames = underrun_frames.load(std::memory_order_relaxed);
+    stats.total_callback_ns = total_callback_ns.load(std::memory_order_relaxed);
+    stats.max_callback_ns = max_callback_ns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AudioOutput::ResetStats() {
+    callbacks = 0;
+    underruns = 0;
+    underrun_frames = 0;
+    total_callback_ns = 0;
+    max_callback_ns = 0;
+}
+
+} // namespace AudioCore
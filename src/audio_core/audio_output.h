@@ -0,0 +1,76 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include "audio_core/time_stretch.h"
+#include "common/common_types.h"
+#include "common/ring_buffer.h"
+
+namespace AudioCore {
+
+/**
+ * Buffers the DSP output and feeds it to the sink. Pull runs on the sink's real-time audio thread,
+ * so nothing on that path allocates or locks: samples are passed through a lock-free ring and
+ * time stretching reads from a preallocated scratch buffer.
+ */
+class AudioOutput {
+public:
+    struct Stats {
+        /// Number of times the sink asked for audio
+        u64 callbacks = 0;
+        /// Callbacks that could not be filled completely
+        u64 underruns = 0;
+        /// Frames that had to be filled by repeating the last frame
+        u64 underrun_frames = 0;
+        u64 total_callback_ns = 0;
+        u64 max_callback_ns = 0;
+    };
+
+    AudioOutput();
+    ~AudioOutput();
+
+    void SetOutputSampleRate(unsigned int sample_rate);
+
+    /// Enable/Disable audio stretching.
+    void EnableStretching(bool enable);
+
+    /**
+     * Queues interleaved stereo frames for the sink. Must only be called from a single thread.
+     * Frames that do not fit in the ring are dropped.
+     */
+    void Push(const s16* samples, std::size_t num_frames);
+
+    /**
+     * Fills the sink buffer with interleaved stereo frames. Must only be called from the sink
+     * thread.
+     */
+    void Pull(s16* buffer, std::size_t num_frames);
+
+    Stats GetStats() const;
+
+    void ResetStats();
+
+private:
+    static constexpr std::size_t RingSize = 0x2000;
+
+    std::atomic<bool> perform_time_stretching = false;
+    std::atomic<bool> flushing_time_stretcher = false;
+    Common::RingBuffer<s16, RingSize, 2> fifo;
+    /// Frames popped from the ring before being passed to the time stretcher
+    std::array<s16, RingSize * 2> stretch_scratch{};
+    std::array<s16, 2> last_frame{};
+    TimeStretcher time_stretcher;
+
+    std::atomic<u64> callbacks{0};
+    std::atomic<u64> underruns{0};
+    std::atomic<u64> underrun_frames{0};
+    std::atomic<u64> total_callback_ns{0};
+    std::atomic<u64> max_callback_ns{0};
+};
+
+} // namespace AudioCore
@@ -13,20 +13,33 @@
 
 namespace AudioCore::Codec {
 
-StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
-                           const std::array<s16, 16>& adpcm_coeff, ADPCMState& state) {
+namespace {
+// The decoders below write both channels of the stereo output through a flat pointer, so that
+// the conversion loops compile to plain vector code.
+static_assert(sizeof(std::array<s16, 2>) == 2 * sizeof(s16));
+
+s16* Append(StereoBuffer16& out, std::size_t sample_count) {
+    const std::size_t offset = out.size();
+    out.resize(offset + sample_count);
+    return out[offset].data();
+}
+} // Anonymous namespace
+
+void DecodeADPCM(const u8* const data, const std::size_t sample_count,
+                 const std::array<s16, 16>& adpcm_coeff, ADPCMState& state, StereoBuffer16& out) {
     // GC-ADPCM with scale factor and variable coefficients.
     // Frames are 8 bytes long containing 14 samples each.
     // Samples are 4 bits (one nibble) long.
 
     constexpr std::size_t FRAME_LEN = 8;
     constexpr std::size_t SAMPLES_PER_FRAME = 14;
-    constexpr std::array<int, 16> SIGNED_NIBBLES = {
-        {0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1}};
 
     const std::size_t ret_size =
         sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
-    StereoBuffer16 ret(ret_size);
+    if (ret_size == 0) {
+        return;
+    }
+    s16* const ret = Append(out, ret_size);
 
     int yn1 = state.yn1, yn2 = state.yn2;
 
@@ -41,85 +54,79 @@ StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
         const int coef1 = adpcm_coeff[idx * 2 + 0];
         const int coef2 = adpcm_coeff[idx * 2 + 1];
 
-        // Decodes an audio sample. One nibble produces one sample.
-        const auto decode_sample = [&](const int nibble) -> s16 {
-            const int xn = nibble * scale;
-            // We first transform everything into 11 bit fixed point, perform the second order
-            // digital filter, then transform back.
-            // 0x400 == 0.5 in 11 bit fixed point.
+        // The last frame may be partial. Whole bytes (two samples) are always decoded.
+        const std::size_t outputi = framei * SAMPLES_PER_FRAME;
+        const std::size_t count = std::min(SAMPLES_PER_FRAME, ret_size - outputi);
+        const u8* const frame_data = data + framei * FRAME_LEN + 1;
+
+        // Unpack the whole block first, so that only the filter below depends on the previous
+        // sample. x[n] is transformed into 11 bit fixed point, with 0.5 (0x400) already added.
+        std::array<int, SAMPLES_PER_FRAME> xn;
+        for (std::size_t i = 0; i < count / 2; i++) {
+            const int high = static_cast<s8>(frame_data[i]) >> 4;
+            const int low = static_cast<s8>(frame_data[i] << 4) >> 4;
+            xn[i * 2 + 0] = high * (scale << 11) + 0x400;
+            xn[i * 2 + 1] = low * (scale << 11) + 0x400;
+        }
+
+        for (std::size_t i = 0; i < count; i++) {
             // Filter: y[n] = x[n] + 0.5 + c1 * y[n-1] + c2 * y[n-2]
-            int val = ((xn << 11) + 0x400 + coef1 * yn1 + coef2 * yn2) >> 11;
+            int val = (xn[i] + coef1 * yn1 + coef2 * yn2) >> 11;
             // Clamp to output range.
             val = std::clamp(val, -32768, 32767);
             // Advance output feedback.
             yn2 = yn1;
             yn1 = val;
-            return (s16)val;
-        };
-
-        std::size_t outputi = framei * SAMPLES_PER_FRAME;
-        std::size_t datai = framei * FRAME_LEN + 1;
-        for (std::size_t i = 0; i < SAMPLES_PER_FRAME && outputi < sample_count; i += 2) {
-            const s16 sample1 = decode_sample(SIGNED_NIBBLES[data[datai] >> 4]);
-            ret[outputi].fill(sample1);
-            outputi++;
 
-            const s16 sample2 = decode_sample(SIGNED_NIBBLES[data[datai] & 0xF]);
-            ret[outputi].fill(sample2);
-            outputi++;
-
-            datai++;
+            ret[(outputi + i) * 2 + 0] = static_cast<s16>(val);
+            ret[(outputi + i) * 2 + 1] = static_cast<s16>(val);
         }
     }
 
     state.yn1 = static_cast<s16>(yn1);
     state.yn2 = static_cast<s16>(yn2);
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
-                          const std::size_t sample_count) {
+void DecodePCM8(const unsigned num_channels, const u8* const data, const std::size_t sample_count,
+                StereoBuffer16& out) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
-    const auto decode_sample = [](u8 sample) {
-        return static_cast<s16>(static_cast<u16>(sample) << 8);
-    };
-
-    StereoBuffer16 ret(sample_count);
+    if (sample_count == 0) {
+        return;
+    }
+    s16* const ret = Append(out, sample_count);
 
     if (num_channels == 1) {
         for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i].fill(decode_sample(data[i]));
+            const s16 sample = static_cast<s16>(static_cast<u16>(data[i]) << 8);
+            ret[i * 2 + 0] = sample;
+            ret[i * 2 + 1] = sample;
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i][0] = decode_sample(data[i * 2 + 0]);
-            ret[i][1] = decode_sample(data[i * 2 + 1]);
+        for (std::size_t i = 0; i < sample_count * 2; i++) {
+            ret[i] = static_cast<s16>(static_cast<u16>(data[i]) << 8);
         }
     }
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
-                           const std::size_t sample_count) {
+void DecodePCM16(const unsigned num_channels, const u8* const data, const std::size_t sample_count,
+                 StereoBuffer16& out) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
-    StereoBuffer16 ret(sample_count);
+    if (sample_count == 0) {
+        return;
+    }
+    s16* const ret = Append(out, sample_count);
 
     if (num_channels == 1) {
         for (std::size_t i = 0; i < sample_count; i++) {
             s16 sample;
             std::memcpy(&sample, data + i * sizeof(s16), sizeof(s16));
-            ret[i].fill(sample);
+            ret[i * 2 + 0] = sample;
+            ret[i * 2 + 1] = sample;
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; ++i) {
-            std::memcpy(&ret[i], data + i * sizeof(s16) * 2, 2 * sizeof(s16));
-        }
+        std::memcpy(ret, data, sample_count * 2 * sizeof(s16));
     }
-
-    return ret;
 }
 } // namespace AudioCore::Codec
@@ -7,6 +7,7 @@
 #include "audio_core/sink.h"
 #include "audio_core/sink_details.h"
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "core/core.h"
 #include "core/dumping/backend.h"
 #include "core/settings.h"
@@ -14,13 +15,22 @@
 namespace AudioCore {
 
 DspInterface::DspInterface() = default;
-DspInterface::~DspInterface() = default;
+DspInterface::~DspInterface() {
+    const AudioOutput::Stats stats = output.GetStats();
+    if (stats.callbacks != 0) {
+        LOG_INFO(Audio,
+                 "{} sink callbacks, {} underruns ({} frames), {:.1f} us average, {:.1f} us max",
+                 stats.callbacks, stats.underruns, stats.underrun_frames,
+                 static_cast<double>(stats.total_callback_ns) / stats.callbacks / 1000.0,
+                 static_cast<double>(stats.max_callback_ns) / 1000.0);
+    }
+}
 
 void DspInterface::SetSink(const std::string& sink_id, const std::string& audio_device) {
     sink = CreateSinkFromID(Settings::values.sink_id, Settings::values.audio_device_id);
     sink->SetCallback(
-        [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
-    time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
+        [this](s16* buffer, std::size_t num_frames) { output.Pull(buffer, num_frames); });
+    output.SetOutputSampleRate(sink->GetNativeSampleRate());
 }
 
 Sink& DspInterface::GetSink() {
@@ -29,15 +39,11 @@ Sink& DspInterface::GetSink() {
 }
 
 void DspInterface::EnableStretching(bool enable) {
-    if (perform_time_stretching == enable) {
-        return;
-    }
-
-    if (!enable) {
-        flushing_time_stretcher = true;
-    }
+    output.EnableStretching(enable);
+}
 
-    perform_time_stretching = enable;
+AudioOutput::Stats DspInterface::GetOutputStats() const {
+    return output.GetStats();
 }
 
 void DspInterface::OutputFrame(StereoFrame16& frame) {
@@ -45,7 +51,7 @@ void DspInterface::OutputFrame(StereoFrame16& frame) {
         return;
     }
 
-    fifo.Push(frame.data(), frame.size());
+    output.Push(frame[0].data(), frame.size());
 
     if (Core::System::GetInstance().VideoDumper().IsDumping()) {
         Core::System::GetInstance().VideoDumper().AddAudioFrame(frame);
@@ -57,47 +63,11 @@ void DspInterface::OutputSample(std::array<s16, 2> sample) {
         return;
     }
 
-    fifo.Push(&sample, 1);
+    output.Push(sample.data(), 1);
 
     if (Core::System::GetInstance().VideoDumper().IsDumping()) {
         Core::System::GetInstance().VideoDumper().AddAudioSample(sample);
     }
 }
 
-void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
-    std::size_t frames_written;
-    if (perform_time_stretching) {
-        const std::vector<s16> in = fifo.Pop();
-        const std::size_t num_in = in.size() / 2;
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
-    } else if (flushing_time_stretcher) {
-        time_stretcher.Flush();
-        frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
-        frames_written += fifo.Pop(buffer, num_frames - frames_written);
-        flushing_time_stretcher = false;
-    } else {
-        frames_written = fifo.Pop(buffer, num_frames);
-    }
-
-    if (frames_written > 0) {
-        std::memcpy(&last_frame[0], buffer + 2 * (frames_written - 1), 2 * sizeof(s16));
-    }
-
-    // Hold last emitted frame; this prevents popping.
-    for (std::size_t i = frames_written; i < num_frames; i++) {
-        std::memcpy(buffer + 2 * i, &last_frame[0], 2 * sizeof(s16));
-    }
-
-    // Implementation of the hardware volume slider with a dynamic range of 60 dB
-    const float linear_volume = std::clamp(Settings::values.volume, 0.0f, 1.0f);
-    if (linear_volume != 1.0) {
-        const float volume_scale_factor =
-            linear_volume == 0 ? 0 : std::exp(6.90775f * linear_volume) * 0.001f;
-        for (std::size_t i = 0; i < num_frames; i++) {
-            buffer[i * 2 + 0] = static_cast<s16>(buffer[i * 2 + 0] * volume_scale_factor);
-            buffer[i * 2 + 1] = static_cast<s16>(buffer[i * 2 + 1] * volume_scale_factor);
-        }
-    }
-}
-
 } // namespace AudioCore
@@ -6,10 +6,9 @@
 
 #include <memory>
 #include <vector>
+#include "audio_core/audio_output.h"
 #include "audio_core/audio_types.h"
-#include "audio_core/time_stretch.h"
 #include "common/common_types.h"
-#include "common/ring_buffer.h"
 #include "core/memory.h"
 
 namespace Service::DSP {
@@ -98,21 +97,17 @@ public:
     Sink& GetSink();
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
+    /// Get the underrun and callback duration counters of the audio output
+    AudioOutput::Stats GetOutputStats() const;
 
 protected:
     void OutputFrame(StereoFrame16& frame);
     void OutputSample(std::array<s16, 2> sample);
 
 private:
-    void FlushResidualStretcherAudio();
-    void OutputCallback(s16* buffer, std::size_t num_frames);
-
+    // Declared first so that the sink, which calls into it from its own thread, is destroyed first
+    AudioOutput output;
     std::unique_ptr<Sink> sink;
-    std::atomic<bool> perform_time_stretching = false;
-    std::atomic<bool> flushing_time_stretcher = false;
-    Common::RingBuffer<s16, 0x2000, 2> fifo;
-    std::array<s16, 2> last_frame{};
-    TimeStretcher time_stretcher;
 };
 
 } // namespace AudioCore
@@ -4,6 +4,9 @@
 
 #include <algorithm>
 #include <array>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
@@ -30,6 +33,30 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
         return;
 
     const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
+    if (gains == std::array<float, 4>{}) {
+        // Most sources only feed one of the intermediate mixes
+        return;
+    }
+
+#ifdef ARCHITECTURE_x86_64
+    // Two frames at a time. Each stereo frame is widened to (left, right, left, right) so that one
+    // multiply scales all four channels, truncating like the scalar conversion below.
+    const __m128 gain_lanes = _mm_loadu_ps(gains.data());
+    const auto mix = [&](std::size_t samplei, __m128i sample) {
+        __m128i* const out = reinterpret_cast<__m128i*>(&dest[samplei]);
+        const __m128i scaled = _mm_cvttps_epi32(_mm_mul_ps(gain_lanes, _mm_cvtepi32_ps(sample)));
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), scaled));
+    };
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+        // left0 right0 left1 right1 -> left0 right0 left0 right0 left1 right1 left1 right1
+        const __m128i frames =
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&current_frame[samplei]));
+        const __m128i doubled = _mm_unpacklo_epi32(frames, frames);
+        // Sign extend each 16-bit sample to 32 bits
+        mix(samplei, _mm_srai_epi32(_mm_unpacklo_epi16(doubled, doubled), 16));
+        mix(samplei + 1, _mm_srai_epi32(_mm_unpackhi_epi16(doubled, doubled), 16));
+    }
+#else
     for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
         // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
         dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
@@ -37,6 +64,7 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
         dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
         dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
     }
+#endif
 }
 
 void Source::Reset() {
@@ -255,7 +283,8 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
 void Source::GenerateFrame() {
     current_frame.fill({});
 
-    if (state.current_buffer.empty() && !DequeueBuffer()) {
+    if (AudioInterp::IsBufferConsumed(state.current_buffer, state.current_buffer_position) &&
+        !DequeueBuffer()) {
         state.enabled = false;
         state.buffer_update = true;
         state.current_buffer_id = 0;
@@ -266,24 +295,27 @@ void Source::GenerateFrame() {
 
     state.current_sample_number = state.next_sample_number;
     while (frame_position < current_frame.size()) {
-        if (state.current_buffer.empty() && !DequeueBuffer()) {
+        if (AudioInterp::IsBufferConsumed(state.current_buffer, state.current_buffer_position) &&
+            !DequeueBuffer()) {
             break;
         }
 
         switch (state.interpolation_mode) {
         case InterpolationMode::None:
-            AudioInterp::None(state.interp_state, state.current_buffer, state.rate_multiplier,
-                              current_frame, frame_position);
+            AudioInterp::None(state.interp_state, state.current_buffer,
+                              state.current_buffer_position, state.rate_multiplier, current_frame,
+                              frame_position);
             break;
         case InterpolationMode::Linear:
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            AudioInterp::Linear(state.interp_state, state.current_buffer,
+                                state.current_buffer_position, state.rate_multiplier, current_frame,
+                                frame_position);
             break;
         case InterpolationMode::Polyphase:
-            // TODO(merry): Implement polyphase interpolation
-            LOG_DEBUG(Audio_DSP, "Polyphase interpolation unimplemented; falling back to linear");
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            // Note: The filter used by the firmware is unknown, this is a cubic approximation.
+            AudioInterp::Polyphase(state.interp_state, state.current_buffer,
+                                   state.current_buffer_position, state.rate_multiplier,
+                                   current_frame, frame_position);
             break;
         default:
             UNIMPLEMENTED();
@@ -296,7 +328,7 @@ void Source::GenerateFrame() {
 }
 
 bool Source::DequeueBuffer() {
-    ASSERT_MSG(state.current_buffer.empty(),
+    ASSERT_MSG(AudioInterp::IsBufferConsumed(state.current_buffer, state.current_buffer_position),
                "Shouldn't dequeue; we still have data in current_buffer");
 
     if (state.input_queue.empty()) {
@@ -316,18 +348,21 @@ bool Source::DequeueBuffer() {
     const u8* const memory =
         memory_system->GetPhysicalPointer(buffer.physical_address & 0xFFFFFFFC);
     if (memory) {
+        // The buffer is reused between buffers, so decoding does not allocate once it has grown
+        AudioInterp::StartBuffer(state.interp_state, state.current_buffer,
+                                 state.current_buffer_position);
         const unsigned num_channels = buffer.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
         switch (buffer.format) {
         case Format::PCM8:
-            state.current_buffer = Codec::DecodePCM8(num_channels, memory, buffer.length);
+            Codec::DecodePCM8(num_channels, memory, buffer.length, state.current_buffer);
             break;
         case Format::PCM16:
-            state.current_buffer = Codec::DecodePCM16(num_channels, memory, buffer.length);
+            Codec::DecodePCM16(num_channels, memory, buffer.length, state.current_buffer);
             break;
         case Format::ADPCM:
             DEBUG_ASSERT(num_channels == 1);
-            state.current_buffer =
-                Codec::DecodeADPCM(memory, buffer.length, state.adpcm_coeffs, state.adpcm_state);
+            Codec::DecodeADPCM(memory, buffer.length, state.adpcm_coeffs, state.adpcm_state,
+                               state.current_buffer);
             break;
         default:
             UNIMPLEMENTED();
@@ -338,6 +373,7 @@ bool Source::DequeueBuffer() {
                     "source_id={} buffer_id={} length={}: Invalid physical address {:#010x}",
                     source_id, buffer.buffer_id, buffer.length, buffer.physical_address);
         state.current_buffer.clear();
+        state.current_buffer_position = 0;
         return true;
     }
 
@@ -353,7 +389,7 @@ bool Source::DequeueBuffer() {
     }
 
     LOG_TRACE(Audio_DSP, "source_id={} buffer_id={} from_queue={} current_buffer.size()={}",
-              source_id, buffer.buffer_id, buffer.from_queue, state.current_buffer.size());
+              source_id, buffer.buffer_id, buffer.from_queue, state.current_buffer.size() - 3);
     return true;
 }
 
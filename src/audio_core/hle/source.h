@@ -116,6 +116,7 @@ private:
         u32 current_sample_number = 0;
         u32 next_sample_number = 0;
         AudioInterp::StereoBuffer16 current_buffer;
+        std::size_t current_buffer_position = 0;
 
         // buffer_id state
 
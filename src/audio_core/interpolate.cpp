@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cmath>
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -14,55 +15,86 @@ constexpr u64 scale_factor = 1 << 24;
 constexpr u64 scale_mask = scale_factor - 1;
 
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
+/// A pointer to the current sample x0 is passed to fn each step. It may read from x[-1] to x[2].
 template <typename Function>
-static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-                            std::size_t& outputi, Function fn) {
+static void StepOverSamples(State& state, const StereoBuffer16& input, std::size_t& inputi,
+                            float rate, StereoFrame16& output, std::size_t& outputi, Function fn) {
     ASSERT(rate > 0);
 
-    if (input.empty()) {
+    if (IsBufferConsumed(input, inputi)) {
         return;
     }
 
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    // The samples start with the two historical samples, x[n-3] is kept in front of them for the
+    // polyphase filter.
+    const std::array<s16, 2>* const samples = input.data() + inputi + 1;
+    const std::size_t num_samples = input.size() - inputi - 1;
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
-    std::size_t inputi = 0;
 
-    while (outputi < output.size()) {
-        inputi = static_cast<std::size_t>(fposition / scale_factor);
-
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
-            break;
-        }
-
-        u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+    // Work out how many samples can be produced before either buffer runs out, so that the loop
+    // below does no bounds checking and can be vectorized. Each step reads up to
+    // samples[position + 2], so positions up to num_samples - 3 can be used.
+    const u64 end_fposition = static_cast<u64>(num_samples - 2) * scale_factor;
+    const std::size_t output_left = output.size() - outputi;
+    std::size_t count = 0;
+    if (fposition < end_fposition) {
+        count = step_size == 0 ? output_left
+                               : static_cast<std::size_t>(std::min<u64>(
+                                     output_left, (end_fposition - fposition + step_size - 1) /
+                                                      step_size));
+    }
 
-        fposition += step_size;
+    for (std::size_t i = 0; i < count; i++) {
+        const u64 position = fposition + i * step_size;
+        const std::size_t samplei = static_cast<std::size_t>(position / scale_factor);
+        output[outputi + i] = fn(position & scale_mask, samples + samplei);
+    }
+    outputi += count;
+
+    // The last sample used becomes the new x[n-2]. If the input ran out first, everything is
+    // consumed and the last two samples become the history.
+    std::size_t consumed;
+    if (count == output_left && count != 0) {
+        consumed = static_cast<std::size_t>((fposition + (count - 1) * step_size) / scale_factor);
+    } else if (count == output_left) {
+        consumed = 0;
+    } else {
+        consumed = num_samples - 2;
     }
+    fposition += count * step_size;
 
-    state.xn2 = input[inputi];
-    state.xn1 = input[inputi + 1];
-    state.fposition = fposition - inputi * scale_factor;
+    state.xn3 = samples[consumed - 1];
+    state.xn2 = samples[consumed];
+    state.xn1 = samples[consumed + 1];
+    state.fposition = fposition - consumed * scale_factor;
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    inputi += consumed;
 }
 
-void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-          std::size_t& outputi) {
+void StartBuffer(const State& state, StereoBuffer16& input, std::size_t& inputi) {
+    input.clear();
+    input.push_back(state.xn3);
+    input.push_back(state.xn2);
+    input.push_back(state.xn1);
+    inputi = 0;
+}
+
+void None(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+          StereoFrame16& output, std::size_t& outputi) {
     StepOverSamples(
-        state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+        state, input, inputi, rate, output, outputi,
+        [](u64 fraction, const std::array<s16, 2>* x) { return x[0]; });
 }
 
-void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-            std::size_t& outputi) {
+void Linear(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+            StereoFrame16& output, std::size_t& outputi) {
     // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
-    StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
+    StepOverSamples(state, input, inputi, rate, output, outputi,
+                    [](u64 fraction, const std::array<s16, 2>* x) {
+                        const std::array<s16, 2>& x0 = x[0];
+                        const std::array<s16, 2>& x1 = x[1];
                         // This is a saturated subtraction. (Verified by black-box fuzzing.)
                         s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
                         s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
@@ -74,4 +106,72 @@ void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& outp
                     });
 }
 
+namespace {
+/// Number of phases in the polyphase filter table. The top bits of the fractional position pick
+/// the phase.
+constexpr std::size_t num_phases = 256;
+constexpr u64 phase_shift = 24 - 8;
+static_assert(num_phases == 1 << (24 - phase_shift));
+
+/// Taps are fixed point with 14 fractional bits.
+constexpr int tap_bits = 14;
+
+using PhaseTable = std::array<std::array<s32, 4>, num_phases>;
+
+/// Builds the taps of a 4-tap cubic (Catmull-Rom) filter for every phase. Tap k of phase p
+/// weights x[k - 1] for an output at x[0] + p / num_phases.
+PhaseTable BuildPhaseTable() {
+    PhaseTable table;
+    for (std::size_t phase = 0; phase < num_phases; phase++) {
+        const double t = static_cast<double>(phase) / num_phases;
+        const std::array<double, 4> weights{
+            (-t * t * t + 2 * t * t - t) / 2,
+            (3 * t * t * t - 5 * t * t + 2) / 2,
+            (-3 * t * t * t + 4 * t * t + t) / 2,
+            (t * t * t - t * t) / 2,
+        };
+
+        // The weights add up to one, so that a constant signal passes through unchanged. Rounding
+        // errors go to the largest tap to keep it that way.
+        s32 total = 0;
+        std::size_t largest = 0;
+        for (std::size_t k = 0; k < 4; k++) {
+            table[phase][k] = static_cast<s32>(std::lround(weights[k] * (1 << tap_bits)));
+            total += table[phase][k];
+            if (weights[k] > weights[largest]) {
+                largest = k;
+            }
+        }
+        table[phase][largest] += (1 << tap_bits) - total;
+    }
+    return table;
+}
+
+const PhaseTable& GetPhaseTable() {
+    static const PhaseTable table = BuildPhaseTable();
+    return table;
+}
+} // Anonymous namespace
+
+void Polyphase(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+               StereoFrame16& output, std::size_t& outputi) {
+    const PhaseTable& table = GetPhaseTable();
+    StepOverSamples(state, input, inputi, rate, output, outputi,
+                    [&table](u64 fraction, const std::array<s16, 2>* x) {
+                        const std::array<s32, 4>& taps = table[fraction >> phase_shift];
+                        const s32 left = taps[0] * x[-1][0] + taps[1] * x[0][0] +
+                                         taps[2] * x[1][0] + taps[3] * x[2][0];
+                        const s32 right = taps[0] * x[-1][1] + taps[1] * x[0][1] +
+                                          taps[2] * x[1][1] + taps[3] * x[2][1];
+                        // Round to nearest, then saturate as the filter can overshoot
+                        constexpr s32 round = 1 << (tap_bits - 1);
+                        return std::array<s16, 2>{
+                            static_cast<s16>(
+                                std::clamp((left + round) >> tap_bits, -32768, 32767)),
+                            static_cast<s16>(
+                                std::clamp((right + round) >> tap_bits, -32768, 32767)),
+                        };
+                    });
+}
+
 } // namespace AudioCore::AudioInterp
@@ -5,45 +5,82 @@
 #pragma once
 
 #include <array>
-#include <deque>
+#include <vector>
 #include "audio_core/audio_types.h"
 #include "common/common_types.h"
 
 namespace AudioCore::AudioInterp {
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/**
+ * A variable length, contiguous buffer of signed PCM16 stereo samples. The interpolators read it
+ * from a position that points at the three historical samples, x[n-3], x[n-2] and x[n-1], which
+ * are followed by the samples that have not been consumed yet.
+ */
+using StereoBuffer16 = std::vector<std::array<s16, 2>>;
 
 struct State {
-    /// Two historical samples.
+    /// Historical samples. These are placed in front of the next buffer (see StartBuffer).
     std::array<s16, 2> xn1 = {}; ///< x[n-1]
     std::array<s16, 2> xn2 = {}; ///< x[n-2]
+    std::array<s16, 2> xn3 = {}; ///< x[n-3], only used by the polyphase filter
     /// Current fractional position.
     u64 fposition = 0;
 };
 
+/**
+ * Starts a new input buffer with the historical samples. The decoded samples are then
+ * appended to it.
+ * @param state Interpolation state.
+ * @param input Input buffer.
+ * @param inputi Position to read input from, reset to the historical samples.
+ */
+void StartBuffer(const State& state, StereoBuffer16& input, std::size_t& inputi);
+
+/**
+ * Returns whether all samples of the input buffer have been consumed.
+ */
+inline bool IsBufferConsumed(const StereoBuffer16& input, std::size_t inputi) {
+    return inputi + 3 >= input.size();
+}
+
 /**
  * No interpolation. This is equivalent to a zero-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
  * @param input Input buffer.
+ * @param inputi Position to read input from. This is advanced past the consumed samples.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
  * @param outputi The index of output to start writing to.
  */
-void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-          std::size_t& outputi);
+void None(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+          StereoFrame16& output, std::size_t& outputi);
 
 /**
  * Linear interpolation. This is equivalent to a first-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
  * @param input Input buffer.
+ * @param inputi Position to read input from. This is advanced past the consumed samples.
+ * @param rate Stretch factor. Must be a positive non-zero value.
+ *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
+ * @param output The resampled audio buffer.
+ * @param outputi The index of output to start writing to.
+ */
+void Linear(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+            StereoFrame16& output, std::size_t& outputi);
+
+/**
+ * Polyphase interpolation with a 4-tap cubic (Catmull-Rom) filter. Taps are precomputed for 256
+ * phases of the fractional position. There is a two-sample predelay, as for the other modes.
+ * @param state Interpolation state.
+ * @param input Input buffer.
+ * @param inputi Position to read input from. This is advanced past the consumed samples.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
  * @param outputi The index of output to start writing to.
  */
-void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-            std::size_t& outputi);
+void Polyphase(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+               StereoFrame16& output, std::size_t& outputi);
 
 } // namespace AudioCore::AudioInterp
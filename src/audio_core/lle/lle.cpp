@@ -4,6 +4,7 @@
 
 #include <array>
 #include <atomic>
+#include <deque>
 #include <thread>
 #include <teakra/teakra.h>
 #include "audio_core/lle/lle.h"
@@ -11,7 +12,6 @@
 #include "common/bit_field.h"
 #include "common/swap.h"
 #include "common/thread.h"
-#include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/lock.h"
 #include "core/hle/service/dsp/dsp_dsp.h"
@@ -120,9 +120,27 @@ static u8 PipeIndexToSlotIndex(u8 pipe_index, PipeDirection direction) {
     return (pipe_index << 1) + static_cast<u8>(direction);
 }
 
+/// Set while the current thread is inside Teakra::Run, so that callbacks raised by the DSP can
+/// tell that they must not run Teakra themselves.
+static thread_local bool in_teakra_slice = false;
+
+/// A register write from the CPU side. In multithread mode these are delivered by the Teakra
+/// thread between slices instead of touching Teakra while it runs.
+struct Command {
+    enum class Type : u8 {
+        SetSemaphore,
+        SendData,
+    };
+
+    Type type;
+    u8 register_number;
+    u16 value;
+};
+
 struct DspLle::Impl final {
-    Impl(bool multithread) : multithread(multithread) {
-        teakra_slice_event = Core::System::GetInstance().CoreTiming().RegisterEvent(
+    Impl(Core::Timing& timing, bool multithread, bool deterministic)
+        : timing(timing), multithread(multithread), deterministic(deterministic) {
+        teakra_slice_event = timing.RegisterEvent(
             "DSP slice", [this](u64, int late) { TeakraSliceEvent(static_cast<u64>(late)); });
     }
 
@@ -136,44 +154,124 @@ struct DspLle::Impl final {
     bool semaphore_signaled = false;
     bool data_signaled = false;
 
+    Core::Timing& timing;
     Core::TimingEventType* teakra_slice_event;
     std::atomic<bool> loaded = false;
 
     const bool multithread;
+    /// Makes the emulation thread wait for every slice, so that multithread mode produces the
+    /// same results as single thread mode.
+    const bool deterministic;
     std::thread teakra_thread;
     Common::Barrier teakra_slice_barrier{2};
     std::atomic<bool> stop_signal = false;
     std::size_t stop_generation;
 
+    /**
+     * Commands submitted by the emulation thread for the Teakra thread. The emulation thread
+     * fills mailbox[submit_index] between two barrier syncs, and each sync hands that buffer over
+     * to the Teakra thread, which drains it before running its next slice. Both sides flip their
+     * index on every sync, so the two threads never touch the same buffer at once and commands
+     * always reach the DSP at the same slice boundary, regardless of thread scheduling.
+     */
+    std::array<std::vector<Command>, 2> mailbox;
+    std::size_t submit_index = 0;
+    std::size_t apply_index = 0;
+    /// Commands waiting for their register to become free. Owned by the thread running Teakra.
+    std::deque<Command> pending_commands;
+
     static constexpr u32 DspDataOffset = 0x40000;
     static constexpr u32 TeakraSlice = 20000;
 
+    bool ApplyCommand(const Command& command) {
+        switch (command.type) {
+        case Command::Type::SetSemaphore:
+            teakra.SetSemaphore(command.value);
+            return true;
+        case Command::Type::SendData:
+            if (!teakra.SendDataIsEmpty(command.register_number)) {
+                return false;
+            }
+            teakra.SendData(command.register_number, command.value);
+            return true;
+        }
+        UNREACHABLE();
+    }
+
+    void ApplyPendingCommands() {
+        while (!pending_commands.empty() && ApplyCommand(pending_commands.front())) {
+            pending_commands.pop_front();
+        }
+    }
+
+    void SubmitCommand(const Command& command) {
+        if (in_teakra_slice) {
+            // Raised by a Teakra callback, deliver it once the slice is over
+            pending_commands.push_back(command);
+        } else if (teakra_thread.joinable()) {
+            mailbox[submit_index].push_back(command);
+        } else if (!pending_commands.empty() || !ApplyCommand(command)) {
+            pending_commands.push_back(command);
+        }
+    }
+
+    /// Runs a slice on the current thread.
+    void RunSlice() {
+        ApplyPendingCommands();
+        in_teakra_slice = true;
+        teakra.Run(TeakraSlice);
+        in_teakra_slice = false;
+    }
+
     void TeakraThread() {
         while (true) {
-            teakra.Run(TeakraSlice);
             teakra_slice_barrier.Sync();
             if (stop_signal) {
                 if (stop_generation == teakra_slice_barrier.Generation())
                     break;
             }
+            std::vector<Command>& commands = mailbox[apply_index];
+            pending_commands.insert(pending_commands.end(), commands.begin(), commands.end());
+            commands.clear();
+            apply_index ^= 1;
+            RunSlice();
+            if (deterministic) {
+                teakra_slice_barrier.Sync();
+            }
         }
         stop_signal = false;
     }
 
+    void StartTeakraThread() {
+        submit_index = 0;
+        apply_index = 0;
+        teakra_thread = std::thread(&Impl::TeakraThread, this);
+    }
+
     void StopTeakraThread() {
         if (teakra_thread.joinable()) {
             stop_generation = teakra_slice_barrier.Generation() + 1;
             stop_signal = true;
             teakra_slice_barrier.Sync();
             teakra_thread.join();
+
+            // Keep whatever was not delivered yet, in order, for the emulation thread
+            std::vector<Command>& commands = mailbox[submit_index];
+            pending_commands.insert(pending_commands.end(), commands.begin(), commands.end());
+            commands.clear();
         }
     }
 
     void RunTeakraSlice() {
         if (multithread) {
+            // Lets the Teakra thread take the submitted commands and start its next slice
             teakra_slice_barrier.Sync();
+            submit_index ^= 1;
+            if (deterministic) {
+                teakra_slice_barrier.Sync();
+            }
         } else {
-            teakra.Run(TeakraSlice);
+            RunSlice();
         }
     }
 
@@ -184,7 +282,7 @@ struct DspLle::Impl final {
             next = 0;
         else
             next -= late;
-        Core::System::GetInstance().CoreTiming().ScheduleEvent(next, teakra_slice_event, 0);
+        timing.ScheduleEvent(next, teakra_slice_event, 0);
     }
 
     u8* GetDspDataPointer(u32 baddr) {
@@ -250,9 +348,7 @@ struct DspLle::Impl final {
         }
         if (need_update) {
             UpdatePipeStatus(pipe_status);
-            while (!teakra.SendDataIsEmpty(2))
-                RunTeakraSlice();
-            teakra.SendData(2, pipe_status.slot_index);
+            SubmitCommand({Command::Type::SendData, 2, pipe_status.slot_index});
         }
     }
 
@@ -287,10 +383,7 @@ struct DspLle::Impl final {
         }
         if (need_update) {
             UpdatePipeStatus(pipe_status);
-            while (!teakra.SendDataIsEmpty(2)) {
-                RunTeakraSlice();
-            }
-            teakra.SendData(2, pipe_status.slot_index);
+            SubmitCommand({Command::Type::SendData, 2, pipe_status.slot_index});
         }
         return data;
     }
@@ -310,6 +403,7 @@ struct DspLle::Impl final {
         }
 
         teakra.Reset();
+        pending_commands.clear();
 
         const Dsp1 dsp(buffer);
         auto& dsp_memory = teakra.GetDspMemory();
@@ -326,10 +420,10 @@ struct DspLle::Impl final {
 
         // TODO: load special segment
 
-        Core::System::GetInstance().CoreTiming().ScheduleEvent(TeakraSlice, teakra_slice_event, 0);
+        timing.ScheduleEvent(TeakraSlice, teakra_slice_event, 0);
 
         if (multithread) {
-            teakra_thread = std::thread(&Impl::TeakraThread, this);
+            StartTeakraThread();
         }
 
         // Wait for initialization
@@ -362,11 +456,7 @@ struct DspLle::Impl final {
 
         // Send finalization signal via command/reply register 2
         constexpr u16 FinalizeSignal = 0x8000;
-        while (!teakra.SendDataIsEmpty(2)) {
-            RunTeakraSlice();
-        }
-
-        teakra.SendData(2, FinalizeSignal);
+        SubmitCommand({Command::Type::SendData, 2, FinalizeSignal});
 
         // Wait for completion
         while (!teakra.RecvDataIsReady(2)) {
@@ -375,7 +465,7 @@ struct DspLle::Impl final {
 
         teakra.RecvData(2); // discard the value
 
-        Core::System::GetInstance().CoreTiming().UnscheduleEvent(teakra_slice_event, 0);
+        timing.UnscheduleEvent(teakra_slice_event, 0);
         StopTeakraThread();
     }
 };
@@ -392,7 +482,7 @@ bool DspLle::RecvDataIsReady(u32 register_number) const {
 }
 
 void DspLle::SetSemaphore(u16 semaphore_value) {
-    impl->teakra.SetSemaphore(semaphore_value);
+    impl->SubmitCommand({Command::Type::SetSemaphore, 0, semaphore_value});
 }
 
 std::vector<u8> DspLle::PipeRead(DspPipe pipe_number, u32 length) {
@@ -483,8 +573,9 @@ void DspLle::UnloadComponent() {
     impl->UnloadComponent();
 }
 
-DspLle::DspLle(Memory::MemorySystem& memory, bool multithread)
-    : impl(std::make_unique<Impl>(multithread)) {
+DspLle::DspLle(Memory::MemorySystem& memory, Core::Timing& timing, bool multithread,
+               bool deterministic)
+    : impl(std::make_unique<Impl>(timing, multithread, deterministic)) {
     Teakra::AHBMCallback ahbm;
     ahbm.read8 = [&memory](u32 address) -> u8 {
         return *memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR);
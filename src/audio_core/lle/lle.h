@@ -6,11 +6,22 @@
 
 #include "audio_core/dsp_interface.h"
 
+namespace Core {
+class Timing;
+} // namespace Core
+
 namespace AudioCore {
 
 class DspLle final : public DspInterface {
 public:
-    explicit DspLle(Memory::MemorySystem& memory, bool multithread);
+    /**
+     * @param multithread Run the DSP on its own thread. Register writes from the CPU side are then
+     * queued and delivered between DSP slices, instead of stalling the emulation thread.
+     * @param deterministic In multithread mode, wait for every DSP slice to finish, so that the
+     * results match single thread mode exactly. Meant for tests.
+     */
+    DspLle(Memory::MemorySystem& memory, Core::Timing& timing, bool multithread,
+           bool deterministic = false);
     ~DspLle() override;
 
     u16 RecvData(u32 register_number) override;
@@ -110,18 +110,26 @@ void Config::ReadValues() {
         static_cast<u64>(sdl2_config->GetInteger("Core", "custom_cpu_ticks", 77));
     Settings::values.cpu_clock_percentage =
         sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100);
+    Settings::values.skip_idle_loops = sdl2_config->GetBoolean("Core", "skip_idle_loops", false);
 
     // Renderer
     Settings::values.use_hw_renderer = sdl2_config->GetBoolean("Renderer", "use_hw_renderer", true);
+    Settings::values.use_gpu_thread = sdl2_config->GetBoolean("Renderer", "use_gpu_thread", false);
     Settings::values.use_hw_shader = sdl2_config->GetBoolean("Renderer", "use_hw_shader", true);
     Settings::values.shaders_accurate_mul =
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_mul", false);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
     Settings::values.resolution_factor =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "resolution_factor", 1));
+    Settings::values.texture_memory_budget =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "texture_memory_budget", 0));
+    Settings::values.hash_texture_uploads =
+        sdl2_config->GetBoolean("Renderer", "hash_texture_uploads", false);
     Settings::values.use_frame_limit = sdl2_config->GetBoolean("Renderer", "use_frame_limit", true);
     Settings::values.enable_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "enable_disk_shader_cache", false);
+    Settings::values.use_async_shader_compilation =
+        sdl2_config->GetBoolean("Renderer", "use_async_shader_compilation", false);
     Settings::values.frame_limit =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100));
     Settings::values.use_vsync_new =
@@ -169,6 +177,8 @@ void Config::ReadValues() {
     Settings::values.custom_textures = sdl2_config->GetBoolean("Utility", "custom_textures", false);
     Settings::values.preload_textures =
         sdl2_config->GetBoolean("Utility", "preload_textures", false);
+    Settings::values.video_dumping_queue_depth =
+        static_cast<u32>(sdl2_config->GetInteger("Utility", "video_dumping_queue_depth", 8));
 
     // Audio
     Settings::values.enable_dsp_lle = sdl2_config->GetBoolean("Audio", "enable_dsp_lle", false);
@@ -245,6 +255,7 @@ void Config::ReadValues() {
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    Settings::values.profile_ipc = sdl2_config->GetBoolean("Debugging", "profile_ipc", false);
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
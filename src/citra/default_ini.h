@@ -103,11 +103,20 @@ custom_cpu_ticks =
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Whether to fast-forward to the next scheduled event when the guest spins in a polling loop
+# 0 (default): Off, 1: On
+skip_idle_loops =
+
 [Renderer]
 # Whether to use software or hardware rendering.
 # 0: Software, 1 (default): Hardware
 use_hw_renderer =
 
+# Whether to run PICA command lists, memory fills and display transfers on a separate thread.
+# Only used by the software renderer.
+# 0 (default): Off, 1: On
+use_gpu_thread =
+
 # Whether to use hardware shaders to emulate 3DS shaders
 # 0: Software, 1 (default): Hardware
 use_hw_shader =
@@ -124,6 +133,11 @@ use_shader_jit =
 # 0: Off (default), 1: On
 enable_disk_shader_cache =
 
+# Compile new fragment shaders in the background, rendering with a generic shader until they are
+# ready. Reduces stuttering the first time an effect is seen, but the generic shader is slower.
+# 0: Off (default), 1: On
+use_async_shader_compilation =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
@@ -134,6 +148,15 @@ use_vsync_new =
 # factor for the 3DS resolution
 resolution_factor =
 
+# Video memory cached textures may take, in MiB. When it is exceeded, the textures that haven't
+# been used for the longest time are freed.
+# 0 (default): Unlimited, Otherwise the budget in MiB
+texture_memory_budget =
+
+# Hash texture data reloaded from emulated memory, and skip uploading it again when it didn't change
+# 0 (default): Off, 1: On
+hash_texture_uploads =
+
 # Turns on the frame limiter, which will limit frames output to the target game speed
 # 0: Off, 1: On (default)
 use_frame_limit =
@@ -204,6 +227,11 @@ custom_textures =
 # 0 (default): Off, 1: On
 preload_textures =
 
+# Number of frames that can wait for the encoder while dumping video. Deeper queues absorb slow
+# frames (such as keyframes) without stalling emulation, at the cost of one frame of memory each.
+# Must be at least 1. Default: 8
+video_dumping_queue_depth =
+
 [Audio]
 # Whether or not to enable DSP LLE
 # 0 (default): No, 1: Yes
@@ -295,6 +323,9 @@ log_filter = *:Info
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
+# Profile HLE service calls. The results are periodically written to ipc_profile.txt in the log
+# directory. 0 (default): Off, 1: On
+profile_ipc =
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
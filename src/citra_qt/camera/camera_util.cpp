@@ -3,7 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include <QImage>
 #include "citra_qt/camera/camera_util.h"
 #include "core/frontend/camera/factory.h"
@@ -169,48 +173,148 @@ constexpr std::array<int, 256> V_B = {
 static constexpr int V(int r, int g, int b) {
     return V_R[r] - V_G[g] - V_B[b];
 }
-} // namespace YuvTable
 
-std::vector<u16> Rgb2Yuv(const QImage& source, int width, int height) {
-    std::vector<u16> buffer(width * height);
-    std::vector<u16>::iterator dest = buffer.begin();
-    bool write = false;
-    int py, pu, pv;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            QRgb rgb = source.pixel(x, y);
-            int r = qRed(rgb);
-            int g = qGreen(rgb);
-            int b = qBlue(rgb);
-
-            // The following transformation is a reverse of the one in Y2R using ITU_Rec601
-            int y = YuvTable::Y(r, g, b);
-            int u = YuvTable::U(r, g, b);
-            int v = YuvTable::V(r, g, b);
-
-            if (write) {
-                pu = (pu + u) / 2;
-                pv = (pv + v) / 2;
-                *(dest++) =
-                    static_cast<u16>(std::clamp(py, 0, 0xFF) | (std::clamp(pu, 0, 0xFF) << 8));
-                *(dest++) =
-                    static_cast<u16>(std::clamp(y, 0, 0xFF) | (std::clamp(pv, 0, 0xFF) << 8));
-            } else {
-                py = y;
-                pu = u;
-                pv = v;
-            }
-            write = !write;
+/// Fixed-point forms of the tables above, used to convert several pixels at once
+namespace Fixed {
+
+struct Coefficients {
+    int factor;
+    int offset;
+    int shift;
+};
+
+constexpr Coefficients Y_R{1223, 218559, 12};
+constexpr Coefficients Y_G{1203, -163837, 11};
+constexpr Coefficients Y_B{117, 26393, 10};
+constexpr Coefficients U_R{1383, 246936, 13};
+constexpr Coefficients U_G{85, -11574, 8};
+constexpr Coefficients U_B{32, 7232, 6};
+constexpr Coefficients V_R{257, 45850, 9};
+constexpr Coefficients V_G{215, -29278, 9};
+constexpr Coefficients V_B{669, 150965, 13};
+
+/// Computes (value * factor + offset) / 2^shift, rounding toward zero like the tables do
+constexpr int Scale(const Coefficients& coefficients, int value) {
+    return (value * coefficients.factor + coefficients.offset) / (1 << coefficients.shift);
+}
+
+constexpr bool Matches(const Coefficients& coefficients, const std::array<int, 256>& table) {
+    for (int i = 0; i < 256; ++i) {
+        if (Scale(coefficients, i) != table[i]) {
+            return false;
         }
     }
-    return buffer;
+    return true;
+}
+
+static_assert(Matches(Y_R, YuvTable::Y_R) && Matches(Y_G, YuvTable::Y_G) &&
+                  Matches(Y_B, YuvTable::Y_B) && Matches(U_R, YuvTable::U_R) &&
+                  Matches(U_G, YuvTable::U_G) && Matches(U_B, YuvTable::U_B) &&
+                  Matches(V_R, YuvTable::V_R) && Matches(V_G, YuvTable::V_G) &&
+                  Matches(V_B, YuvTable::V_B),
+              "Fixed-point conversion must give the same results as the tables");
+
+} // namespace Fixed
+} // namespace YuvTable
+
+namespace {
+
+/// Packs two converted pixels into two YUV422 values, averaging their chroma
+void WritePair(int y0, int u0, int v0, int y1, int u1, int v1, u16* dest) {
+    const int u = (u0 + u1) / 2;
+    const int v = (v0 + v1) / 2;
+    dest[0] = static_cast<u16>(std::clamp(y0, 0, 0xFF) | (std::clamp(u, 0, 0xFF) << 8));
+    dest[1] = static_cast<u16>(std::clamp(y1, 0, 0xFF) | (std::clamp(v, 0, 0xFF) << 8));
+}
+
+#ifdef ARCHITECTURE_x86_64
+/// Computes Fixed::Scale on four 32-bit lanes holding values below 256
+__m128i ScaleLanes(const YuvTable::Fixed::Coefficients& coefficients, __m128i value) {
+    // The high halves of the lanes are zero, so a 16-bit multiply-add gives the full product
+    const __m128i product = _mm_madd_epi16(value, _mm_set1_epi32(coefficients.factor));
+    __m128i sum = _mm_add_epi32(product, _mm_set1_epi32(coefficients.offset));
+    if (coefficients.offset < 0) {
+        // Arithmetic shifts round toward negative infinity, bias negative sums to round to zero
+        const __m128i bias = _mm_and_si128(_mm_srai_epi32(sum, 31),
+                                           _mm_set1_epi32((1 << coefficients.shift) - 1));
+        sum = _mm_add_epi32(sum, bias);
+    }
+    return _mm_sra_epi32(sum, _mm_cvtsi32_si128(coefficients.shift));
+}
+
+/// Converts four pixels, returning their Y, U and V in 32-bit lanes
+void ConvertLanes(__m128i pixels, __m128i& y, __m128i& u, __m128i& v) {
+    using namespace YuvTable::Fixed;
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), mask);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), mask);
+    const __m128i b = _mm_and_si128(pixels, mask);
+    y = _mm_add_epi32(_mm_add_epi32(ScaleLanes(Y_R, r), ScaleLanes(Y_G, g)), ScaleLanes(Y_B, b));
+    u = _mm_sub_epi32(_mm_sub_epi32(ScaleLanes(U_B, b), ScaleLanes(U_R, r)), ScaleLanes(U_G, g));
+    v = _mm_sub_epi32(_mm_sub_epi32(ScaleLanes(V_R, r), ScaleLanes(V_G, g)), ScaleLanes(V_B, b));
+}
+
+/// Converts eight pixels to eight YUV422 values
+void ConvertEight(const QRgb* source, u16* dest) {
+    __m128i y_low, u_low, v_low, y_high, u_high, v_high;
+    ConvertLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)), y_low, u_low, v_low);
+    ConvertLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4)), y_high, u_high,
+                 v_high);
+
+    // Sum the chroma of each pair of pixels. U and V are never negative, so halving is a shift.
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i u = _mm_srli_epi32(_mm_madd_epi16(_mm_packs_epi32(u_low, u_high), ones), 1);
+    const __m128i v = _mm_srli_epi32(_mm_madd_epi16(_mm_packs_epi32(v_low, v_high), ones), 1);
+
+    // Saturate to bytes: Y0..Y7 followed by U0 V0 .. U3 V3, then interleave into Y U Y V order
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(y_low, y_high),
+                                            _mm_or_si128(u, _mm_slli_epi32(v, 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_unpacklo_epi8(packed, _mm_srli_si128(packed, 8)));
+}
+#endif // ARCHITECTURE_x86_64
+
+} // Anonymous namespace
+
+void Rgb2Yuv(const QImage& source, int width, int height, u16* dest) {
+    // 32-bit images have no padding between lines, so the pixels can be read in one run
+    const QImage image = source.format() == QImage::Format_RGB32 ||
+                                 source.format() == QImage::Format_ARGB32
+                             ? source
+                             : source.convertToFormat(QImage::Format_RGB32);
+    const QRgb* pixels = reinterpret_cast<const QRgb*>(image.constBits());
+    const std::size_t count = static_cast<std::size_t>(width) * height;
+
+    std::size_t i = 0;
+#ifdef ARCHITECTURE_x86_64
+    for (; i + 8 <= count; i += 8) {
+        ConvertEight(pixels + i, dest + i);
+    }
+#endif
+    for (; i + 2 <= count; i += 2) {
+        const QRgb first = pixels[i];
+        const QRgb second = pixels[i + 1];
+
+        // The following transformation is a reverse of the one in Y2R using ITU_Rec601
+        WritePair(YuvTable::Y(qRed(first), qGreen(first), qBlue(first)),
+                  YuvTable::U(qRed(first), qGreen(first), qBlue(first)),
+                  YuvTable::V(qRed(first), qGreen(first), qBlue(first)),
+                  YuvTable::Y(qRed(second), qGreen(second), qBlue(second)),
+                  YuvTable::U(qRed(second), qGreen(second), qBlue(second)),
+                  YuvTable::V(qRed(second), qGreen(second), qBlue(second)), dest + i);
+    }
+    if (i < count) {
+        // A pixel without a partner has no chroma to share
+        dest[i] = 0;
+    }
 }
 
-std::vector<u16> ProcessImage(const QImage& image, int width, int height, bool output_rgb = false,
-                              bool flip_horizontal = false, bool flip_vertical = false) {
-    std::vector<u16> buffer(width * height);
+void ProcessImage(const QImage& image, int width, int height, bool output_rgb,
+                  bool flip_horizontal, bool flip_vertical, std::vector<u16>& buffer) {
+    buffer.resize(static_cast<std::size_t>(width) * height);
     if (image.isNull()) {
-        return buffer;
+        std::fill(buffer.begin(), buffer.end(), 0);
+        return;
     }
     QImage scaled =
         image.scaled(width, height, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
@@ -221,9 +325,8 @@ std::vector<u16> ProcessImage(const QImage& image, int width, int height, bool o
         QImage converted = transformed.convertToFormat(QImage::Format_RGB16);
         std::memcpy(buffer.data(), converted.bits(), width * height * sizeof(u16));
     } else {
-        return CameraUtil::Rgb2Yuv(transformed, width, height);
+        Rgb2Yuv(transformed, width, height, buffer.data());
     }
-    return buffer;
 }
 
 } // namespace CameraUtil
@@ -11,11 +11,12 @@ class QImage;
 
 namespace CameraUtil {
 
-/// Converts QImage to a yuv formatted std::vector
-std::vector<u16> Rgb2Yuv(const QImage& source, int width, int height);
+/// Converts QImage to yuv format, writing width * height pixels to dest
+void Rgb2Yuv(const QImage& source, int width, int height, u16* dest);
 
-/// Processes the QImage (resizing, flipping ...) and converts it to a std::vector
-std::vector<u16> ProcessImage(const QImage& source, int width, int height, bool output_rgb,
-                              bool flip_horizontal, bool flip_vertical);
+/// Processes the QImage (resizing, flipping ...) and converts it into buffer, which is resized to
+/// width * height pixels so that it can be reused between frames
+void ProcessImage(const QImage& source, int width, int height, bool output_rgb,
+                  bool flip_horizontal, bool flip_vertical, std::vector<u16>& buffer);
 
 } // namespace CameraUtil
@@ -36,8 +36,14 @@ void QtCameraInterface::SetEffect(Service::CAM::Effect effect) {
 }
 
 std::vector<u16> QtCameraInterface::ReceiveFrame() {
-    return CameraUtil::ProcessImage(QtReceiveFrame(), width, height, output_rgb, flip_horizontal,
-                                    flip_vertical);
+    std::vector<u16> buffer;
+    ReceiveFrameInto(buffer);
+    return buffer;
+}
+
+void QtCameraInterface::ReceiveFrameInto(std::vector<u16>& buffer) {
+    CameraUtil::ProcessImage(QtReceiveFrame(), width, height, output_rgb, flip_horizontal,
+                             flip_vertical, buffer);
 }
 
 std::unique_ptr<CameraInterface> QtCameraFactory::CreatePreview(const std::string& config,
@@ -18,6 +18,7 @@ public:
     void SetEffect(Service::CAM::Effect) override;
     void SetFormat(Service::CAM::OutputFormat) override;
     std::vector<u16> ReceiveFrame() override;
+    void ReceiveFrameInto(std::vector<u16>& buffer) override;
     virtual QImage QtReceiveFrame() = 0;
 
 private:
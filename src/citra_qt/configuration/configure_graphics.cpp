@@ -16,6 +16,7 @@ ConfigureGraphics::ConfigureGraphics(QWidget* parent)
 
     ui->toggle_vsync_new->setDisabled(Core::System::GetInstance().IsPoweredOn());
     ui->sharper_distant_objects->setDisabled(Core::System::GetInstance().IsPoweredOn());
+    ui->toggle_async_shader_compilation->setDisabled(Core::System::GetInstance().IsPoweredOn());
 
     ui->hw_renderer_group->setVisible(ui->toggle_hw_renderer->isChecked());
     connect(ui->toggle_hw_renderer, &QCheckBox::toggled, ui->hw_renderer_group,
@@ -37,8 +38,11 @@ void ConfigureGraphics::SetConfiguration() {
     ui->toggle_accurate_mul->setChecked(Settings::values.shaders_accurate_mul);
     ui->toggle_shader_jit->setChecked(Settings::values.use_shader_jit);
     ui->toggle_disk_cache->setChecked(Settings::values.enable_disk_shader_cache);
+    ui->toggle_async_shader_compilation->setChecked(Settings::values.use_async_shader_compilation);
     ui->sharper_distant_objects->setChecked(Settings::values.sharper_distant_objects);
     ui->ignore_format_reinterpretation->setChecked(Settings::values.ignore_format_reinterpretation);
+    ui->texture_memory_budget->setValue(Settings::values.texture_memory_budget);
+    ui->hash_texture_uploads->setChecked(Settings::values.hash_texture_uploads);
     ui->toggle_custom_screen_refresh_rate->setChecked(Settings::values.custom_screen_refresh_rate);
     ui->custom_screen_refresh_rate->setValue(Settings::values.screen_refresh_rate);
     ui->min_vertices_per_thread->setValue(Settings::values.min_vertices_per_thread);
@@ -51,9 +55,13 @@ void ConfigureGraphics::ApplyConfiguration() {
     Settings::values.shaders_accurate_mul = ui->toggle_accurate_mul->isChecked();
     Settings::values.use_shader_jit = ui->toggle_shader_jit->isChecked();
     Settings::values.enable_disk_shader_cache = ui->toggle_disk_cache->isChecked();
+    Settings::values.use_async_shader_compilation =
+        ui->toggle_async_shader_compilation->isChecked();
     Settings::values.sharper_distant_objects = ui->sharper_distant_objects->isChecked();
     Settings::values.ignore_format_reinterpretation =
         ui->ignore_format_reinterpretation->isChecked();
+    Settings::values.texture_memory_budget = ui->texture_memory_budget->value();
+    Settings::values.hash_texture_uploads = ui->hash_texture_uploads->isChecked();
     Settings::values.custom_screen_refresh_rate =
         ui->toggle_custom_screen_refresh_rate->isChecked();
     Settings::values.screen_refresh_rate = ui->custom_screen_refresh_rate->value();
@@ -14,6 +14,8 @@ void Config::ReadCoreValues() {
         ReadSetting(QStringLiteral("custom_cpu_ticks"), 77).toULongLong();
     Settings::values.cpu_clock_percentage =
         ReadSetting(QStringLiteral("cpu_clock_percentage"), 100).toInt();
+    Settings::values.skip_idle_loops =
+        ReadSetting(QStringLiteral("skip_idle_loops"), false).toBool();
     qt_config->endGroup();
 }
 
@@ -26,5 +28,6 @@ void Config::SaveCoreValues() {
                  static_cast<qulonglong>(Settings::values.custom_cpu_ticks), 77);
     WriteSetting(QStringLiteral("cpu_clock_percentage"), Settings::values.cpu_clock_percentage,
                  100);
+    WriteSetting(QStringLiteral("skip_idle_loops"), Settings::values.skip_idle_loops, false);
     qt_config->endGroup();
 }
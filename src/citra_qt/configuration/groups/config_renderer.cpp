@@ -9,9 +9,13 @@ void Config::ReadRendererValues() {
     qt_config->beginGroup(QStringLiteral("Renderer"));
     Settings::values.use_hw_renderer =
         ReadSetting(QStringLiteral("use_hw_renderer"), true).toBool();
+    Settings::values.use_gpu_thread =
+        ReadSetting(QStringLiteral("use_gpu_thread"), false).toBool();
     Settings::values.use_hw_shader = ReadSetting(QStringLiteral("use_hw_shader"), true).toBool();
     Settings::values.enable_disk_shader_cache =
         ReadSetting(QStringLiteral("enable_disk_shader_cache"), false).toBool();
+    Settings::values.use_async_shader_compilation =
+        ReadSetting(QStringLiteral("use_async_shader_compilation"), false).toBool();
     Settings::values.shaders_accurate_mul =
         ReadSetting(QStringLiteral("shaders_accurate_mul"), false).toBool();
     Settings::values.use_shader_jit = ReadSetting(QStringLiteral("use_shader_jit"), true).toBool();
@@ -26,6 +30,10 @@ void Config::ReadRendererValues() {
     Settings::values.bg_blue = ReadSetting(QStringLiteral("bg_blue"), 0.0).toFloat();
     Settings::values.min_vertices_per_thread =
         ReadSetting(QStringLiteral("min_vertices_per_thread"), 10).toInt();
+    Settings::values.texture_memory_budget =
+        ReadSetting(QStringLiteral("texture_memory_budget"), 0).toUInt();
+    Settings::values.hash_texture_uploads =
+        ReadSetting(QStringLiteral("hash_texture_uploads"), false).toBool();
     Settings::values.use_vsync_new = ReadSetting(QStringLiteral("use_vsync_new"), true).toBool();
     qt_config->endGroup();
 }
@@ -33,9 +41,12 @@ void Config::ReadRendererValues() {
 void Config::SaveRendererValues() {
     qt_config->beginGroup(QStringLiteral("Renderer"));
     WriteSetting(QStringLiteral("use_hw_renderer"), Settings::values.use_hw_renderer, true);
+    WriteSetting(QStringLiteral("use_gpu_thread"), Settings::values.use_gpu_thread, false);
     WriteSetting(QStringLiteral("use_hw_shader"), Settings::values.use_hw_shader, true);
     WriteSetting(QStringLiteral("enable_disk_shader_cache"),
                  Settings::values.enable_disk_shader_cache, false);
+    WriteSetting(QStringLiteral("use_async_shader_compilation"),
+                 Settings::values.use_async_shader_compilation, false);
     WriteSetting(QStringLiteral("shaders_accurate_mul"), Settings::values.shaders_accurate_mul,
                  false);
     WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit, true);
@@ -44,6 +55,10 @@ void Config::SaveRendererValues() {
     WriteSetting(QStringLiteral("frame_limit"), Settings::values.frame_limit, 100);
     WriteSetting(QStringLiteral("min_vertices_per_thread"),
                  Settings::values.min_vertices_per_thread, 10);
+    WriteSetting(QStringLiteral("texture_memory_budget"), Settings::values.texture_memory_budget,
+                 0);
+    WriteSetting(QStringLiteral("hash_texture_uploads"), Settings::values.hash_texture_uploads,
+                 false);
     WriteSetting(QStringLiteral("use_vsync_new"), Settings::values.use_vsync_new, true);
 
     // Cast to double because Qt's written float values are not human-readable
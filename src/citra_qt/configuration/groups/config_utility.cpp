@@ -12,6 +12,8 @@ void Config::ReadUtilityValues() {
         ReadSetting(QStringLiteral("custom_textures"), false).toBool();
     Settings::values.preload_textures =
         ReadSetting(QStringLiteral("preload_textures"), false).toBool();
+    Settings::values.video_dumping_queue_depth =
+        ReadSetting(QStringLiteral("video_dumping_queue_depth"), 8).toUInt();
     qt_config->endGroup();
 }
 
@@ -20,5 +22,7 @@ void Config::SaveUtilityValues() {
     WriteSetting(QStringLiteral("dump_textures"), Settings::values.dump_textures, false);
     WriteSetting(QStringLiteral("custom_textures"), Settings::values.custom_textures, false);
     WriteSetting(QStringLiteral("preload_textures"), Settings::values.preload_textures, false);
+    WriteSetting(QStringLiteral("video_dumping_queue_depth"),
+                 Settings::values.video_dumping_queue_depth, 8);
     qt_config->endGroup();
 }
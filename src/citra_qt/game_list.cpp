@@ -25,6 +25,7 @@
 #include <fmt/format.h>
 #include "citra_qt/debugger/console.h"
 #include "citra_qt/game_list.h"
+#include "citra_qt/game_list_index.h"
 #include "citra_qt/game_list_p.h"
 #include "citra_qt/game_list_worker.h"
 #include "citra_qt/main.h"
@@ -284,6 +285,10 @@ GameList::GameList(GMainWindow* parent) : QWidget(parent) {
     item_model = new QStandardItemModel(tree_view);
     tree_view->setModel(item_model);
 
+    index = std::make_shared<GameListIndex>(
+        FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list_index.bin");
+    index->Load();
+
     tree_view->setAlternatingRowColors(true);
     tree_view->setSelectionMode(QHeaderView::SingleSelection);
     tree_view->setSelectionBehavior(QHeaderView::SelectRows);
@@ -634,7 +639,7 @@ void GameList::PopulateAsync(QVector<UISettings::GameDir>& game_dirs) {
 
     emit ShouldCancelWorker();
 
-    GameListWorker* worker = new GameListWorker(game_dirs);
+    GameListWorker* worker = new GameListWorker(game_dirs, index);
 
     connect(worker, &GameListWorker::EntryReady, this, &GameList::AddEntry, Qt::QueuedConnection);
     connect(worker, &GameListWorker::DirEntryReady, this, &GameList::AddDirEntry,
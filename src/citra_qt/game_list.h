@@ -12,6 +12,7 @@
 #include "common/common_types.h"
 #include "uisettings.h"
 
+class GameListIndex;
 class GameListWorker;
 class GameListDir;
 class GameListSearchField;
@@ -108,6 +109,7 @@ private:
     QTreeView* tree_view = nullptr;
     QStandardItemModel* item_model = nullptr;
     GameListWorker* current_worker = nullptr;
+    std::shared_ptr<GameListIndex> index;
     std::unique_ptr<QFileSystemWatcher> watcher;
 
     friend class GameListSearchField;
@@ -0,0 +1,127 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include "citra_qt/game_list_index.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+
+namespace {
+constexpr quint32 IndexMagic = 0x58444C47; // "GLDX"
+constexpr quint32 IndexVersion = 1;
+} // Anonymous namespace
+
+GameListIndex::GameListIndex(std::string file_path) : file_path(std::move(file_path)) {}
+
+void GameListIndex::Load() {
+    QFile file(QString::fromStdString(file_path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_9);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != IndexMagic || version != IndexVersion) {
+        LOG_WARNING(Frontend, "Discarding outdated or invalid game list index");
+        return;
+    }
+
+    std::unordered_map<std::string, Entry> loaded_entries;
+    loaded_entries.reserve(static_cast<std::size_t>(count));
+    for (quint64 i = 0; i < count; ++i) {
+        QString path;
+        Entry entry;
+        quint64 size = 0;
+        qint64 mtime = 0;
+        bool executable = false;
+        quint64 program_id = 0;
+        quint64 extdata_id = 0;
+        QByteArray smdh;
+        qint64 update_mtime = 0;
+        stream >> path >> size >> mtime >> executable >> program_id >> extdata_id >>
+            entry.metadata.file_type >> smdh >> update_mtime;
+        if (stream.status() != QDataStream::Ok) {
+            LOG_WARNING(Frontend, "Game list index is truncated, discarding it");
+            return;
+        }
+
+        entry.size = size;
+        entry.mtime = mtime;
+        entry.metadata.executable = executable;
+        entry.metadata.program_id = program_id;
+        entry.metadata.extdata_id = extdata_id;
+        entry.metadata.smdh.assign(smdh.begin(), smdh.end());
+        entry.metadata.update_mtime = update_mtime;
+        loaded_entries.emplace(path.toStdString(), std::move(entry));
+    }
+
+    std::lock_guard lock(mutex);
+    entries = std::move(loaded_entries);
+}
+
+void GameListIndex::Save() const {
+    std::lock_guard lock(mutex);
+    SaveLocked();
+}
+
+void GameListIndex::SaveLocked() const {
+    FileUtil::CreateFullPath(file_path);
+    QSaveFile file(QString::fromStdString(file_path));
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_ERROR(Frontend, "Failed to open game list index {} for writing", file_path);
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_9);
+
+    stream << IndexMagic << IndexVersion << static_cast<quint64>(entries.size());
+    for (const auto& [path, entry] : entries) {
+        const GameListMetadata& metadata = entry.metadata;
+        stream << QString::fromStdString(path) << static_cast<quint64>(entry.size)
+               << static_cast<qint64>(entry.mtime) << metadata.executable
+               << static_cast<quint64>(metadata.program_id)
+               << static_cast<quint64>(metadata.extdata_id) << metadata.file_type
+               << QByteArray(reinterpret_cast<const char*>(metadata.smdh.data()),
+                             static_cast<int>(metadata.smdh.size()))
+               << static_cast<qint64>(metadata.update_mtime);
+    }
+
+    if (!file.commit()) {
+        LOG_ERROR(Frontend, "Failed to write game list index {}", file_path);
+    }
+}
+
+std::optional<GameListMetadata> GameListIndex::Find(const std::string& path, u64 size,
+                                                    s64 mtime) const {
+    std::lock_guard lock(mutex);
+    const auto it = entries.find(path);
+    if (it == entries.end() || it->second.size != size || it->second.mtime != mtime) {
+        return std::nullopt;
+    }
+    return it->second.metadata;
+}
+
+u64 GameListIndex::BeginScan() {
+    std::lock_guard lock(mutex);
+    return ++latest_scan;
+}
+
+void GameListIndex::Commit(u64 scan, std::unordered_map<std::string, Entry> new_entries) {
+    std::lock_guard lock(mutex);
+    if (scan != latest_scan) {
+        return;
+    }
+    entries = std::move(new_entries);
+    SaveLocked();
+}
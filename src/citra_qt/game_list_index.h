@@ -0,0 +1,72 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <QString>
+#include "common/common_types.h"
+
+/// Everything the game list needs to know about a file, as read by its loader.
+struct GameListMetadata {
+    /// False when the file is not a launchable title. Such files are indexed too, so that they are
+    /// not reopened on every scan.
+    bool executable = false;
+    u64 program_id = 0;
+    u64 extdata_id = 0;
+    QString file_type;
+    std::vector<u8> smdh;
+    /// Modification time of the update title whose icon was used, or 0 if there was none.
+    s64 update_mtime = 0;
+};
+
+/**
+ * Persistent index of game list metadata, keyed by file path and validated against the file's
+ * size and modification time. Thread-safe.
+ */
+class GameListIndex {
+public:
+    struct Entry {
+        u64 size = 0;
+        s64 mtime = 0;
+        GameListMetadata metadata;
+    };
+
+    explicit GameListIndex(std::string file_path);
+
+    /// Loads the index from disk, discarding it if it is missing, corrupt or outdated.
+    void Load();
+
+    /// Writes the index to disk.
+    void Save() const;
+
+    /// Returns the metadata of a file if its size and modification time still match.
+    std::optional<GameListMetadata> Find(const std::string& path, u64 size, s64 mtime) const;
+
+    /**
+     * Starts a scan. Only the latest scan may commit, so a cancelled scan that finishes after its
+     * replacement cannot overwrite the newer results.
+     * @returns the identifier to pass to Commit
+     */
+    u64 BeginScan();
+
+    /**
+     * Replaces the whole index with the entries found by a complete scan and saves it, unless a
+     * newer scan has been started since.
+     */
+    void Commit(u64 scan, std::unordered_map<std::string, Entry> new_entries);
+
+private:
+    /// Writes the index to disk, with mutex held so that saves never interleave.
+    void SaveLocked() const;
+
+    const std::string file_path;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    u64 latest_scan = 0;
+};
@@ -2,20 +2,29 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 #include "citra_qt/game_list.h"
+#include "citra_qt/game_list_index.h"
 #include "citra_qt/game_list_p.h"
 #include "citra_qt/game_list_worker.h"
 #include "citra_qt/uisettings.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/thread_pool.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/fs/archive.h"
+#include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 
 namespace {
@@ -23,9 +32,78 @@ bool HasSupportedFileExtension(const std::string& file_name) {
     const QFileInfo file = QFileInfo(QString::fromStdString(file_name));
     return GameList::supported_file_extensions.contains(file.suffix(), Qt::CaseInsensitive);
 }
+
+/// Returns the path of the installed update title for an application, or an empty string.
+std::string GetUpdatePath(u64 program_id) {
+    if (program_id & ~0x00040000FFFFFFFF) {
+        return {};
+    }
+    return Service::AM::GetTitleContentPath(Service::FS::MediaType::SDMC,
+                                            program_id | 0x0000000E00000000);
+}
+
+/// Returns the modification time of the installed update title for an application, or 0.
+s64 GetUpdateMtime(u64 program_id) {
+    const std::string update_path = GetUpdatePath(program_id);
+    if (update_path.empty()) {
+        return 0;
+    }
+    const QFileInfo info(QString::fromStdString(update_path));
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+/**
+ * Opens a file with its loader and reads everything the game list shows about it.
+ * Returns std::nullopt if the file could not be probed and should not be indexed.
+ */
+std::optional<GameListMetadata> ProbeFile(const std::string& physical_name) {
+    // Loading an encrypted NCCH sets the KeyY of the global NCCH key slots and reads the
+    // resulting normal keys back, so two titles probed at once could decrypt with each other's
+    // keys. Only one file is probed at a time; the pool still overlaps the index lookups and the
+    // update title checks.
+    static std::mutex loader_mutex;
+    std::lock_guard lock(loader_mutex);
+
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
+    if (!loader) {
+        return std::nullopt;
+    }
+
+    GameListMetadata metadata;
+    if (loader->IsExecutable(metadata.executable) != Loader::ResultStatus::Success) {
+        return std::nullopt;
+    }
+    if (!metadata.executable) {
+        return metadata;
+    }
+
+    loader->ReadProgramId(metadata.program_id);
+    loader->ReadExtdataId(metadata.extdata_id);
+    metadata.file_type = QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()));
+
+    // Look for an update icon if available
+    const std::string update_path = GetUpdatePath(metadata.program_id);
+    if (!update_path.empty() && FileUtil::Exists(update_path)) {
+        metadata.update_mtime = GetUpdateMtime(metadata.program_id);
+        std::unique_ptr<Loader::AppLoader> update_loader = Loader::GetLoader(update_path);
+        if (update_loader) {
+            update_loader->ReadIcon(metadata.smdh);
+        }
+    }
+
+    if (!Loader::IsValidSMDH(metadata.smdh)) {
+        // Read the original smdh if there is no valid update smdh
+        metadata.smdh.clear();
+        loader->ReadIcon(metadata.smdh);
+    }
+
+    return metadata;
+}
 } // Anonymous namespace
 
-GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs) : game_dirs(game_dirs) {}
+GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
+                               std::shared_ptr<GameListIndex> index)
+    : game_dirs(game_dirs), index(std::move(index)), scan(this->index->BeginScan()) {}
 
 GameListWorker::~GameListWorker() = default;
 
@@ -42,57 +120,9 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader)
-                return true;
-
-            bool executable = false;
-            loader->IsExecutable(executable);
-            if (!executable) {
-                return true;
-            }
-
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
-
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
-
-            if (!Loader::IsValidSMDH(smdh) && UISettings::values.game_list_hide_no_icon) {
-                // Skip this invalid entry
-                return true;
-            }
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
-
+            const QFileInfo info(QString::fromStdString(physical_name));
+            pending_entries.push_back({physical_name, static_cast<u64>(info.size()),
+                                       info.lastModified().toMSecsSinceEpoch(), parent_dir});
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
             AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir);
@@ -104,6 +134,66 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
     FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
 }
 
+void GameListWorker::ProcessPendingEntries() {
+    HW::AES::InitKeys();
+
+    std::vector<std::optional<GameListMetadata>> results(pending_entries.size());
+    std::vector<std::future<void>> futures(pending_entries.size());
+    Common::ThreadPool probe_pool(std::max(1U, std::thread::hardware_concurrency()));
+
+    for (std::size_t i = 0; i < pending_entries.size(); ++i) {
+        futures[i] = probe_pool.Push([this, &entry = pending_entries[i], &result = results[i]] {
+            if (stop_processing) {
+                return;
+            }
+            std::optional<GameListMetadata> cached =
+                index->Find(entry.physical_name, entry.size, entry.mtime);
+            if (cached && (!cached->executable ||
+                           GetUpdateMtime(cached->program_id) == cached->update_mtime)) {
+                result = std::move(cached);
+                return;
+            }
+            result = ProbeFile(entry.physical_name);
+        });
+    }
+
+    std::unordered_map<std::string, GameListIndex::Entry> scanned_entries;
+    for (std::size_t i = 0; i < pending_entries.size(); ++i) {
+        futures[i].wait();
+        if (stop_processing || !results[i]) {
+            continue;
+        }
+
+        const PendingEntry& entry = pending_entries[i];
+        const GameListMetadata& metadata = *results[i];
+        scanned_entries.emplace(entry.physical_name,
+                                GameListIndex::Entry{entry.size, entry.mtime, metadata});
+
+        if (!metadata.executable) {
+            continue;
+        }
+
+        if (!Loader::IsValidSMDH(metadata.smdh) && UISettings::values.game_list_hide_no_icon) {
+            // Skip this invalid entry
+            continue;
+        }
+
+        emit EntryReady(
+            {
+                new GameListItemPath(QString::fromStdString(entry.physical_name), metadata.smdh,
+                                     metadata.program_id, metadata.extdata_id),
+                new GameListItemRegion(metadata.smdh),
+                new GameListItem(metadata.file_type),
+                new GameListItemSize(entry.size),
+            },
+            entry.parent_dir);
+    }
+
+    if (!stop_processing) {
+        index->Commit(scan, std::move(scanned_entries));
+    }
+}
+
 void GameListWorker::run() {
     stop_processing = false;
     for (UISettings::GameDir& game_dir : game_dirs) {
@@ -142,6 +232,7 @@ void GameListWorker::run() {
                                     game_list_dir);
         }
     };
+    ProcessPendingEntries();
     emit Finished(watch_list);
 }
 
@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -16,6 +17,7 @@
 #include <QVector>
 #include "common/common_types.h"
 
+class GameListIndex;
 class QStandardItem;
 
 /**
@@ -26,7 +28,7 @@ class GameListWorker : public QObject, public QRunnable {
     Q_OBJECT
 
 public:
-    GameListWorker(QVector<UISettings::GameDir>& game_dirs);
+    GameListWorker(QVector<UISettings::GameDir>& game_dirs, std::shared_ptr<GameListIndex> index);
     ~GameListWorker() override;
 
     /// Starts the processing of directory tree information.
@@ -51,10 +53,28 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// A supported file found while traversing the game directories.
+    struct PendingEntry {
+        std::string physical_name;
+        u64 size;
+        s64 mtime;
+        GameListDir* parent_dir;
+    };
+
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir);
 
+    /**
+     * Resolves the metadata of every pending entry, reusing the index for unchanged files and
+     * probing the others one at a time, then emits them in traversal order.
+     */
+    void ProcessPendingEntries();
+
     QStringList watch_list;
     QVector<UISettings::GameDir>& game_dirs;
+    std::shared_ptr<GameListIndex> index;
+    /// Identifies this worker's scan to the index, which only accepts the latest scan's results
+    const u64 scan;
+    std::vector<PendingEntry> pending_entries;
     std::atomic_bool stop_processing;
 };
@@ -253,7 +253,12 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         "Time taken to emulate a 3DS frame, not counting framelimiting or v-sync.");
 
-    for (QLabel* const label : {emu_speed_label, emu_frametime_label}) {
+    video_dumping_label = new QLabel();
+    video_dumping_label->setToolTip(
+        "Frames waiting for the video encoder, time emulation was blocked by the encoder and "
+        "encoder throughput.");
+
+    for (QLabel* const label : {video_dumping_label, emu_speed_label, emu_frametime_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -1335,6 +1340,7 @@ void GMainWindow::ShutdownGame() {
     status_bar_update_timer.stop();
     emu_speed_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    video_dumping_label->setVisible(false);
 
     if (progress_dialog != nullptr) {
         progress_dialog.reset();
@@ -2105,11 +2111,31 @@ void GMainWindow::UpdateStatusBar() {
                                      .arg(results.game_fps, 0, 'f', 0)
                                      .arg(results.emulation_speed * 100.0, 0, 'f', 0));
     }
-    emu_frametime_label->setText(
-        QStringLiteral("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
+    QString frametime_text =
+        QStringLiteral("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2);
+    if (results.idle_skip_ratio > 0.0) {
+        frametime_text += QStringLiteral(" (idle skip %1%)")
+                              .arg(results.idle_skip_ratio * 100.0, 0, 'f', 0);
+    }
+    if (Settings::values.hash_texture_uploads) {
+        frametime_text += QStringLiteral(" (texture hash hits %1%)")
+                              .arg(results.texture_hash_hit_ratio * 100.0, 0, 'f', 0);
+    }
+    emu_frametime_label->setText(frametime_text);
 
     emu_speed_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+
+    VideoDumper::Backend& video_dumper = Core::System::GetInstance().VideoDumper();
+    if (video_dumper.IsDumping()) {
+        const VideoDumper::VideoQueueStats stats = video_dumper.GetVideoQueueStats();
+        video_dumping_label->setText(QStringLiteral("Dump: %1/%2 queued, %3 s stalled, %4 FPS")
+                                         .arg(stats.depth)
+                                         .arg(stats.capacity)
+                                         .arg(stats.stall_seconds, 0, 'f', 1)
+                                         .arg(stats.encoder_fps, 0, 'f', 0));
+    }
+    video_dumping_label->setVisible(video_dumper.IsDumping());
 }
 
 void GMainWindow::OnCoreError(Core::System::ResultStatus result, std::string details) {
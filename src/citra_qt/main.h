@@ -172,6 +172,7 @@ private:
     QLabel* message_label = nullptr;
     QLabel* emu_speed_label = nullptr;
     QLabel* emu_frametime_label = nullptr;
+    QLabel* video_dumping_label = nullptr;
     QTimer status_bar_update_timer;
 
     MultiplayerState* multiplayer_state = nullptr;
@@ -0,0 +1,89 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A value that any number of threads can read without blocking while others write it. Readers
+ * copy the value and retry when a write happened in the meantime, so T should be small.
+ * @tparam T Value type, must be trivially copyable and default constructible
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>);
+    static_assert(std::atomic<u64>::is_always_lock_free);
+
+public:
+    SeqLock() {
+        Publish();
+    }
+
+    /// Returns a consistent copy of the value
+    T Read() const {
+        std::array<u64, NumWords> buffer;
+        u32 begin;
+        u32 end;
+        do {
+            begin = sequence.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < NumWords; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            end = sequence.load(std::memory_order_relaxed);
+        } while ((begin & 1) != 0 || begin != end);
+
+        T value;
+        std::memcpy(&value, buffer.data(), sizeof(T));
+        return value;
+    }
+
+    /// Changes the value in place. Writers are serialized with each other, but never block readers.
+    template <typename Function>
+    void Modify(Function&& function) {
+        std::lock_guard lock{write_mutex};
+        function(value);
+        Publish();
+    }
+
+    void Write(const T& new_value) {
+        Modify([&new_value](T& value) { value = new_value; });
+    }
+
+private:
+    static constexpr std::size_t NumWords = (sizeof(T) + sizeof(u64) - 1) / sizeof(u64);
+
+    /// Copies the writers' value to the words readers copy from
+    void Publish() {
+        std::array<u64, NumWords> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+
+        const u32 current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < NumWords; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    /// Odd while a write is in progress
+    std::atomic<u32> sequence{0};
+    std::array<std::atomic<u64>, NumWords> words{};
+
+    std::mutex write_mutex;
+    /// The value as seen by writers
+    T value{};
+};
+
+} // namespace Common
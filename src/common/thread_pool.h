@@ -14,12 +14,11 @@
 namespace Common {
 
 class ThreadPool : NonCopyable {
-private:
+public:
     explicit ThreadPool(std::size_t num_threads) : num_threads(num_threads), workers(num_threads) {
         ASSERT(num_threads);
     }
 
-public:
     static ThreadPool& GetPool() {
         static ThreadPool thread_pool(std::thread::hardware_concurrency());
         return thread_pool;
@@ -102,10 +101,11 @@ private:
 
         bool exit_loop = false;
         SPSCQueue<std::function<void()>> queue;
-        std::thread thread{[this] { Loop(); }};
         std::atomic<bool> spinlock_enabled{};
         std::mutex mutex;
         std::condition_variable cv;
+        // Declared last, so that everything Loop uses is constructed before the thread starts
+        std::thread thread{[this] { Loop(); }};
     };
 
     const std::size_t num_threads;
@@ -10,6 +10,10 @@
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
 
+namespace Memory {
+struct PageTable;
+} // namespace Memory
+
 /// Generic ARM11 CPU interface
 class ARM_Interface : NonCopyable {
 public:
@@ -72,6 +76,9 @@ public:
     /// Notify CPU emulation that page tables have changed
     virtual void PageTableChanged() = 0;
 
+    /// Notify CPU emulation that a page table is about to be destroyed
+    virtual void PageTableRemoved(Memory::PageTable* page_table) = 0;
+
     /**
      * Set the Program Counter to an address
      * @param addr Address to set PC to
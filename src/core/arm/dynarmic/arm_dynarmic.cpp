@@ -6,6 +6,7 @@
 #include <dynarmic/A32/a32.h>
 #include <dynarmic/A32/context.h>
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
@@ -14,6 +15,7 @@
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/kernel/svc.h"
 #include "core/memory.h"
+#include "core/settings.h"
 
 class DynarmicThreadContext final : public ARM_Interface::ThreadContext {
 public:
@@ -86,35 +88,50 @@ public:
 
     ~DynarmicUserCallbacks() = default;
 
+    u32 MemoryReadCode(VAddr vaddr) override {
+        // Only the translator fetches code, so this counts translated instructions
+        ++parent.current_entry->cached_instructions;
+        ++parent.translated_instructions;
+        return memory.Read32(vaddr);
+    }
+
     u8 MemoryRead8(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, sizeof(u8), GDBStub::BreakpointType::Read);
         return memory.Read8(vaddr);
     }
 
     u16 MemoryRead16(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, sizeof(u16), GDBStub::BreakpointType::Read);
         return memory.Read16(vaddr);
     }
 
     u32 MemoryRead32(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, sizeof(u32), GDBStub::BreakpointType::Read);
         return memory.Read32(vaddr);
     }
 
     u64 MemoryRead64(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, sizeof(u64), GDBStub::BreakpointType::Read);
         return memory.Read64(vaddr);
     }
 
     void MemoryWrite8(VAddr vaddr, u8 value) override {
+        CheckWatchpoint(vaddr, sizeof(u8), GDBStub::BreakpointType::Write);
         memory.Write8(vaddr, value);
     }
 
     void MemoryWrite16(VAddr vaddr, u16 value) override {
+        CheckWatchpoint(vaddr, sizeof(u16), GDBStub::BreakpointType::Write);
         memory.Write16(vaddr, value);
     }
 
     void MemoryWrite32(VAddr vaddr, u32 value) override {
+        CheckWatchpoint(vaddr, sizeof(u32), GDBStub::BreakpointType::Write);
         memory.Write32(vaddr, value);
     }
 
     void MemoryWrite64(VAddr vaddr, u64 value) override {
+        CheckWatchpoint(vaddr, sizeof(u64), GDBStub::BreakpointType::Write);
         memory.Write64(vaddr, value);
     }
 
@@ -170,7 +187,7 @@ public:
             return;
         }
         ASSERT_MSG(false, "ExceptionRaised(exception = {}, pc = {:08X}, code = {:08X})",
-                   static_cast<std::size_t>(exception), pc, MemoryReadCode(pc));
+                   static_cast<std::size_t>(exception), pc, memory.Read32(pc));
     }
 
     void AddTicks(u64 ticks) override {
@@ -182,6 +199,18 @@ public:
         return static_cast<u64>(ticks <= 0 ? 0 : ticks);
     }
 
+    /**
+     * Stops at the end of the current block if the access hits a debugger read/write breakpoint.
+     * Only accesses to pages without a page table pointer get here, and MarkRegionWatched takes the
+     * pointers of the pages with breakpoints on them out of the page table.
+     */
+    void CheckWatchpoint(VAddr vaddr, u32 size, GDBStub::BreakpointType type) {
+        if (GDBStub::CheckBreakpoint(vaddr, type, size)) {
+            GDBStub::Break(true);
+            parent.jit->HaltExecution();
+        }
+    }
+
     ARM_Dynarmic& parent;
     Core::Timing& timing;
     Kernel::SVCContext svc_context;
@@ -190,17 +219,40 @@ public:
 
 ARM_Dynarmic::ARM_Dynarmic(Core::System* system, Memory::MemorySystem& memory,
                            PrivilegeMode initial_mode)
-    : system(*system), memory(memory), cb(std::make_unique<DynarmicUserCallbacks>(*this)) {
+    : system(*system), memory(memory), cb(std::make_unique<DynarmicUserCallbacks>(*this)),
+      idle_loop_detector(memory) {
     interpreter_state = std::make_shared<ARMul_State>(system, memory, initial_mode);
     PageTableChanged();
 }
 
-ARM_Dynarmic::~ARM_Dynarmic() = default;
+ARM_Dynarmic::~ARM_Dynarmic() {
+    const CacheStats stats = GetCacheStats();
+    LOG_INFO(Core_ARM11,
+             "JIT cache: {} instructions translated by {} JITs, {} evicted, {} still cached",
+             stats.translated_instructions, stats.jits_created, stats.jits_evicted,
+             stats.cached_instructions);
+}
 
 void ARM_Dynarmic::Run() {
     ASSERT(memory.GetCurrentPageTable() == current_page_table);
 
     jit->Run();
+
+    if (GDBStub::IsMemoryBreak()) {
+        // Dynarmic can't stop inside a block, so this reports the state after the rest of the
+        // block that made the access
+        Kernel::Thread* thread = system.Kernel().GetThreadManager().GetCurrentThread();
+        SaveContext(thread->context);
+        GDBStub::Break();
+        GDBStub::SendTrap(thread, 5);
+        return;
+    }
+
+    // Only sample when the slice ran out, not when execution was halted for a reschedule.
+    if (Settings::values.skip_idle_loops && cb->timing.GetDowncount() <= 0 &&
+        idle_loop_detector.Sample(jit->Regs(), jit->Cpsr())) {
+        cb->timing.SkipToNextEvent();
+    }
 }
 
 void ARM_Dynarmic::Step() {
@@ -283,6 +335,7 @@ void ARM_Dynarmic::LoadContext(const std::unique_ptr<ThreadContext>& arg) {
 
     jit->LoadContext(ctx->ctx);
     interpreter_state->VFP[VFP_FPEXC] = ctx->fpexc;
+    idle_loop_detector.Reset();
 }
 
 void ARM_Dynarmic::PrepareReschedule() {
@@ -293,30 +346,98 @@ void ARM_Dynarmic::PrepareReschedule() {
 
 void ARM_Dynarmic::ClearInstructionCache() {
     // TODO: Clear interpreter cache when appropriate.
-    for (const std::pair<Memory::PageTable* const, std::unique_ptr<Dynarmic::A32::Jit>>& jit :
-         jits) {
-        jit.second->ClearCache();
+    // Other page tables are only cleared once they are switched to, so that a breakpoint does not
+    // make every process recompile up front.
+    for (auto& [page_table, entry] : jits) {
+        entry.needs_clear = true;
     }
+    jit->ClearCache();
+    current_entry->cached_instructions = 0;
+    current_entry->needs_clear = false;
 
-    interpreter_state->instruction_cache.clear();
+    interpreter_state->instruction_cache.Clear();
 }
 
 void ARM_Dynarmic::InvalidateCacheRange(u32 start_address, std::size_t length) {
     jit->InvalidateCacheRange(start_address, length);
+    interpreter_state->instruction_cache.InvalidateRange(start_address, length);
 }
 
 void ARM_Dynarmic::PageTableChanged() {
     current_page_table = memory.GetCurrentPageTable();
+    idle_loop_detector.Reset();
+    // The interpreter's translations are keyed by virtual address only
+    interpreter_state->instruction_cache.Clear();
 
     auto iter = jits.find(current_page_table);
-    if (iter != jits.end()) {
-        jit = iter->second.get();
+    if (iter == jits.end()) {
+        iter = jits.emplace(current_page_table, JitEntry{MakeJit()}).first;
+        ++jits_created;
+    } else if (iter->second.needs_clear) {
+        iter->second.jit->ClearCache();
+        iter->second.cached_instructions = 0;
+        iter->second.needs_clear = false;
+    }
+
+    current_entry = &iter->second;
+    current_entry->last_used = ++use_counter;
+    jit = current_entry->jit.get();
+
+    EvictJits();
+}
+
+void ARM_Dynarmic::PageTableRemoved(Memory::PageTable* page_table) {
+    auto iter = jits.find(page_table);
+    if (iter == jits.end()) {
+        return;
+    }
+
+    if (&iter->second == current_entry) {
+        // Keep the JIT usable until the next switch, but nothing it translated is valid anymore.
+        // Another page table may also be allocated at the same address later.
+        jit->ClearCache();
+        current_entry->cached_instructions = 0;
         return;
     }
 
-    std::unique_ptr<Dynarmic::A32::Jit> new_jit = MakeJit();
-    jit = new_jit.get();
-    jits.emplace(current_page_table, std::move(new_jit));
+    jits.erase(iter);
+    ++jits_evicted;
+}
+
+ARM_Dynarmic::CacheStats ARM_Dynarmic::GetCacheStats() const {
+    CacheStats stats;
+    stats.jits = jits.size();
+    for (const auto& [page_table, entry] : jits) {
+        stats.cached_instructions += entry.cached_instructions;
+    }
+    stats.translated_instructions = translated_instructions;
+    stats.jits_created = jits_created;
+    stats.jits_evicted = jits_evicted;
+    return stats;
+}
+
+void ARM_Dynarmic::EvictJits() {
+    u64 inactive_instructions = 0;
+    for (const auto& [page_table, entry] : jits) {
+        if (&entry != current_entry) {
+            inactive_instructions += entry.cached_instructions;
+        }
+    }
+
+    while (inactive_instructions > CodeCacheBudget) {
+        auto oldest = jits.end();
+        for (auto iter = jits.begin(); iter != jits.end(); ++iter) {
+            if (&iter->second != current_entry &&
+                (oldest == jits.end() || iter->second.last_used < oldest->second.last_used)) {
+                oldest = iter;
+            }
+        }
+        inactive_instructions -= oldest->second.cached_instructions;
+        LOG_DEBUG(Core_ARM11, "Evicting JIT with {} cached instructions",
+                  oldest->second.cached_instructions);
+        jits.erase(oldest);
+        ++jits_evicted;
+    }
 }
 
 std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
@@ -9,6 +9,7 @@
 #include <dynarmic/A32/a32.h>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
+#include "core/arm/idle_loop_detector.h"
 #include "core/arm/skyeye_common/armstate.h"
 
 namespace Memory {
@@ -24,6 +25,17 @@ class DynarmicUserCallbacks;
 
 class ARM_Dynarmic final : public ARM_Interface {
 public:
+    struct CacheStats {
+        /// Number of JITs currently alive, one per page table
+        std::size_t jits = 0;
+        /// Guest instructions translated by the live JITs since their caches were last cleared
+        u64 cached_instructions = 0;
+        /// Guest instructions translated over the lifetime of this CPU
+        u64 translated_instructions = 0;
+        u64 jits_created = 0;
+        u64 jits_evicted = 0;
+    };
+
     ARM_Dynarmic(Core::System* system, Memory::MemorySystem& memory, PrivilegeMode initial_mode);
     ~ARM_Dynarmic() override;
 
@@ -52,16 +64,50 @@ public:
     void ClearInstructionCache() override;
     void InvalidateCacheRange(u32 start_address, std::size_t length) override;
     void PageTableChanged() override;
+    void PageTableRemoved(Memory::PageTable* page_table) override;
+
+    CacheStats GetCacheStats() const;
 
 private:
     friend class DynarmicUserCallbacks;
+
+    struct JitEntry {
+        std::unique_ptr<Dynarmic::A32::Jit> jit;
+        /// Value of use_counter when this page table was last switched to
+        u64 last_used = 0;
+        /// Guest instructions translated since the cache was last cleared
+        u64 cached_instructions = 0;
+        /// Set by ClearInstructionCache, the cache is cleared once the page table is used again
+        bool needs_clear = false;
+    };
+
+    /**
+     * Dynarmic reserves a code buffer per JIT, and what it fills grows with the number of guest
+     * instructions translated. Once inactive JITs hold more than this many, the least recently used
+     * ones are destroyed.
+     */
+    static constexpr u64 CodeCacheBudget = 4000000;
+
     Core::System& system;
     Memory::MemorySystem& memory;
     std::unique_ptr<DynarmicUserCallbacks> cb;
     std::unique_ptr<Dynarmic::A32::Jit> MakeJit();
+    void EvictJits();
 
     Dynarmic::A32::Jit* jit = nullptr;
+    JitEntry* current_entry = nullptr;
     Memory::PageTable* current_page_table = nullptr;
-    std::map<Memory::PageTable*, std::unique_ptr<Dynarmic::A32::Jit>> jits;
+    /**
+     * One JIT per page table. Translated code can't be shared between them, even for code pages
+     * that several processes map from the same physical memory: Dynarmic emits the page table
+     * pointer into every fast memory access of a block, and offers no API to look up, copy or
+     * import individual blocks across JIT instances.
+     */
+    std::map<Memory::PageTable*, JitEntry> jits;
+    u64 use_counter = 0;
+    u64 translated_instructions = 0;
+    u64 jits_created = 0;
+    u64 jits_evicted = 0;
     std::shared_ptr<ARMul_State> interpreter_state;
+    IdleLoopDetector idle_loop_detector;
 };
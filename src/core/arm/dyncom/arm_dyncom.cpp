@@ -11,6 +11,7 @@
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/settings.h"
 
 class DynComThreadContext final : public ARM_Interface::ThreadContext {
 public:
@@ -70,7 +71,7 @@ private:
 
 ARM_DynCom::ARM_DynCom(Core::System* system, Memory::MemorySystem& memory,
                        PrivilegeMode initial_mode)
-    : system(system) {
+    : system(system), idle_loop_detector(memory) {
     state = std::make_unique<ARMul_State>(system, memory, initial_mode);
 }
 
@@ -79,6 +80,13 @@ ARM_DynCom::~ARM_DynCom() {}
 void ARM_DynCom::Run() {
     DEBUG_ASSERT(system != nullptr);
     ExecuteInstructions(std::max<s64>(system->CoreTiming().GetDowncount(), 0));
+
+    // Only sample when the slice ran out, not when execution was halted for a reschedule.
+    Core::Timing& timing = system->CoreTiming();
+    if (Settings::values.skip_idle_loops && timing.GetDowncount() <= 0 &&
+        idle_loop_detector.Sample(state->Reg, state->Cpsr)) {
+        timing.SkipToNextEvent();
+    }
 }
 
 void ARM_DynCom::Step() {
@@ -86,16 +94,21 @@ void ARM_DynCom::Step() {
 }
 
 void ARM_DynCom::ClearInstructionCache() {
-    state->instruction_cache.clear();
+    state->instruction_cache.Clear();
     trans_cache_buf_top = 0;
 }
 
-void ARM_DynCom::InvalidateCacheRange(u32, std::size_t) {
-    ClearInstructionCache();
+void ARM_DynCom::InvalidateCacheRange(u32 start_address, std::size_t length) {
+    state->instruction_cache.InvalidateRange(start_address, length);
 }
 
 void ARM_DynCom::PageTableChanged() {
     ClearInstructionCache();
+    idle_loop_detector.Reset();
+}
+
+void ARM_DynCom::PageTableRemoved(Memory::PageTable* page_table) {
+    // The instruction cache is already cleared on every page table change
 }
 
 void ARM_DynCom::SetPC(u32 pc) {
@@ -179,6 +192,7 @@ void ARM_DynCom::LoadContext(const std::unique_ptr<ThreadContext>& arg) {
     state->ExtReg = ctx->fpu_registers;
     state->VFP[VFP_FPSCR] = ctx->fpscr;
     state->VFP[VFP_FPEXC] = ctx->fpexc;
+    idle_loop_detector.Reset();
 }
 
 void ARM_DynCom::PrepareReschedule() {
@@ -7,6 +7,7 @@
 #include <memory>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
+#include "core/arm/idle_loop_detector.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/arm/skyeye_common/armstate.h"
 
@@ -30,6 +31,7 @@ public:
     void ClearInstructionCache() override;
     void InvalidateCacheRange(u32 start_address, std::size_t length) override;
     void PageTableChanged() override;
+    void PageTableRemoved(Memory::PageTable* page_table) override;
 
     void SetPC(u32 pc) override;
     u32 GetPC() const override;
@@ -55,4 +57,5 @@ private:
 
     Core::System* system;
     std::unique_ptr<ARMul_State> state;
+    IdleLoopDetector idle_loop_detector;
 };
@@ -0,0 +1,64 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "core/arm/dyncom/arm_dyncom_block_cache.h"
+
+void BlockCache::Insert(u32 addr, u32 end, std::size_t offset) {
+    blocks[addr] = {offset, end};
+    for (u32 page = addr >> PageBits; page <= (end - 1) >> PageBits; ++page) {
+        pages[page].push_back(addr);
+    }
+    table[(addr >> 1) & TableMask] = {addr, offset};
+}
+
+void BlockCache::InvalidateRange(u32 start, std::size_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    const u64 end = static_cast<u64>(start) + length;
+    bool invalidated = false;
+    for (u64 page = start >> PageBits; page <= (end - 1) >> PageBits; ++page) {
+        const auto page_iter = pages.find(static_cast<u32>(page));
+        if (page_iter == pages.end()) {
+            continue;
+        }
+
+        std::vector<u32>& addrs = page_iter->second;
+        addrs.erase(std::remove_if(addrs.begin(), addrs.end(),
+                                   [&](u32 addr) {
+                                       const auto iter = blocks.find(addr);
+                                       if (iter == blocks.end()) {
+                                           // Already dropped through another page
+                                           return true;
+                                       }
+                                       if (addr >= end || iter->second.end <= start) {
+                                           return false;
+                                       }
+                                       blocks.erase(iter);
+                                       Entry& entry = table[(addr >> 1) & TableMask];
+                                       if (entry.addr == addr) {
+                                           entry = {};
+                                       }
+                                       invalidated = true;
+                                       return true;
+                                   }),
+                    addrs.end());
+        if (addrs.empty()) {
+            pages.erase(page_iter);
+        }
+    }
+
+    if (invalidated) {
+        ++generation;
+    }
+}
+
+void BlockCache::Clear() {
+    table.fill({});
+    blocks.clear();
+    pages.clear();
+    ++generation;
+}
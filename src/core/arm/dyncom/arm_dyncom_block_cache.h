@@ -0,0 +1,74 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Maps guest addresses to the blocks translated into trans_cache_buf. Lookups go through a direct
+ * mapped table first and only fall back to the hash map on a miss. Blocks are also indexed by the
+ * pages they were translated from, so that invalidating a range only drops the blocks it touches.
+ */
+class BlockCache {
+public:
+    static constexpr std::size_t NotFound = ~std::size_t{0};
+
+    /// Returns the offset of the block starting at addr, or NotFound.
+    std::size_t Find(u32 addr) {
+        Entry& entry = table[(addr >> 1) & TableMask];
+        if (entry.addr == addr && entry.offset != NotFound) {
+            return entry.offset;
+        }
+
+        const auto iter = blocks.find(addr);
+        if (iter == blocks.end()) {
+            return NotFound;
+        }
+        entry = {addr, iter->second.offset};
+        return iter->second.offset;
+    }
+
+    /// Adds the block translated from [addr, end) at offset.
+    void Insert(u32 addr, u32 end, std::size_t offset);
+
+    /// Drops every block translated from memory in [start, start + length).
+    void InvalidateRange(u32 start, std::size_t length);
+
+    void Clear();
+
+    /**
+     * Changes whenever blocks are dropped. Branches that remember the block they jump to are only
+     * valid while this stays the same.
+     */
+    u32 Generation() const {
+        return generation;
+    }
+
+private:
+    struct Entry {
+        u32 addr = 0;
+        std::size_t offset = NotFound;
+    };
+
+    struct Block {
+        std::size_t offset;
+        u32 end;
+    };
+
+    static constexpr std::size_t TableSize = 0x4000;
+    static constexpr std::size_t TableMask = TableSize - 1;
+    static constexpr u32 PageBits = 12;
+
+    std::array<Entry, TableSize> table{};
+    std::unordered_map<u32, Block> blocks;
+    /// Start addresses of the blocks overlapping each page
+    std::unordered_map<u32, std::vector<u32>> pages;
+    /// Starts at 1 so that zero initialized links never match
+    u32 generation = 1;
+};
@@ -837,6 +837,17 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
     return inst_size;
 }
 
+/// Room kept free in trans_cache_buf for one block, comfortably more than a page of instructions
+constexpr std::size_t MaxBlockCreamSize = 1024 * 1024;
+
+/// Starts over with an empty translation cache if the next block might not fit.
+static void EnsureTranslationSpace(ARMul_State* cpu) {
+    if (trans_cache_buf_top + MaxBlockCreamSize > TRANS_CACHE_SIZE) {
+        cpu->instruction_cache.Clear();
+        trans_cache_buf_top = 0;
+    }
+}
+
 static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u32 addr) {
     // Decode instruction, get index
     // Allocate memory and init InsCream
@@ -845,6 +856,7 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
     ARM_INST_PTR inst_base = nullptr;
     TransExtData ret = TransExtData::NON_BRANCH;
     int size = 0; // instruction size of basic block
+    EnsureTranslationSpace(cpu);
     bb_start = trans_cache_buf_top;
 
     u32 phys_addr = addr;
@@ -863,25 +875,26 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
         ret = inst_base->br;
     };
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->instruction_cache.Insert(pc_start, phys_addr, bb_start);
 
     return KEEP_GOING;
 }
 
 static int InterpreterTranslateSingle(ARMul_State* cpu, std::size_t& bb_start, u32 addr) {
     ARM_INST_PTR inst_base = nullptr;
+    EnsureTranslationSpace(cpu);
     bb_start = trans_cache_buf_top;
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
-    InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
+    const unsigned int inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
 
     if (inst_base->br == TransExtData::NON_BRANCH) {
         inst_base->br = TransExtData::SINGLE_STEP;
     }
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->instruction_cache.Insert(pc_start, phys_addr + inst_size, bb_start);
 
     return KEEP_GOING;
 }
@@ -1615,6 +1628,8 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     unsigned int num_instrs = 0;
 
     std::size_t ptr;
+    /// Set by direct branches, to skip the block lookup the next time they go the same way
+    block_link* link = nullptr;
 
     LOAD_NZCVT;
 DISPATCH : {
@@ -1629,17 +1644,29 @@ DISPATCH : {
     else
         cpu->Reg[15] &= 0xfffffffc;
 
-    // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
-    } else if (cpu->NumInstrsToExecute != 1) {
-        if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+    // Follow the branch link if it is still valid, otherwise find the cached instruction cream or
+    // translate it...
+    const u32 generation = cpu->instruction_cache.Generation();
+    if (link != nullptr && link->generation == generation) {
+        ptr = link->ptr;
     } else {
-        if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+        ptr = cpu->instruction_cache.Find(cpu->Reg[15]);
+        if (ptr == BlockCache::NotFound) {
+            if (cpu->NumInstrsToExecute != 1) {
+                if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                    goto END;
+            } else {
+                if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                    goto END;
+            }
+        }
+        // Translating may have cleared the cache, and the branch along with it
+        if (link != nullptr && generation == cpu->instruction_cache.Generation()) {
+            link->ptr = ptr;
+            link->generation = generation;
+        }
     }
+    link = nullptr;
 
     // Find breakpoint if one exists within the block
     if (GDBStub::IsConnected()) {
@@ -1757,9 +1784,11 @@ BBL_INST : {
         }
         SET_PC;
         INC_PC(sizeof(bbl_inst));
+        link = &inst_cream->taken;
         goto DISPATCH;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
+    link = &((bbl_inst*)inst_base->component)->not_taken;
     INC_PC(sizeof(bbl_inst));
     goto DISPATCH;
 }
@@ -4311,16 +4340,20 @@ UMULL_INST : {
 B_2_THUMB : {
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
     cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
+    link = &inst_cream->taken;
     INC_PC(sizeof(b_2_thumb));
     goto DISPATCH;
 }
 B_COND_THUMB : {
     b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
-    if (CondPassed(cpu, inst_cream->cond))
+    if (CondPassed(cpu, inst_cream->cond)) {
         cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-    else
+        link = &inst_cream->taken;
+    } else {
         cpu->Reg[15] += 2;
+        link = &inst_cream->not_taken;
+    }
 
     INC_PC(sizeof(b_cond_thumb));
     goto DISPATCH;
@@ -83,11 +83,19 @@ struct eor_inst {
     shtop_fp_t shtop_func;
 };
 
+/// The block a direct branch jumped to last time, valid while the block cache generation matches.
+struct block_link {
+    std::size_t ptr;
+    u32 generation;
+};
+
 struct bbl_inst {
     unsigned int L;
     int signed_immed_24;
     unsigned int next_addr;
     unsigned int jmp_addr;
+    block_link taken;
+    block_link not_taken;
 };
 
 struct bx_inst {
@@ -451,10 +459,13 @@ struct setend_inst {
 
 struct b_2_thumb {
     unsigned int imm;
+    block_link taken;
 };
 struct b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    block_link taken;
+    block_link not_taken;
 };
 
 struct bl_1_thumb {
@@ -0,0 +1,375 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/arm/idle_loop_detector.h"
+#include "core/memory.h"
+
+namespace {
+
+/// Bit used for the condition flags in register masks.
+constexpr u32 FLAGS_BIT = 1U << 16;
+constexpr u32 PC_BIT = 1U << 15;
+
+/// Largest loop body, in instructions, that is considered a polling loop.
+constexpr u32 MAX_LOOP_INSTRUCTIONS = 16;
+
+/// svcGetSystemTick, which returns the tick count in r0 and r1 and has no other effect.
+constexpr u32 SVC_GET_SYSTEM_TICK = 0x28;
+
+constexpr u32 RegBit(u32 index) {
+    return 1U << index;
+}
+
+struct InstructionInfo {
+    enum class Kind { Simple, Branch, Unsupported };
+
+    Kind kind = Kind::Simple;
+    bool conditional = false;
+    u32 reads = 0;
+    u32 writes = 0;
+    VAddr branch_target = 0;
+};
+
+constexpr InstructionInfo Unsupported() {
+    InstructionInfo info;
+    info.kind = InstructionInfo::Kind::Unsupported;
+    return info;
+}
+
+/// Decodes the subset of ARM instructions allowed in a polling loop: B, data processing, loads and
+/// svcGetSystemTick.
+InstructionInfo DecodeArm(u32 inst, VAddr addr) {
+    InstructionInfo info;
+
+    const u32 cond = inst >> 28;
+    if (cond == 0xF) {
+        return Unsupported();
+    }
+    if (cond != 0xE) {
+        info.conditional = true;
+        info.reads |= FLAGS_BIT;
+    }
+
+    const u32 rn = (inst >> 16) & 0xF;
+    const u32 rd = (inst >> 12) & 0xF;
+    const u32 rs = (inst >> 8) & 0xF;
+    const u32 rm = inst & 0xF;
+    const bool pre_indexed = (inst & (1 << 24)) != 0;
+    const bool write_back = (inst & (1 << 21)) != 0;
+    const bool load = (inst & (1 << 20)) != 0;
+
+    // B (BL is a call and is not allowed)
+    if ((inst & 0x0F000000) == 0x0A000000) {
+        info.kind = InstructionInfo::Kind::Branch;
+        info.branch_target = addr + 8 + (static_cast<s32>(inst << 8) >> 6);
+        return info;
+    }
+
+    // Multiplies and extra load/stores
+    if ((inst & 0x0E000090) == 0x00000090) {
+        // Only LDRH, LDRSB and LDRSH
+        if ((inst & 0x60) == 0 || !load || rd == 15) {
+            return Unsupported();
+        }
+        info.reads |= RegBit(rn);
+        if ((inst & (1 << 22)) == 0) {
+            info.reads |= RegBit(rm);
+        }
+        info.writes |= RegBit(rd);
+        if (!pre_indexed || write_back) {
+            info.writes |= RegBit(rn);
+        }
+        return info;
+    }
+
+    // Data processing
+    if ((inst & 0x0C000000) == 0x00000000) {
+        const u32 opcode = (inst >> 21) & 0xF;
+        const bool set_flags = (inst & (1 << 20)) != 0;
+        const bool is_test = opcode >= 0x8 && opcode <= 0xB;
+        if ((is_test && !set_flags) || (!is_test && rd == 15)) {
+            // Miscellaneous instructions (MRS, MSR, BX, ...) or writes to the PC
+            return Unsupported();
+        }
+        if (opcode != 0xD && opcode != 0xF) {
+            info.reads |= RegBit(rn);
+        }
+        if ((inst & (1 << 25)) == 0) {
+            info.reads |= RegBit(rm);
+            if ((inst & (1 << 4)) != 0) {
+                info.reads |= RegBit(rs);
+            }
+        }
+        if (opcode >= 0x5 && opcode <= 0x7) {
+            // ADC, SBC and RSC use the carry flag
+            info.reads |= FLAGS_BIT;
+        }
+        if (set_flags) {
+            info.writes |= FLAGS_BIT;
+        }
+        if (!is_test) {
+            info.writes |= RegBit(rd);
+        }
+        return info;
+    }
+
+    // Single loads (LDR and LDRB)
+    if ((inst & 0x0C000000) == 0x04000000) {
+        const bool register_offset = (inst & (1 << 25)) != 0;
+        if (!load || rd == 15 || (register_offset && (inst & (1 << 4)) != 0)) {
+            return Unsupported();
+        }
+        info.reads |= RegBit(rn);
+        if (register_offset) {
+            info.reads |= RegBit(rm);
+        }
+        info.writes |= RegBit(rd);
+        if (!pre_indexed || write_back) {
+            info.writes |= RegBit(rn);
+        }
+        return info;
+    }
+
+    // SVC
+    if ((inst & 0x0F000000) == 0x0F000000) {
+        if ((inst & 0x00FFFFFF) != SVC_GET_SYSTEM_TICK) {
+            return Unsupported();
+        }
+        info.writes |= RegBit(0) | RegBit(1);
+        return info;
+    }
+
+    return Unsupported();
+}
+
+/// Decodes the subset of Thumb instructions allowed in a polling loop: B, data processing, loads
+/// and svcGetSystemTick.
+InstructionInfo DecodeThumb(u16 inst, VAddr addr) {
+    InstructionInfo info;
+
+    const u32 rd = inst & 7;
+    const u32 rn = (inst >> 3) & 7;
+
+    // SVC
+    if ((inst & 0xFF00) == 0xDF00) {
+        if ((inst & 0xFF) != SVC_GET_SYSTEM_TICK) {
+            return Unsupported();
+        }
+        info.writes |= RegBit(0) | RegBit(1);
+        return info;
+    }
+
+    // B<cond>
+    if ((inst & 0xF000) == 0xD000) {
+        if (((inst >> 8) & 0xF) == 0xE) {
+            // UDF
+            return Unsupported();
+        }
+        info.kind = InstructionInfo::Kind::Branch;
+        info.conditional = true;
+        info.reads |= FLAGS_BIT;
+        info.branch_target = addr + 4 + static_cast<s8>(inst & 0xFF) * 2;
+        return info;
+    }
+
+    // B
+    if ((inst & 0xF800) == 0xE000) {
+        info.kind = InstructionInfo::Kind::Branch;
+        info.branch_target = addr + 4 + (static_cast<s32>(static_cast<u32>(inst) << 21) >> 20);
+        return info;
+    }
+
+    // Shift by immediate, add/subtract register or immediate
+    if ((inst & 0xE000) == 0x0000) {
+        info.reads |= RegBit(rn);
+        if ((inst & 0x1C00) == 0x1800) {
+            info.reads |= RegBit((inst >> 6) & 7);
+        }
+        info.writes |= RegBit(rd) | FLAGS_BIT;
+        return info;
+    }
+
+    // MOV, CMP, ADD and SUB with an 8-bit immediate
+    if ((inst & 0xE000) == 0x2000) {
+        const u32 rdn = (inst >> 8) & 7;
+        const u32 opcode = (inst >> 11) & 3;
+        if (opcode != 0) {
+            info.reads |= RegBit(rdn);
+        }
+        if (opcode != 1) {
+            info.writes |= RegBit(rdn);
+        }
+        info.writes |= FLAGS_BIT;
+        return info;
+    }
+
+    // Data processing with registers
+    if ((inst & 0xFC00) == 0x4000) {
+        const u32 opcode = (inst >> 6) & 0xF;
+        info.reads |= RegBit(rn);
+        if (opcode != 0x9 && opcode != 0xF) {
+            info.reads |= RegBit(rd);
+        }
+        if (opcode == 0x5 || opcode == 0x6) {
+            // ADC and SBC use the carry flag
+            info.reads |= FLAGS_BIT;
+        }
+        if (opcode != 0x8 && opcode != 0xA && opcode != 0xB) {
+            info.writes |= RegBit(rd);
+        }
+        info.writes |= FLAGS_BIT;
+        return info;
+    }
+
+    // ADD, CMP and MOV with high registers (BX and BLX are not allowed)
+    if ((inst & 0xFC00) == 0x4400) {
+        const u32 opcode = (inst >> 8) & 3;
+        const u32 rd_high = ((inst >> 4) & 8) | rd;
+        const u32 rm_high = (inst >> 3) & 0xF;
+        if (opcode == 3 || (opcode != 1 && rd_high == 15)) {
+            return Unsupported();
+        }
+        info.reads |= RegBit(rm_high);
+        if (opcode != 2) {
+            info.reads |= RegBit(rd_high);
+        }
+        if (opcode == 1) {
+            info.writes |= FLAGS_BIT;
+        } else {
+            info.writes |= RegBit(rd_high);
+        }
+        return info;
+    }
+
+    // LDR (literal)
+    if ((inst & 0xF800) == 0x4800) {
+        info.reads |= PC_BIT;
+        info.writes |= RegBit((inst >> 8) & 7);
+        return info;
+    }
+
+    // Loads with a register offset (LDRSB, LDR, LDRH, LDRB and LDRSH)
+    if ((inst & 0xF000) == 0x5000) {
+        if (((inst >> 9) & 7) < 3) {
+            return Unsupported();
+        }
+        info.reads |= RegBit(rn) | RegBit((inst >> 6) & 7);
+        info.writes |= RegBit(rd);
+        return info;
+    }
+
+    // Loads with an immediate offset (LDR, LDRB and LDRH)
+    if ((inst & 0xE000) == 0x6000 || (inst & 0xF000) == 0x8000) {
+        if ((inst & 0x0800) == 0) {
+            return Unsupported();
+        }
+        info.reads |= RegBit(rn);
+        info.writes |= RegBit(rd);
+        return info;
+    }
+
+    // LDR (SP relative)
+    if ((inst & 0xF800) == 0x9800) {
+        info.reads |= RegBit(13);
+        info.writes |= RegBit((inst >> 8) & 7);
+        return info;
+    }
+
+    return Unsupported();
+}
+
+} // Anonymous namespace
+
+IdleLoopDetector::IdleLoopDetector(Memory::MemorySystem& memory) : memory(memory) {}
+
+bool IdleLoopDetector::Sample(const std::array<u32, 16>& regs, u32 cpsr) {
+    Loop loop;
+    if (!AnalyzeLoop(regs[15], (cpsr & (1 << 5)) != 0, loop)) {
+        Reset();
+        return false;
+    }
+
+    bool same_state = has_sample && loop.start == last_loop.start && loop.end == last_loop.end &&
+                      loop.thumb == last_loop.thumb;
+    for (std::size_t i = 0; same_state && i < 15; ++i) {
+        if ((loop.written_mask & RegBit(static_cast<u32>(i))) == 0 && regs[i] != last_regs[i]) {
+            same_state = false;
+        }
+    }
+    if (same_state && (loop.written_mask & FLAGS_BIT) == 0 &&
+        (cpsr & 0xF0000000) != (last_cpsr & 0xF0000000)) {
+        same_state = false;
+    }
+
+    has_sample = true;
+    last_loop = loop;
+    last_regs = regs;
+    last_cpsr = cpsr;
+    return same_state;
+}
+
+void IdleLoopDetector::Reset() {
+    has_sample = false;
+}
+
+bool IdleLoopDetector::AnalyzeLoop(VAddr pc, bool thumb, Loop& loop) const {
+    const u32 instruction_size = thumb ? 2 : 4;
+    const auto decode = [this, thumb](VAddr addr) {
+        return thumb ? DecodeThumb(memory.Read16(addr), addr)
+                     : DecodeArm(memory.Read32(addr), addr);
+    };
+
+    // Find the backward branch that closes the loop containing the PC.
+    bool found_branch = false;
+    for (u32 i = 0; i < MAX_LOOP_INSTRUCTIONS && !found_branch; ++i) {
+        const VAddr addr = pc + i * instruction_size;
+        const InstructionInfo info = decode(addr);
+        if (info.kind == InstructionInfo::Kind::Unsupported) {
+            return false;
+        }
+        if (info.kind == InstructionInfo::Kind::Branch) {
+            if (info.branch_target > pc ||
+                pc - info.branch_target >= MAX_LOOP_INSTRUCTIONS * instruction_size) {
+                return false;
+            }
+            loop.start = info.branch_target;
+            loop.end = addr;
+            found_branch = true;
+        }
+    }
+    if (!found_branch) {
+        return false;
+    }
+    loop.thumb = thumb;
+
+    // The whole body must be made of supported instructions, with the closing branch last.
+    std::array<InstructionInfo, MAX_LOOP_INSTRUCTIONS> body;
+    const u32 body_size = (loop.end - loop.start) / instruction_size + 1;
+    if (body_size > MAX_LOOP_INSTRUCTIONS) {
+        return false;
+    }
+    loop.written_mask = 0;
+    for (u32 i = 0; i < body_size; ++i) {
+        body[i] = decode(loop.start + i * instruction_size);
+        if (body[i].kind == InstructionInfo::Kind::Unsupported ||
+            (body[i].kind == InstructionInfo::Kind::Branch && i != body_size - 1)) {
+            return false;
+        }
+        loop.written_mask |= body[i].writes;
+    }
+
+    // A register read before it is unconditionally written carries state between iterations
+    // (e.g. a spin counter), so the loop does not behave identically every iteration.
+    u32 defined_mask = 0;
+    for (u32 i = 0; i < body_size; ++i) {
+        if ((body[i].reads & ~defined_mask & loop.written_mask & ~PC_BIT) != 0) {
+            return false;
+        }
+        if (!body[i].conditional) {
+            defined_mask |= body[i].writes;
+        }
+    }
+
+    return true;
+}
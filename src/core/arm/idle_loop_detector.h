@@ -0,0 +1,57 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "common/common_types.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+/**
+ * Detects guest code spinning in a tight polling loop, such as a thread waiting for a flag in
+ * shared memory to change.
+ *
+ * The CPU state is sampled whenever a timing slice runs out. A sample is part of an idle loop if
+ * the PC lies within a small backward branch whose body only contains loads, ALU operations and
+ * svcGetSystemTick calls, and no register value is carried from one iteration to the next. Such a
+ * loop can only exit once memory is changed, which on the single emulated core only happens
+ * through scheduled events, or once the system tick passes a deadline, so the time until the next
+ * event can be skipped. A tick deadline may be overshot by up to that much, as if the thread had
+ * been preempted, which busy-wait delays tolerate since they only guarantee a minimum wait.
+ */
+class IdleLoopDetector {
+public:
+    explicit IdleLoopDetector(Memory::MemorySystem& memory);
+
+    /**
+     * Samples the CPU state at the end of a timing slice.
+     * @returns true if the guest was in the same idle loop, with the same loop-invariant register
+     *          values, at the end of the previous slice as well.
+     */
+    bool Sample(const std::array<u32, 16>& regs, u32 cpsr);
+
+    /// Forgets the previous sample, e.g. after a context switch.
+    void Reset();
+
+private:
+    struct Loop {
+        VAddr start = 0;
+        VAddr end = 0;
+        bool thumb = false;
+        /// Registers (and the flags, as bit 16) written anywhere in the loop body.
+        u32 written_mask = 0;
+    };
+
+    bool AnalyzeLoop(VAddr pc, bool thumb, Loop& loop) const;
+
+    Memory::MemorySystem& memory;
+
+    bool has_sample = false;
+    Loop last_loop;
+    std::array<u32, 16> last_regs{};
+    u32 last_cpsr = 0;
+};
@@ -30,6 +30,7 @@
 #include "core/hle/service/fs/archive.h"
 #include "core/hle/service/service.h"
 #include "core/hle/service/sm/sm.h"
+#include "core/hw/gpu.h"
 #include "core/hw/hw.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
@@ -66,7 +67,11 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
     // instead advance to the next event and try to yield to the next thread
     if (kernel->GetThreadManager().GetCurrentThread() == nullptr) {
         LOG_TRACE(Core_ARM11, "Idling");
-        timing->Idle();
+        // A thread may be waiting for work still running on the GPU thread. Finish it instead of
+        // skipping ahead, and only idle if that raised no interrupt that could wake a thread.
+        if (!GPU::SyncGPUThread()) {
+            timing->Idle();
+        }
         timing->Advance();
         PrepareReschedule();
     } else {
@@ -183,7 +188,9 @@ void System::PrepareReschedule() {
 }
 
 PerfStats::Results System::GetAndResetPerfStats() {
-    return perf_stats->GetAndResetStats(timing->GetGlobalTimeUs());
+    return perf_stats->GetAndResetStats(
+        timing->GetGlobalTimeUs(), timing->GetSkippedIdleLoopTicks(),
+        VideoCore::g_texture_hash_lookups.load(), VideoCore::g_texture_hash_hits.load());
 }
 
 void System::Reschedule() {
@@ -219,7 +226,7 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window, u32 system_mo
     kernel->SetCPU(cpu_core);
 
     if (Settings::values.enable_dsp_lle) {
-        dsp_core = std::make_unique<AudioCore::DspLle>(*memory,
+        dsp_core = std::make_unique<AudioCore::DspLle>(*memory, *timing,
                                                        Settings::values.enable_dsp_lle_multithread);
     } else {
         dsp_core = std::make_unique<AudioCore::DspHle>(*memory);
@@ -345,8 +352,9 @@ void System::RegisterImageInterface(std::shared_ptr<Frontend::ImageInterface> im
 void System::Shutdown() {
     // Shutdown emulation session
     GDBStub::Shutdown();
-    VideoCore::Shutdown();
+    // Stops the GPU thread, which uses the renderer
     HW::Shutdown();
+    VideoCore::Shutdown();
     perf_stats.reset();
     rpc_server.reset();
     cheat_engine.reset();
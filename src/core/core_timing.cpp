@@ -160,6 +160,27 @@ void Timing::Idle() {
     downcount = 0;
 }
 
+s64 Timing::SkipToNextEvent() {
+    MoveEvents();
+    if (event_queue.empty()) {
+        return 0;
+    }
+
+    const s64 cycles_to_event = event_queue.front().time - static_cast<s64>(GetTicks());
+    if (cycles_to_event <= 0) {
+        return 0;
+    }
+
+    // Advance() accounts slice_length - downcount as executed, so this moves time to the event.
+    downcount -= cycles_to_event;
+    skipped_idle_loop_cycles += cycles_to_event;
+    return cycles_to_event;
+}
+
+u64 Timing::GetSkippedIdleLoopTicks() const {
+    return static_cast<u64>(skipped_idle_loop_cycles);
+}
+
 std::chrono::microseconds Timing::GetGlobalTimeUs() const {
     return std::chrono::microseconds{GetTicks() * 1000000 / BASE_CLOCK_RATE_ARM11};
 }
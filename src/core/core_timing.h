@@ -189,6 +189,16 @@ public:
     /// Pretend that the main CPU has executed enough cycles to reach the next event.
     void Idle();
 
+    /**
+     * Pretends that the main CPU has executed enough cycles to reach the next scheduled event,
+     * even past the end of the current slice. Used to fast-forward through guest idle loops.
+     * @returns the number of cycles skipped
+     */
+    s64 SkipToNextEvent();
+
+    /// Returns the total number of cycles skipped by SkipToNextEvent.
+    u64 GetSkippedIdleLoopTicks() const;
+
     void ForceExceptionCheck(s64 cycles);
 
     std::chrono::microseconds GetGlobalTimeUs() const;
@@ -226,6 +236,7 @@ private:
     // to the event_queue by the emu thread
     Common::MPSCQueue<Event> ts_queue = {};
     s64 idled_cycles = 0;
+    s64 skipped_idle_loop_cycles = 0;
 
     // Are we in a function that has been called from Advance()
     // If events are sheduled from a function that gets called from Advance(),
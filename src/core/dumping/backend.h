@@ -22,7 +22,23 @@ public:
     u32 stride;
     std::vector<u8> data;
 
-    VideoFrame(std::size_t width_ = 0, std::size_t height_ = 0, u8* data_ = nullptr);
+    VideoFrame(std::size_t width_ = 0, std::size_t height_ = 0, const u8* data_ = nullptr);
+
+    /**
+     * Copies a frame read back from OpenGL (bottom row first) into this frame, reusing the
+     * existing storage when it is large enough.
+     */
+    void Load(std::size_t width_, std::size_t height_, const u8* data_);
+};
+
+/// Statistics of the queue between the renderer and the video encoder
+struct VideoQueueStats {
+    std::size_t depth = 0;     ///< Frames currently waiting to be encoded
+    std::size_t capacity = 0;  ///< Frames that can wait before the renderer is blocked
+    std::size_t max_depth = 0; ///< Most frames that were waiting at once
+    u64 frames_encoded = 0;
+    double stall_seconds = 0.0;  ///< Time the renderer spent waiting for a free slot
+    double encoder_fps = 0.0;    ///< Frames encoded per second of encoding time
 };
 
 class Backend {
@@ -30,12 +46,14 @@ public:
     virtual ~Backend();
     virtual bool StartDumping(const std::string& path, const std::string& format,
                               const Layout::FramebufferLayout& layout) = 0;
-    virtual void AddVideoFrame(const VideoFrame& frame) = 0;
+    /// Queues a frame for encoding. The pixels are in the layout returned by glReadPixels.
+    virtual void AddVideoFrame(std::size_t width, std::size_t height, const u8* pixels) = 0;
     virtual void AddAudioFrame(const AudioCore::StereoFrame16& frame) = 0;
     virtual void AddAudioSample(const std::array<s16, 2>& sample) = 0;
     virtual void StopDumping() = 0;
     virtual bool IsDumping() const = 0;
     virtual Layout::FramebufferLayout GetLayout() const = 0;
+    virtual VideoQueueStats GetVideoQueueStats() const = 0;
 };
 
 class NullBackend : public Backend {
@@ -45,7 +63,8 @@ public:
                       const Layout::FramebufferLayout& /*layout*/) override {
         return false;
     }
-    void AddVideoFrame(const VideoFrame& /*frame*/) override {}
+    void AddVideoFrame(std::size_t /*width*/, std::size_t /*height*/,
+                       const u8* /*pixels*/) override {}
     void AddAudioFrame(const AudioCore::StereoFrame16& /*frame*/) override {}
     void AddAudioSample(const std::array<s16, 2>& /*sample*/) override {}
     void StopDumping() override {}
@@ -55,5 +74,8 @@ public:
     Layout::FramebufferLayout GetLayout() const override {
         return Layout::FramebufferLayout{};
     }
+    VideoQueueStats GetVideoQueueStats() const override {
+        return VideoQueueStats{};
+    }
 };
 } // namespace VideoDumper
@@ -2,10 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/assert.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/dumping/ffmpeg_backend.h"
+#include "core/settings.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
@@ -406,23 +408,45 @@ bool FFmpegBackend::StartDumping(const std::string& path, const std::string& for
 
     video_layout = layout;
 
+    {
+        std::lock_guard lock(video_queue_mutex);
+        video_frame_queue.clear();
+        video_queue_capacity =
+            std::max<std::size_t>(Settings::values.video_dumping_queue_depth, 1);
+        max_video_queue_depth = 0;
+        frames_encoded = 0;
+        stall_time = {};
+        encode_time = {};
+    }
+
     if (video_processing_thread.joinable())
         video_processing_thread.join();
     video_processing_thread = std::thread([&] {
-        event1.Set();
         while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
-            // Process this frame
-            VideoDumper::VideoFrame& frame = video_frame_buffers[current_buffer];
+            VideoFrame frame;
+            {
+                std::unique_lock lock(video_queue_mutex);
+                video_queue_cv.wait(lock, [this] { return !video_frame_queue.empty(); });
+                frame = std::move(video_frame_queue.front());
+                video_frame_queue.pop_front();
+            }
+            // A slot was freed, wake up the renderer if it is waiting for one
+            video_queue_cv.notify_all();
+
             if (frame.width == 0 && frame.height == 0) {
                 // An empty frame marks the end of frame data
                 ffmpeg.FlushVideo();
                 break;
             }
+
+            const Clock::time_point start = Clock::now();
             ffmpeg.ProcessVideoFrame(frame);
+            const Clock::duration elapsed = Clock::now() - start;
+
+            std::lock_guard lock(video_queue_mutex);
+            encode_time += elapsed;
+            ++frames_encoded;
+            free_video_frames.push_back(std::move(frame));
         }
         // Finish audio execution first if not done yet
         if (audio_processing_thread.joinable())
@@ -452,10 +476,34 @@ bool FFmpegBackend::StartDumping(const std::string& path, const std::string& for
     return true;
 }
 
-void FFmpegBackend::AddVideoFrame(const VideoFrame& frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+void FFmpegBackend::AddVideoFrame(std::size_t width, std::size_t height, const u8* pixels) {
+    VideoFrame frame;
+    {
+        std::unique_lock lock(video_queue_mutex);
+        if (video_frame_queue.size() >= video_queue_capacity) {
+            const Clock::time_point start = Clock::now();
+            video_queue_cv.wait(
+                lock, [this] { return video_frame_queue.size() < video_queue_capacity; });
+            stall_time += Clock::now() - start;
+        }
+        if (!free_video_frames.empty()) {
+            frame = std::move(free_video_frames.back());
+            free_video_frames.pop_back();
+        }
+    }
+
+    // Only the renderer adds frames, so the slot stays free while copying outside the lock
+    frame.Load(width, height, pixels);
+    PushVideoFrame(std::move(frame));
+}
+
+void FFmpegBackend::PushVideoFrame(VideoFrame frame) {
+    {
+        std::lock_guard lock(video_queue_mutex);
+        video_frame_queue.push_back(std::move(frame));
+        max_video_queue_depth = std::max(max_video_queue_depth, video_frame_queue.size());
+    }
+    video_queue_cv.notify_all();
 }
 
 void FFmpegBackend::AddAudioFrame(const AudioCore::StereoFrame16& frame) {
@@ -484,7 +532,7 @@ void FFmpegBackend::StopDumping() {
     VideoCore::g_renderer->CleanupVideoDumping();
 
     // Flush the video processing queue
-    AddVideoFrame(VideoFrame());
+    PushVideoFrame(VideoFrame());
     for (int i : {0, 1}) {
         // Add remaining data to audio queue
         if (audio_buffers[i].size() >= 0) {
@@ -507,8 +555,32 @@ Layout::FramebufferLayout FFmpegBackend::GetLayout() const {
     return video_layout;
 }
 
+VideoQueueStats FFmpegBackend::GetVideoQueueStats() const {
+    using Seconds = std::chrono::duration<double>;
+
+    std::lock_guard lock(video_queue_mutex);
+    VideoQueueStats stats;
+    stats.depth = video_frame_queue.size();
+    stats.capacity = video_queue_capacity;
+    stats.max_depth = max_video_queue_depth;
+    stats.frames_encoded = frames_encoded;
+    stats.stall_seconds = std::chrono::duration_cast<Seconds>(stall_time).count();
+    const double encode_seconds = std::chrono::duration_cast<Seconds>(encode_time).count();
+    stats.encoder_fps = encode_seconds > 0.0 ? frames_encoded / encode_seconds : 0.0;
+    return stats;
+}
+
 void FFmpegBackend::EndDumping() {
-    LOG_INFO(Render, "Ending frame dumping");
+    const VideoQueueStats stats = GetVideoQueueStats();
+    LOG_INFO(Render,
+             "Ending frame dumping: {} frames encoded at {:.1f} fps, renderer stalled for {:.3f} "
+             "s, queue peaked at {}/{} frames",
+             stats.frames_encoded, stats.encoder_fps, stats.stall_seconds, stats.max_depth,
+             stats.capacity);
+    {
+        std::lock_guard lock(video_queue_mutex);
+        free_video_frames.clear();
+    }
 
     ffmpeg.WriteTrailer();
     ffmpeg.Free();
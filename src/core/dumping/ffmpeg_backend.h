@@ -5,7 +5,9 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -154,8 +156,9 @@ private:
 
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer, and an audio queue to keep audio data
- * before enough data is received to form a frame.
+ * This class implements a queue of pooled video frames, so that the renderer only blocks when the
+ * encoder falls several frames behind, and an audio queue to keep audio data before enough data
+ * is received to form a frame.
  */
 class FFmpegBackend : public Backend {
 public:
@@ -163,14 +166,18 @@ public:
     ~FFmpegBackend() override;
     bool StartDumping(const std::string& path, const std::string& format,
                       const Layout::FramebufferLayout& layout) override;
-    void AddVideoFrame(const VideoFrame& frame) override;
+    void AddVideoFrame(std::size_t width, std::size_t height, const u8* pixels) override;
     void AddAudioFrame(const AudioCore::StereoFrame16& frame) override;
     void AddAudioSample(const std::array<s16, 2>& sample) override;
     void StopDumping() override;
     bool IsDumping() const override;
     Layout::FramebufferLayout GetLayout() const override;
+    VideoQueueStats GetVideoQueueStats() const override;
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    void PushVideoFrame(VideoFrame frame);
     void CheckAudioBuffer();
     void EndDumping();
 
@@ -179,11 +186,22 @@ private:
     FFmpegMuxer ffmpeg{};
 
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
     std::thread video_processing_thread;
 
+    /// Frames waiting to be encoded, oldest first. An empty frame marks the end of frame data.
+    std::deque<VideoFrame> video_frame_queue;
+    /// Frames already encoded, kept to reuse their storage
+    std::vector<VideoFrame> free_video_frames;
+    std::size_t video_queue_capacity = 1;
+    mutable std::mutex video_queue_mutex;
+    std::condition_variable video_queue_cv;
+
+    // Statistics, protected by video_queue_mutex
+    std::size_t max_video_queue_depth = 0;
+    u64 frames_encoded = 0;
+    Clock::duration stall_time{};
+    Clock::duration encode_time{};
+
     /// An audio buffer used to temporarily hold audio data, before the size is big enough
     /// to be sent to the encoder as a frame
     std::array<VariableAudioFrame, 2> audio_buffers;
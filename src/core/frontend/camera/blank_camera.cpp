@@ -24,8 +24,14 @@ void BlankCamera::SetFlip(Service::CAM::Flip) {}
 void BlankCamera::SetEffect(Service::CAM::Effect) {}
 
 std::vector<u16> BlankCamera::ReceiveFrame() {
+    std::vector<u16> buffer;
+    ReceiveFrameInto(buffer);
+    return buffer;
+}
+
+void BlankCamera::ReceiveFrameInto(std::vector<u16>& buffer) {
     // Note: 0x80008000 stands for two black pixels in YUV422
-    return std::vector<u16>(width * height, output_rgb ? 0 : 0x8000);
+    buffer.assign(width * height, output_rgb ? 0 : 0x8000);
 }
 
 bool BlankCamera::IsPreviewAvailable() {
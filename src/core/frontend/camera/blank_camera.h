@@ -19,6 +19,7 @@ public:
     void SetFormat(Service::CAM::OutputFormat) override;
     void SetFrameRate(Service::CAM::FrameRate frame_rate) override {}
     std::vector<u16> ReceiveFrame() override;
+    void ReceiveFrameInto(std::vector<u16>& buffer) override;
     bool IsPreviewAvailable() override;
 
 private:
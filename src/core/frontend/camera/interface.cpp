@@ -8,4 +8,8 @@ namespace Camera {
 
 CameraInterface::~CameraInterface() = default;
 
+void CameraInterface::ReceiveFrameInto(std::vector<u16>& buffer) {
+    buffer = ReceiveFrame();
+}
+
 } // namespace Camera
@@ -63,6 +63,13 @@ public:
      */
     virtual std::vector<u16> ReceiveFrame() = 0;
 
+    /**
+     * Receives a frame from the camera into an existing buffer, so that its memory can be reused
+     * between frames. The default implementation calls ReceiveFrame.
+     * @param buffer Buffer to write the pixels to. It is resized to width * height.
+     */
+    virtual void ReceiveFrameInto(std::vector<u16>& buffer);
+
     /**
      * Test if the camera is opened successfully and can receive a preview frame. Only used for
      * preview. This function should be only called between a StartCapture call and a StopCapture
@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/param_package.h"
 #include "common/vector_math.h"
@@ -132,4 +135,44 @@ using MotionDevice = InputDevice<std::tuple<Common::Vec3<float>, Common::Vec3<fl
  */
 using TouchDevice = InputDevice<std::tuple<float, float, bool>>;
 
+namespace Impl {
+/// Steady clock time of the latest input event, in nanoseconds
+inline std::atomic<s64> last_event_time{0};
+/// Number of polls started by all threads. Shared by every thread so a thread that starts polling
+/// never reuses the generation of an earlier poll.
+inline std::atomic<u64> poll_generation{0};
+/// Generation of the latest poll started by the current thread, 0 if it never polled
+inline thread_local u64 current_poll = 0;
+} // namespace Impl
+
+/**
+ * Records that the host reported an input event just now. Devices call this when their state
+ * changes, so the latency until the change reaches the emulated system can be measured.
+ */
+inline void NotifyInputEvent() {
+    Impl::last_event_time.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count(),
+                                std::memory_order_relaxed);
+}
+
+/// Returns the steady clock time of the latest input event in nanoseconds, 0 if there was none
+inline s64 GetLastInputEventTime() {
+    return Impl::last_event_time.load(std::memory_order_relaxed);
+}
+
+/**
+ * Starts reading a new set of statuses on the current thread. Devices backed by state that
+ * another thread updates take one snapshot of it per poll, so the statuses read until the next
+ * call are consistent with each other. Only one thread (the emulation thread) should poll.
+ */
+inline void BeginPoll() {
+    Impl::current_poll = Impl::poll_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+/// Returns the generation of the latest poll started by the current thread, 0 if it never polls
+inline u64 GetPollGeneration() {
+    return Impl::current_poll;
+}
+
 } // namespace Input
@@ -12,7 +12,10 @@
 #include <cstdio>
 #include <cstring>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <thread>
+#include <vector>
 #include <fcntl.h>
 #include <fmt/format.h>
 
@@ -25,13 +28,13 @@
 #define SHUT_RDWR 2
 #else
 #include <netinet/in.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
 #endif
 
 #include "common/logging/log.h"
+#include "common/threadsafe_queue.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -47,6 +50,7 @@ constexpr char GDB_STUB_START = '$';
 constexpr char GDB_STUB_END = '#';
 constexpr char GDB_STUB_ACK = '+';
 constexpr char GDB_STUB_NACK = '-';
+constexpr char GDB_STUB_INTERRUPT = 0x03;
 
 #ifndef SIGTRAP
 constexpr u32 SIGTRAP = 5;
@@ -125,6 +129,15 @@ int gdbserver_socket = -1;
 u8 command_buffer[GDB_BUFFER_SIZE];
 u32 command_length;
 
+// Packets are received on their own thread, so the emulation loop never waits on the socket. The
+// emulation thread handles them, since that is the only thread that may touch the CPU state.
+std::thread receive_thread;
+Common::SPSCQueue<std::vector<u8>> received_packets;
+std::atomic<bool> client_disconnected{false};
+// The receive thread acknowledges packets while the emulation thread sends replies, so writes to
+// the socket are serialized to keep the bytes of a reply together.
+std::mutex send_mutex;
+
 u32 latest_signal = 0;
 bool memory_break = false;
 
@@ -359,16 +372,19 @@ static u64 GdbHexToLong(const u8* src) {
     return output;
 }
 
-/// Read a byte from the gdb client.
-static u8 ReadByte() {
-    u8 c;
-    std::size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
+/**
+ * Read a byte from the gdb client.
+ *
+ * @returns false if the connection was closed.
+ */
+static bool ReadByte(u8& c) {
+    const int received_size =
+        static_cast<int>(recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL));
     if (received_size != 1) {
         LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
-        Shutdown();
+        return false;
     }
-
-    return c;
+    return true;
 }
 
 /// Calculate the checksum of the current command buffer.
@@ -416,6 +432,9 @@ static void RemoveBreakpoint(BreakpointType type, VAddr addr) {
             *Core::System::GetInstance().Kernel().GetCurrentProcess(), bp->second.addr,
             bp->second.inst.data(), bp->second.inst.size());
         Core::CPU().ClearInstructionCache();
+    } else {
+        Core::System::GetInstance().Memory().MarkRegionWatched(bp->second.addr, bp->second.len,
+                                                               false);
     }
     p.erase(addr);
 }
@@ -436,17 +455,18 @@ BreakpointAddress GetNextBreakpointFromAddress(VAddr addr, BreakpointType type)
     return breakpoint;
 }
 
-bool CheckBreakpoint(VAddr addr, BreakpointType type) {
+bool CheckBreakpoint(VAddr addr, BreakpointType type, u32 size) {
     if (!IsConnected()) {
         return false;
     }
 
+    // Find the last breakpoint starting inside the accessed range or before it
     const BreakpointMap& p = GetBreakpointMap(type);
-    const auto bp = p.find(addr);
-
-    if (bp == p.end()) {
+    auto bp = p.upper_bound(addr + size - 1);
+    if (bp == p.begin()) {
         return false;
     }
+    --bp;
 
     u32 len = bp->second.len;
 
@@ -462,7 +482,7 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
         len = 1;
     }
 
-    if (bp->second.active && (addr >= bp->second.addr && addr < bp->second.addr + len)) {
+    if (bp->second.active && addr < bp->second.addr + len) {
         LOG_DEBUG(Debug_GDBStub,
                   "Found breakpoint type {} @ {:08x}, range: {:08x}"
                   " - {:08x} ({:x} bytes)",
@@ -473,12 +493,17 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
     return false;
 }
 
+bool HasMemoryBreakpoints() {
+    return IsConnected() && (!breakpoints_read.empty() || !breakpoints_write.empty());
+}
+
 /**
  * Send packet to gdb client.
  *
  * @param packet Packet to be sent to client.
  */
 static void SendPacket(const char packet) {
+    std::lock_guard lock{send_mutex};
     std::size_t sent_size = send(gdbserver_socket, &packet, 1, 0);
     if (sent_size != 1) {
         LOG_ERROR(Debug_GDBStub, "send failed");
@@ -513,15 +538,23 @@ static void SendReply(const char* reply) {
 
     u8* ptr = command_buffer;
     u32 left = command_length + 4;
-    while (left > 0) {
-        int sent_size = send(gdbserver_socket, reinterpret_cast<char*>(ptr), left, 0);
-        if (sent_size < 0) {
-            LOG_ERROR(Debug_GDBStub, "gdb: send failed");
-            return Shutdown();
+    bool failed = false;
+    {
+        std::lock_guard lock{send_mutex};
+        while (left > 0) {
+            int sent_size = send(gdbserver_socket, reinterpret_cast<char*>(ptr), left, 0);
+            if (sent_size < 0) {
+                failed = true;
+                break;
+            }
+
+            left -= sent_size;
+            ptr += sent_size;
         }
-
-        left -= sent_size;
-        ptr += sent_size;
+    }
+    if (failed) {
+        LOG_ERROR(Debug_GDBStub, "gdb: send failed");
+        return Shutdown();
     }
 }
 
@@ -635,75 +668,84 @@ static void SendSignal(Kernel::Thread* thread, u32 signal, bool full = true) {
     SendReply(buffer.c_str());
 }
 
-/// Read command from gdb client.
-static void ReadCommand() {
-    command_length = 0;
-    memset(command_buffer, 0, sizeof(command_buffer));
-
-    u8 c = ReadByte();
+/**
+ * Read a packet from the gdb client. Called on the receive thread.
+ *
+ * @param packet Receives the packet contents. Left empty for acknowledgements and invalid packets.
+ * @returns false if the connection was closed.
+ */
+static bool ReceivePacket(std::vector<u8>& packet) {
+    u8 c;
+    if (!ReadByte(c)) {
+        return false;
+    }
     if (c == '+') {
         // ignore ack
-        return;
-    } else if (c == 0x03) {
-        LOG_INFO(Debug_GDBStub, "gdb: found break command\n");
-        halt_loop = true;
-        SendSignal(current_thread, SIGTRAP);
-        return;
+        return true;
+    } else if (c == GDB_STUB_INTERRUPT) {
+        packet.push_back(c);
+        return true;
     } else if (c != GDB_STUB_START) {
         LOG_DEBUG(Debug_GDBStub, "gdb: read invalid byte {:02x}\n", c);
-        return;
+        return true;
     }
 
-    while ((c = ReadByte()) != GDB_STUB_END) {
-        if (command_length >= sizeof(command_buffer)) {
-            LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
-            SendPacket(GDB_STUB_NACK);
-            return;
+    bool overflow = false;
+    while (true) {
+        if (!ReadByte(c)) {
+            return false;
+        }
+        if (c == GDB_STUB_END) {
+            break;
+        }
+        if (packet.size() + 1 >= GDB_BUFFER_SIZE) {
+            overflow = true;
+        } else {
+            packet.push_back(c);
         }
-        command_buffer[command_length++] = c;
     }
 
-    u8 checksum_received = HexCharToValue(ReadByte()) << 4;
-    checksum_received |= HexCharToValue(ReadByte());
+    u8 checksum_high;
+    u8 checksum_low;
+    if (!ReadByte(checksum_high) || !ReadByte(checksum_low)) {
+        return false;
+    }
 
-    u8 checksum_calculated = CalculateChecksum(command_buffer, command_length);
+    if (overflow) {
+        LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
+        packet.clear();
+        SendPacket(GDB_STUB_NACK);
+        return true;
+    }
 
+    const u8 checksum_received =
+        static_cast<u8>((HexCharToValue(checksum_high) << 4) | HexCharToValue(checksum_low));
+    const u8 checksum_calculated = CalculateChecksum(packet.data(), packet.size());
     if (checksum_received != checksum_calculated) {
-        LOG_ERROR(
-            Debug_GDBStub,
-            "gdb: invalid checksum: calculated {:02x} and read {:02x} for ${}# (length: {})\n",
-            checksum_calculated, checksum_received, command_buffer, command_length);
-
-        command_length = 0;
-
+        LOG_ERROR(Debug_GDBStub,
+                  "gdb: invalid checksum: calculated {:02x} and read {:02x} (length: {})\n",
+                  checksum_calculated, checksum_received, packet.size());
+        packet.clear();
         SendPacket(GDB_STUB_NACK);
-        return;
+        return true;
     }
 
     SendPacket(GDB_STUB_ACK);
+    return true;
 }
 
-/// Check if there is data to be read from the gdb client.
-static bool IsDataAvailable() {
-    if (!IsConnected()) {
-        return false;
-    }
-
-    fd_set fd_socket;
-
-    FD_ZERO(&fd_socket);
-    FD_SET(gdbserver_socket, &fd_socket);
-
-    struct timeval t;
-    t.tv_sec = 0;
-    t.tv_usec = 0;
-
-    if (select(gdbserver_socket + 1, &fd_socket, nullptr, nullptr, &t) < 0) {
-        LOG_ERROR(Debug_GDBStub, "select failed");
-        return false;
+/// Receives packets from the gdb client until the connection is closed.
+static void ReceiveThread() {
+    while (true) {
+        std::vector<u8> packet;
+        if (!ReceivePacket(packet)) {
+            client_disconnected = true;
+            return;
+        }
+        if (!packet.empty()) {
+            received_packets.Push(std::move(packet));
+        }
     }
-
-    return FD_ISSET(gdbserver_socket, &fd_socket) != 0;
 }
 
 /// Send requested register to gdb client.
@@ -927,13 +969,20 @@ static bool CommitBreakpoint(BreakpointType type, VAddr addr, u32 len) {
         breakpoint.inst.size());
 
     static constexpr std::array<u8, 4> btrap{0x70, 0x00, 0x20, 0xe1};
+    static constexpr std::array<u8, 2> thumb_btrap{0x00, 0xbe};
     if (type == BreakpointType::Execute) {
+        // gdb asks for 2 byte breakpoints in Thumb code, where the ARM encoding would be
+        // decoded as two unrelated instructions
+        const u8* trap = len == thumb_btrap.size() ? thumb_btrap.data() : btrap.data();
+        const std::size_t trap_size = len == thumb_btrap.size() ? thumb_btrap.size() : btrap.size();
         Core::System::GetInstance().Memory().WriteBlock(
-            *Core::System::GetInstance().Kernel().GetCurrentProcess(), addr, btrap.data(),
-            btrap.size());
+            *Core::System::GetInstance().Kernel().GetCurrentProcess(), addr, trap, trap_size);
         Core::CPU().ClearInstructionCache();
     }
-    p.insert({addr, breakpoint});
+    if (p.insert({addr, breakpoint}).second && type != BreakpointType::Execute) {
+        // Accesses to the page are then checked by the CPU
+        Core::System::GetInstance().Memory().MarkRegionWatched(addr, len, true);
+    }
 
     LOG_DEBUG(Debug_GDBStub, "gdb: added {} breakpoint: {:08x} bytes at {:08x}\n",
               static_cast<int>(type), breakpoint.len, breakpoint.addr);
@@ -1034,15 +1083,27 @@ void HandlePacket() {
         return;
     }
 
-    if (!IsDataAvailable()) {
+    if (client_disconnected) {
+        Shutdown();
         return;
     }
 
-    ReadCommand();
-    if (command_length == 0) {
+    std::vector<u8> packet;
+    if (!received_packets.Pop(packet)) {
         return;
     }
 
+    if (packet[0] == GDB_STUB_INTERRUPT) {
+        LOG_INFO(Debug_GDBStub, "gdb: found break command\n");
+        halt_loop = true;
+        SendSignal(current_thread, SIGTRAP);
+        return;
+    }
+
+    command_length = static_cast<u32>(packet.size());
+    std::memcpy(command_buffer, packet.data(), packet.size());
+    std::memset(command_buffer + command_length, 0, sizeof(command_buffer) - command_length);
+
     LOG_DEBUG(Debug_GDBStub, "Packet: {}", command_buffer);
 
     switch (command_buffer[0]) {
@@ -1188,6 +1249,10 @@ static void Init(u16 port) {
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.\n");
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
+
+        client_disconnected = false;
+        received_packets.Clear();
+        receive_thread = std::thread(ReceiveThread);
     }
 
     // Clean up temporary socket if it's still alive at this point.
@@ -1207,7 +1272,11 @@ void Shutdown() {
 
     LOG_INFO(Debug_GDBStub, "Stopping GDB ...");
     if (gdbserver_socket != -1) {
+        // Shutting the socket down wakes the receive thread up
         shutdown(gdbserver_socket, SHUT_RDWR);
+        if (receive_thread.joinable()) {
+            receive_thread.join();
+        }
         gdbserver_socket = -1;
     }
 
@@ -61,7 +61,7 @@ void Break(bool is_memory_break = false);
 /// Determine if there was a memory breakpoint.
 bool IsMemoryBreak();
 
-/// Read and handle packet from gdb client.
+/// Handle a packet received from the gdb client, if there is one.
 void HandlePacket();
 
 /**
@@ -73,12 +73,16 @@ void HandlePacket();
 BreakpointAddress GetNextBreakpointFromAddress(VAddr addr, GDBStub::BreakpointType type);
 
 /**
- * Check if a breakpoint of the specified type exists at the given address.
+ * Check if a breakpoint of the specified type covers any byte of the given range.
  *
  * @param addr Address of breakpoint.
  * @param type Type of breakpoint.
+ * @param size Number of bytes accessed at addr.
  */
-bool CheckBreakpoint(VAddr addr, GDBStub::BreakpointType type);
+bool CheckBreakpoint(VAddr addr, GDBStub::BreakpointType type, u32 size = 1);
+
+/// Returns true if a debugger is connected and has set read or write breakpoints.
+bool HasMemoryBreakpoints();
 
 // If set to true, the CPU will halt at the beginning of the next CPU loop.
 bool GetCpuHaltFlag();
@@ -4,18 +4,73 @@
 
 #include <algorithm>
 #include <vector>
+#include <boost/container/static_vector.hpp>
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "core/core.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
+#include "core/memory.h"
 
 namespace Kernel {
 
+namespace {
+/// Recycles static buffer storage between requests handled on the same host thread, so that
+/// translating a request usually does not allocate.
+class StaticBufferPool {
+public:
+    std::vector<u8> Acquire(std::size_t size) {
+        if (free_buffers.empty()) {
+            return std::vector<u8>(size);
+        }
+        std::vector<u8> buffer = std::move(free_buffers.back());
+        free_buffers.pop_back();
+        buffer.resize(size);
+        return buffer;
+    }
+
+    void Release(std::vector<u8>&& buffer) {
+        if (buffer.capacity() == 0 || buffer.capacity() > MaxPooledCapacity ||
+            free_buffers.size() == MaxPooledBuffers) {
+            return;
+        }
+        buffer.clear();
+        free_buffers.push_back(std::move(buffer));
+    }
+
+private:
+    static constexpr std::size_t MaxPooledBuffers = IPC::MAX_STATIC_BUFFERS * 2;
+    static constexpr std::size_t MaxPooledCapacity = 0x4000;
+
+    boost::container::static_vector<std::vector<u8>, MaxPooledBuffers> free_buffers;
+};
+
+thread_local StaticBufferPool static_buffer_pool;
+} // Anonymous namespace
+
+std::vector<u8> HLERequestContext::AcquireStaticBuffer(std::size_t size) {
+    return static_buffer_pool.Acquire(size);
+}
+
+void HLERequestContext::ReleaseStaticBuffer(std::vector<u8>&& buffer) {
+    static_buffer_pool.Release(std::move(buffer));
+}
+
+std::string HLERequestContext::GetProfilerName() const {
+    if (session->hle_handler != nullptr) {
+        std::string name = session->hle_handler->GetProfilerName();
+        if (!name.empty()) {
+            return name;
+        }
+    }
+    return session->GetName();
+}
+
 SessionRequestHandler::SessionInfo::SessionInfo(std::shared_ptr<ServerSession> session,
                                                 std::unique_ptr<SessionDataBase> data)
     : session(std::move(session)), data(std::move(data)) {}
@@ -33,6 +88,10 @@ void SessionRequestHandler::ClientDisconnected(std::shared_ptr<ServerSession> se
         connected_sessions.end());
 }
 
+std::string SessionRequestHandler::GetProfilerName() const {
+    return "";
+}
+
 std::shared_ptr<Event> HLERequestContext::SleepClientThread(const std::string& reason,
                                                             std::chrono::nanoseconds timeout,
                                                             WakeupCallback&& callback) {
@@ -75,7 +134,11 @@ HLERequestContext::HLERequestContext(KernelSystem& kernel, std::shared_ptr<Serve
     cmd_buf[0] = 0;
 }
 
-HLERequestContext::~HLERequestContext() = default;
+HLERequestContext::~HLERequestContext() {
+    for (std::vector<u8>& buffer : static_buffers) {
+        ReleaseStaticBuffer(std::move(buffer));
+    }
+}
 
 std::shared_ptr<Object> HLERequestContext::GetIncomingHandle(u32 id_from_cmdbuf) const {
     ASSERT(id_from_cmdbuf < request_handles.size());
@@ -96,6 +159,7 @@ const std::vector<u8>& HLERequestContext::GetStaticBuffer(u8 buffer_id) const {
 }
 
 void HLERequestContext::AddStaticBuffer(u8 buffer_id, std::vector<u8> data) {
+    ReleaseStaticBuffer(std::move(static_buffers[buffer_id]));
     static_buffers[buffer_id] = std::move(data);
 }
 
@@ -108,8 +172,11 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
     ASSERT(command_size <= IPC::COMMAND_BUFFER_LENGTH); // TODO(yuriks): Return error
 
     std::copy_n(src_cmdbuf, untranslated_size, cmd_buf.begin());
+    request_header = header.raw;
 
     const bool should_record = kernel.GetIPCRecorder().IsEnabled();
+    const bool should_profile = kernel.GetIPCProfiler().IsEnabled();
+    std::size_t translated_bytes = 0;
 
     std::vector<u32> untranslated_cmdbuf;
     if (should_record) {
@@ -150,9 +217,10 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
             // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
+            std::vector<u8> data = AcquireStaticBuffer(buffer_info.size);
             kernel.memory.ReadBlock(src_process, source_address, data.data(), data.size());
 
+            translated_bytes += data.size();
             AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
@@ -161,6 +229,7 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
             u32 next_id = static_cast<u32>(request_mapped_buffers.size());
             request_mapped_buffers.emplace_back(kernel.memory, src_process, descriptor,
                                                 src_cmdbuf[i], next_id);
+            translated_bytes += request_mapped_buffers.back().GetSize();
             cmd_buf[i++] = next_id;
             break;
         }
@@ -175,6 +244,11 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
                                                std::move(translated_cmdbuf));
     }
 
+    if (should_profile && session != nullptr) {
+        kernel.GetIPCProfiler().RecordTranslatedBytes(GetProfilerName(), request_header,
+                                                      translated_bytes);
+    }
+
     return RESULT_SUCCESS;
 }
 
@@ -189,6 +263,8 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
     std::copy_n(cmd_buf.begin(), untranslated_size, dst_cmdbuf);
 
     const bool should_record = kernel.GetIPCRecorder().IsEnabled();
+    const bool should_profile = kernel.GetIPCProfiler().IsEnabled();
+    std::size_t translated_bytes = 0;
 
     std::vector<u32> untranslated_cmdbuf;
     if (should_record) {
@@ -233,6 +309,7 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
             ASSERT_MSG(target_descriptor.size >= data.size(), "Static buffer data is too big");
 
             kernel.memory.WriteBlock(dst_process, target_address, data.data(), data.size());
+            translated_bytes += data.size();
 
             dst_cmdbuf[i++] = target_address;
             break;
@@ -253,6 +330,11 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
                                              std::move(translated_cmdbuf));
     }
 
+    if (should_profile && session != nullptr) {
+        kernel.GetIPCProfiler().RecordTranslatedBytes(GetProfilerName(), request_header,
+                                                      translated_bytes);
+    }
+
     return RESULT_SUCCESS;
 }
 
@@ -287,4 +369,30 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     memory->WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+std::optional<std::vector<std::pair<u8*, u32>>> MappedBuffer::GetWritableBackingBlocks(
+    std::size_t offset, std::size_t size) {
+    ASSERT(perms & IPC::W);
+    ASSERT(offset + size <= this->size);
+    if (size == 0) {
+        return std::nullopt;
+    }
+
+    const VAddr start = address + static_cast<VAddr>(offset);
+    const VAddr end = start + static_cast<VAddr>(size);
+    const Memory::PageTable& page_table = process->vm_manager.page_table;
+    for (std::size_t page_index = start >> Memory::PAGE_BITS;
+         page_index <= ((end - 1) >> Memory::PAGE_BITS); ++page_index) {
+        if (page_table.attributes[page_index] != Memory::PageType::Memory) {
+            return std::nullopt;
+        }
+    }
+
+    ResultVal<std::vector<std::pair<u8*, u32>>> backing_blocks =
+        process->vm_manager.GetBackingBlocksForRange(start, static_cast<u32>(size));
+    if (backing_blocks.Failed()) {
+        return std::nullopt;
+    }
+    return std::move(*backing_blocks);
+}
+
 } // namespace Kernel
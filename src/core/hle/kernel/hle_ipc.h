@@ -8,7 +8,9 @@
 #include <array>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 #include <boost/container/small_vector.hpp>
 #include "common/common_types.h"
@@ -64,6 +66,12 @@ public:
      */
     virtual void ClientDisconnected(std::shared_ptr<ServerSession> server_session);
 
+    /**
+     * Returns the name requests to this handler are profiled under, or an empty string to use the
+     * name of the session the request was made through.
+     */
+    virtual std::string GetProfilerName() const;
+
     /// Empty placeholder structure for services with no per-session data. The session data classes
     /// in each service must inherit from this.
     struct SessionDataBase {
@@ -104,6 +112,15 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+
+    /**
+     * Resolves the host memory backing a writable range of the buffer, so that it can be filled
+     * without an intermediate copy. Returns std::nullopt if any page in the range is not plain
+     * memory (e.g. it is cached by the rasterizer or is MMIO), in which case Write must be used.
+     */
+    std::optional<std::vector<std::pair<u8*, u32>>> GetWritableBackingBlocks(std::size_t offset,
+                                                                             std::size_t size);
+
     std::size_t GetSize() const {
         return size;
     }
@@ -174,6 +191,11 @@ public:
         return session;
     }
 
+    /// Returns the kernel handling this request.
+    KernelSystem& GetKernel() const {
+        return kernel;
+    }
+
     using WakeupCallback = std::function<void(
         std::shared_ptr<Thread> thread, HLERequestContext& context, ThreadWakeupReason reason)>;
 
@@ -238,8 +260,17 @@ public:
     void ReportUnimplemented() const;
 
 private:
+    /// Returns a static buffer of the given size, reusing storage of finished requests if possible.
+    static std::vector<u8> AcquireStaticBuffer(std::size_t size);
+    /// Returns the storage of a static buffer to the pool.
+    static void ReleaseStaticBuffer(std::vector<u8>&& buffer);
+    /// Returns the name the translated bytes of this request are profiled under.
+    std::string GetProfilerName() const;
+
     KernelSystem& kernel;
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
+    // Header of the request, kept for profiling after cmd_buf has been overwritten by the reply.
+    u32 request_header = 0;
     std::shared_ptr<ServerSession> session;
     Thread* thread;
     // TODO(yuriks): Check common usage of this and optimize size accordingly
@@ -0,0 +1,143 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
+
+namespace IPCDebugger {
+
+namespace {
+std::size_t GetHistogramBucket(u64 ns) {
+    std::size_t bucket = 0;
+    for (u64 us = ns / 1000; us != 0 && bucket < NumHistogramBuckets - 1; us >>= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+void WriteReport(const std::string& report) {
+    const std::string filename =
+        fmt::format("{}/ipc_profile.txt", FileUtil::GetUserPath(FileUtil::UserPath::LogDir));
+    FileUtil::IOFile file(filename, "w");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Kernel, "Could not open {} for writing", filename);
+        return;
+    }
+    file.WriteString(report);
+}
+} // namespace
+
+Profiler::Profiler() = default;
+
+Profiler::~Profiler() {
+    std::unique_lock lock(mutex);
+    if (stats.empty()) {
+        return;
+    }
+    const std::string report = GetReportLocked();
+    lock.unlock();
+    WriteReport(report);
+}
+
+bool Profiler::IsEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetEnabled(bool enabled_) {
+    const bool was_enabled = enabled.exchange(enabled_, std::memory_order_relaxed);
+    if (was_enabled && !enabled_) {
+        Dump();
+    } else if (!was_enabled && enabled_) {
+        std::lock_guard lock(mutex);
+        last_dump = Clock::now();
+    }
+}
+
+void Profiler::RecordCall(const std::string& service_name, u32 header,
+                          const std::string& function_name, std::chrono::nanoseconds duration) {
+    const u64 ns = static_cast<u64>(duration.count());
+    const Clock::time_point now = Clock::now();
+
+    std::unique_lock lock(mutex);
+    CallStats& entry = stats[{service_name, header}];
+    if (entry.function_name.empty()) {
+        entry.function_name = function_name;
+    }
+    ++entry.calls;
+    entry.total_ns += ns;
+    entry.max_ns = std::max(entry.max_ns, ns);
+    ++entry.histogram[GetHistogramBucket(ns)];
+
+    if (now - last_dump < DumpInterval) {
+        return;
+    }
+    last_dump = now;
+    const std::string report = GetReportLocked();
+    lock.unlock();
+    WriteReport(report);
+}
+
+void Profiler::RecordTranslatedBytes(const std::string& service_name, u32 header,
+                                     std::size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    std::lock_guard lock(mutex);
+    stats[{service_name, header}].translated_bytes += bytes;
+}
+
+void Profiler::Reset() {
+    std::lock_guard lock(mutex);
+    stats.clear();
+}
+
+std::map<CallKey, CallStats> Profiler::GetStats() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+std::string Profiler::GetReport() const {
+    std::lock_guard lock(mutex);
+    return GetReportLocked();
+}
+
+void Profiler::Dump() const {
+    WriteReport(GetReport());
+}
+
+std::string Profiler::GetReportLocked() const {
+    std::vector<const std::pair<const CallKey, CallStats>*> sorted;
+    sorted.reserve(stats.size());
+    for (const auto& entry : stats) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+        return a->second.total_ns > b->second.total_ns;
+    });
+
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "{:<10} {:<10} {:<40} {:>10} {:>12} {:>10} {:>10} {:>12}  {}\n",
+                   "service", "header", "function", "calls", "total ms", "avg us", "max us",
+                   "bytes", "histogram (<1us, <2us, <4us, ...)");
+    for (const auto* entry : sorted) {
+        const auto& [key, call] = *entry;
+        const double avg_us =
+            call.calls == 0 ? 0.0 : static_cast<double>(call.total_ns) / call.calls / 1000.0;
+        fmt::format_to(buf, "{:<10} {:#010x} {:<40} {:>10} {:>12.3f} {:>10.2f} {:>10.2f} {:>12} ",
+                       key.first, key.second, call.function_name, call.calls,
+                       static_cast<double>(call.total_ns) / 1000000.0, avg_us,
+                       static_cast<double>(call.max_ns) / 1000.0, call.translated_bytes);
+        for (std::size_t i = 0; i < NumHistogramBuckets; ++i) {
+            fmt::format_to(buf, "{}{}", i == 0 ? " " : ",", call.histogram[i]);
+        }
+        buf.push_back('\n');
+    }
+    return fmt::to_string(buf);
+}
+
+} // namespace IPCDebugger
@@ -0,0 +1,101 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include "common/common_types.h"
+
+namespace IPCDebugger {
+
+/// Number of buckets in the host time histogram. Bucket 0 counts calls shorter than 1 us, bucket
+/// N counts calls that took [2^(N-1), 2^N) us and the last bucket counts everything longer.
+constexpr std::size_t NumHistogramBuckets = 16;
+
+/**
+ * Accumulated statistics of a single HLE service command.
+ */
+struct CallStats {
+    std::string function_name;
+    u64 calls = 0;
+    u64 total_ns = 0;
+    u64 max_ns = 0;
+    /// Bytes copied through static buffers and exposed through mapped buffers, both ways.
+    u64 translated_bytes = 0;
+    std::array<u64, NumHistogramBuckets> histogram{};
+};
+
+/// Service name and command header
+using CallKey = std::pair<std::string, u32>;
+
+/**
+ * Profiler of HLE service calls. It is always compiled in and costs a single atomic load per
+ * request while disabled.
+ */
+class Profiler {
+public:
+    explicit Profiler();
+    ~Profiler();
+
+    /**
+     * Returns whether the profiler is enabled.
+     */
+    bool IsEnabled() const;
+
+    /**
+     * Set the status of the profiler (enabled/disabled). Disabling it dumps the collected data.
+     */
+    void SetEnabled(bool enabled);
+
+    /**
+     * Records the host time spent handling a command.
+     */
+    void RecordCall(const std::string& service_name, u32 header, const std::string& function_name,
+                    std::chrono::nanoseconds duration);
+
+    /**
+     * Records bytes translated for a command's request or reply.
+     */
+    void RecordTranslatedBytes(const std::string& service_name, u32 header, std::size_t bytes);
+
+    /**
+     * Clears all collected data.
+     */
+    void Reset();
+
+    std::map<CallKey, CallStats> GetStats() const;
+
+    /**
+     * Returns a human readable report, sorted by total host time.
+     */
+    std::string GetReport() const;
+
+    /**
+     * Writes the report to ipc_profile.txt in the log directory.
+     */
+    void Dump() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Host time between two automatic dumps while the profiler is enabled
+    static constexpr std::chrono::seconds DumpInterval{10};
+
+    std::string GetReportLocked() const;
+
+    std::map<CallKey, CallStats> stats;
+    Clock::time_point last_dump = Clock::now();
+    mutable std::mutex mutex;
+
+    std::atomic_bool enabled{false};
+};
+
+} // namespace IPCDebugger
@@ -33,8 +33,9 @@ class Timing;
 }
 
 namespace IPCDebugger {
+class Profiler;
 class Recorder;
-}
+} // namespace IPCDebugger
 
 namespace Kernel {
 
@@ -229,6 +230,9 @@ public:
     IPCDebugger::Recorder& GetIPCRecorder();
     const IPCDebugger::Recorder& GetIPCRecorder() const;
 
+    IPCDebugger::Profiler& GetIPCProfiler();
+    const IPCDebugger::Profiler& GetIPCProfiler() const;
+
     MemoryRegionInfo* GetMemoryRegion(MemoryRegion region);
 
     void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping);
@@ -283,6 +287,7 @@ private:
     std::unique_ptr<SharedPage::Handler> shared_page_handler;
 
     std::unique_ptr<IPCDebugger::Recorder> ipc_recorder;
+    std::unique_ptr<IPCDebugger::Profiler> ipc_profiler;
 };
 
 } // namespace Kernel
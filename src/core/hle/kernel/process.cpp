@@ -7,6 +7,7 @@
 #include "common/assert.h"
 #include "common/common_funcs.h"
 #include "common/logging/log.h"
+#include "core/arm/arm_interface.h"
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
@@ -412,6 +413,9 @@ Kernel::Process::~Process() {
     handle_table.Clear();
 
     kernel.memory.UnregisterPageTable(&vm_manager.page_table);
+    if (kernel.current_cpu != nullptr) {
+        kernel.current_cpu->PageTableRemoved(&vm_manager.page_table);
+    }
 }
 
 std::shared_ptr<Process> KernelSystem::GetProcessById(u32 process_id) const {
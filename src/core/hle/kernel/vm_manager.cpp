@@ -44,24 +44,32 @@ VMManager::~VMManager() = default;
 
 void VMManager::Reset() {
     vma_map.clear();
+    vma_bases.clear();
+    vma_handles.clear();
 
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
     initial_vma.size = MAX_ADDRESS;
-    vma_map.emplace(initial_vma.base, initial_vma);
-
-    page_table.pointers.fill(nullptr);
-    page_table.attributes.fill(Memory::PageType::Unmapped);
+    last_hit = vma_map.emplace(initial_vma.base, initial_vma).first;
+    IndexInsert(last_hit);
 
+    // Unmapping the free region clears every page of the table
     UpdatePageTableForVMA(initial_vma);
 }
 
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS) {
         return vma_map.end();
-    } else {
-        return std::prev(vma_map.upper_bound(target));
     }
+
+    const VirtualMemoryArea& cached = last_hit->second;
+    if (target - cached.base < cached.size) {
+        return last_hit;
+    }
+
+    const auto next = std::upper_bound(vma_bases.begin(), vma_bases.end(), target);
+    last_hit = vma_handles[std::distance(vma_bases.begin(), next) - 1];
+    return last_hit;
 }
 
 ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, u8* memory,
@@ -158,9 +166,9 @@ ResultCode VMManager::ChangeMemoryState(VAddr target, u32 size, MemoryState expe
     CASCADE_RESULT(auto vma, CarveVMARange(target, size));
     ASSERT(vma->second.size == size);
 
+    // The page table does not hold permissions or states, so it stays as it is
     vma->second.permissions = new_perms;
     vma->second.meminfo_state = new_state;
-    UpdatePageTableForVMA(vma->second);
 
     MergeAdjacent(vma);
 
@@ -199,9 +207,8 @@ ResultCode VMManager::UnmapRange(VAddr target, u32 size) {
 VMManager::VMAHandle VMManager::Reprotect(VMAHandle vma_handle, VMAPermission new_perms) {
     VMAIter iter = StripIterConstness(vma_handle);
 
-    VirtualMemoryArea& vma = iter->second;
-    vma.permissions = new_perms;
-    UpdatePageTableForVMA(vma);
+    // The page table does not hold permissions, so it stays as it is
+    iter->second.permissions = new_perms;
 
     return MergeAdjacent(iter);
 }
@@ -329,13 +336,19 @@ VMManager::VMAIter VMManager::SplitVMA(VMAIter vma_handle, u32 offset_in_vma) {
 
     ASSERT(old_vma.CanBeMergedWith(new_vma));
 
-    return vma_map.emplace_hint(std::next(vma_handle), new_vma.base, new_vma);
+    const VMAIter result = vma_map.emplace_hint(std::next(vma_handle), new_vma.base, new_vma);
+    IndexInsert(result);
+    return result;
 }
 
 VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     const VMAIter next_vma = std::next(iter);
     if (next_vma != vma_map.end() && iter->second.CanBeMergedWith(next_vma->second)) {
         iter->second.size += next_vma->second.size;
+        if (last_hit == next_vma) {
+            last_hit = iter;
+        }
+        IndexErase(next_vma);
         vma_map.erase(next_vma);
     }
 
@@ -343,6 +356,10 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
         VMAIter prev_vma = std::prev(iter);
         if (prev_vma->second.CanBeMergedWith(iter->second)) {
             prev_vma->second.size += iter->second.size;
+            if (last_hit == iter) {
+                last_hit = prev_vma;
+            }
+            IndexErase(iter);
             vma_map.erase(iter);
             iter = prev_vma;
         }
@@ -351,6 +368,21 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     return iter;
 }
 
+void VMManager::IndexInsert(VMAHandle vma) {
+    const auto position = std::upper_bound(vma_bases.begin(), vma_bases.end(), vma->first);
+    const auto offset = std::distance(vma_bases.begin(), position);
+    vma_bases.insert(position, vma->first);
+    vma_handles.insert(vma_handles.begin() + offset, vma);
+}
+
+void VMManager::IndexErase(VMAHandle vma) {
+    const auto position = std::lower_bound(vma_bases.begin(), vma_bases.end(), vma->first);
+    ASSERT(position != vma_bases.end() && *position == vma->first);
+    const auto offset = std::distance(vma_bases.begin(), position);
+    vma_bases.erase(position);
+    vma_handles.erase(vma_handles.begin() + offset);
+}
+
 void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
     switch (vma.type) {
     case VMAType::Free:
@@ -365,13 +397,14 @@ void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
     }
 }
 
-ResultVal<std::vector<std::pair<u8*, u32>>> VMManager::GetBackingBlocksForRange(VAddr address,
-                                                                                u32 size) {
+ResultVal<std::vector<std::pair<u8*, u32>>> VMManager::GetBackingBlocksForRange(
+    VAddr address, u32 size) const {
     std::vector<std::pair<u8*, u32>> backing_blocks;
     VAddr interval_target = address;
-    while (interval_target != address + size) {
-        std::map<VAddr, Kernel::VirtualMemoryArea>::const_iterator vma = FindVMA(interval_target);
-        if (vma->second.type != VMAType::BackingMemory) {
+    // Consecutive intervals are in consecutive VMAs, so only the first one needs a lookup
+    std::map<VAddr, Kernel::VirtualMemoryArea>::const_iterator vma = FindVMA(interval_target);
+    for (; interval_target != address + size; ++vma) {
+        if (vma == vma_map.end() || vma->second.type != VMAType::BackingMemory) {
             LOG_ERROR(Kernel, "Trying to use already freed memory");
             return ERR_INVALID_ADDRESS_STATE;
         }
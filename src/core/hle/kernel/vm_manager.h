@@ -119,7 +119,11 @@ public:
     /// Clears the address space map, re-initializing with a single free area.
     void Reset();
 
-    /// Finds the VMA in which the given address is included in, or `vma_map.end()`.
+    /**
+     * Finds the VMA in which the given address is included in, or `vma_map.end()`. Repeated
+     * lookups in the same VMA are answered from a last-hit cache, others by a binary search of the
+     * flat VMA index.
+     */
     VMAHandle FindVMA(VAddr target) const;
 
     // TODO(yuriks): Should these functions actually return the handle?
@@ -186,7 +190,8 @@ public:
     void LogLayout(Log::Level log_level) const;
 
     /// Gets a list of backing memory blocks for the specified range
-    ResultVal<std::vector<std::pair<u8*, u32>>> GetBackingBlocksForRange(VAddr address, u32 size);
+    ResultVal<std::vector<std::pair<u8*, u32>>> GetBackingBlocksForRange(VAddr address,
+                                                                         u32 size) const;
 
     /// Each VMManager has its own page table, which is set as the main one when the owning process
     /// is scheduled.
@@ -228,6 +233,22 @@ private:
     /// Updates the pages corresponding to this VMA so they match the VMA's attributes.
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
+    /// Adds a VMA that was just inserted into vma_map to the flat index.
+    void IndexInsert(VMAHandle vma);
+
+    /// Removes a VMA that is about to be erased from vma_map from the flat index.
+    void IndexErase(VMAHandle vma);
+
     Memory::MemorySystem& memory;
+
+    /**
+     * Flat index of vma_map, kept in the same order. Searching the bases in contiguous memory is
+     * much faster than walking the tree, and the map iterators stay valid until the VMA is erased.
+     */
+    std::vector<VAddr> vma_bases;
+    std::vector<VMAHandle> vma_handles;
+
+    /// The VMA the last FindVMA call returned. Always points to a VMA in vma_map.
+    mutable VMAHandle last_hit;
 };
 } // namespace Kernel
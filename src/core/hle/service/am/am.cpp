@@ -6,8 +6,6 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
-#include <cryptopp/aes.h>
-#include <cryptopp/modes.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
 #include "common/logging/log.h"
@@ -30,6 +28,7 @@
 #include "core/hle/service/am/am_sys.h"
 #include "core/hle/service/am/am_u.h"
 #include "core/hle/service/fs/archive.h"
+#include "core/hw/aes/parallel.h"
 #include "core/loader/loader.h"
 #include "core/loader/smdh.h"
 
@@ -78,7 +77,11 @@ static_assert(sizeof(TicketInfo) == 0x18, "Ticket info structure size is wrong")
 
 class CIAFile::DecryptionState {
 public:
-    std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
+    HW::AES::AESKey title_key;
+    /// The IV each content continues decrypting from
+    std::vector<HW::AES::AESKey> content_iv;
+    /// Cipher text of each content's last partial block, completed by the next write
+    std::vector<std::vector<u8>> content_pending;
 };
 
 CIAFile::CIAFile(Service::FS::MediaType media_type)
@@ -133,11 +136,11 @@ ResultCode CIAFile::WriteTitleMetadata() {
     content_written.resize(content_count);
 
     if (auto title_key = container.GetTicket().GetTitleKey()) {
-        decryption_state->content.resize(content_count);
+        decryption_state->title_key = *title_key;
+        decryption_state->content_iv.resize(content_count);
+        decryption_state->content_pending.resize(content_count);
         for (std::size_t i = 0; i < content_count; ++i) {
-            const FileSys::TitleMetadata::CTR ctr = tmd.GetContentCTRByIndex(i);
-            decryption_state->content[i].SetKeyWithIV(title_key->data(), title_key->size(),
-                                                      ctr.data());
+            decryption_state->content_iv[i] = tmd.GetContentCTRByIndex(i);
         }
     }
 
@@ -175,19 +178,36 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
             if (!file.IsOpen())
                 return FileSys::ERROR_INSUFFICIENT_SPACE;
 
-            std::vector<u8> temp(buffer + (range_min - offset),
-                                 buffer + (range_min - offset) + available_to_write);
+            std::vector<u8> temp;
+            const u8* const content_data = buffer + (range_min - offset);
+
+            // Keep tabs on how much of this content ID has been written so new range_min
+            // values can be calculated.
+            content_written[i] += available_to_write;
 
             if (tmd.GetContentTypeByIndex(static_cast<u16>(i)) &
                 FileSys::TMDContentTypeFlag::Encrypted) {
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
+                // Writes can end in the middle of a cipher block. Its bytes are held back until the
+                // write that completes it, and only whole blocks are decrypted.
+                std::vector<u8>& pending = decryption_state->content_pending[i];
+                temp = std::move(pending);
+                pending.clear();
+                temp.insert(temp.end(), content_data, content_data + available_to_write);
+                const std::size_t decrypt_size =
+                    temp.size() / HW::AES::AES_BLOCK_SIZE * HW::AES::AES_BLOCK_SIZE;
+                if (content_written[i] < size) {
+                    pending.assign(temp.begin() + decrypt_size, temp.end());
+                    temp.resize(decrypt_size);
+                } else if (decrypt_size != temp.size()) {
+                    LOG_WARNING(Service_AM, "Content {} does not end on a cipher block", i);
+                }
+                HW::AES::DecryptCBC(decryption_state->title_key, decryption_state->content_iv[i],
+                                    temp.data(), decrypt_size);
+            } else {
+                temp.assign(content_data, content_data + available_to_write);
             }
 
             file.WriteBytes(temp.data(), temp.size());
-
-            // Keep tabs on how much of this content ID has been written so new range_min
-            // values can be calculated.
-            content_written[i] += available_to_write;
             LOG_DEBUG(Service_AM, "Wrote {:x} to content {}, total {:x}", available_to_write, i,
                       content_written[i]);
         }
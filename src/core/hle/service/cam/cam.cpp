@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include "common/bit_set.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -74,83 +75,69 @@ void Module::PortConfig::Clear() {
 
 void Module::CompletionEventCallBack(u64 port_id, s64) {
     PortConfig& port = ports[port_id];
-    const CameraConfig& camera = cameras[port.camera_id];
-    const std::vector<u16> buffer = port.capture_result.get();
+    {
+        std::unique_lock lock{capture_mutex};
+        capture_cv.wait(lock, [&port] { return !port.is_capture_pending; });
+    }
+
+    // The capture thread already applied the trimming, so the frame goes to the destination as
+    // one block
+    const std::size_t frame_bytes = port.frame_size * sizeof(u16);
+    if (port.dest_size != frame_bytes) {
+        LOG_ERROR(Service_CAM, "The destination size ({}) doesn't match the source ({})!",
+                  port.dest_size, frame_bytes);
+    }
+    system.Memory().WriteBlock(*port.dest_process, port.dest, port.frame.data(),
+                               std::min<std::size_t>(port.dest_size, frame_bytes));
+
+    port.is_receiving = false;
+    port.completion_event->Signal();
+}
+
+void Module::StartReceiving(int port_id) {
+    PortConfig& port = ports[port_id];
+    port.is_receiving = true;
 
+    CameraConfig& camera = cameras[port.camera_id];
+    const Resolution& resolution = camera.contexts[camera.current_context].resolution;
+    u32 trim_x = 0;
+    u32 trim_y = 0;
+    u32 trim_width = 0;
+    u32 trim_height = 0;
     if (port.is_trimming) {
-        u32 trim_width;
-        u32 trim_height;
-        const int original_width = camera.contexts[camera.current_context].resolution.width;
-        const int original_height = camera.contexts[camera.current_context].resolution.height;
-        if (port.x1 <= port.x0 || port.y1 <= port.y0 || port.x1 > original_width ||
-            port.y1 > original_height) {
+        if (port.x1 <= port.x0 || port.y1 <= port.y0 || port.x1 > resolution.width ||
+            port.y1 > resolution.height) {
             LOG_ERROR(Service_CAM, "Invalid trimming coordinates x0={}, y0={}, x1={}, y1={}",
                       port.x0, port.y0, port.x1, port.y1);
-            trim_width = 0;
-            trim_height = 0;
         } else {
+            trim_x = port.x0;
+            trim_y = port.y0;
             trim_width = port.x1 - port.x0;
             trim_height = port.y1 - port.y0;
         }
 
-        u32 trim_size = (port.x1 - port.x0) * (port.y1 - port.y0) * 2;
+        const u32 trim_size = (port.x1 - port.x0) * (port.y1 - port.y0) * 2;
         if (port.dest_size != trim_size) {
             LOG_ERROR(Service_CAM, "The destination size ({}) doesn't match the source ({})!",
                       port.dest_size, trim_size);
         }
-
-        const u32 src_offset = port.y0 * original_width + port.x0;
-        const u16* src_ptr = buffer.data() + src_offset;
-        // Note: src_size_left is int because it can be negative if the buffer size doesn't match.
-        int src_size_left = static_cast<int>((buffer.size() - src_offset) * sizeof(u16));
-        VAddr dest_ptr = port.dest;
-        // Note: dest_size_left and line_bytes are int to match the type of src_size_left.
-        int dest_size_left = static_cast<int>(port.dest_size);
-        const int line_bytes = static_cast<int>(trim_width * sizeof(u16));
-
-        for (u32 y = 0; y < trim_height; ++y) {
-            int copy_length = std::min({line_bytes, dest_size_left, src_size_left});
-            if (copy_length <= 0) {
-                break;
-            }
-            system.Memory().WriteBlock(*port.dest_process, dest_ptr, src_ptr, copy_length);
-            dest_ptr += copy_length;
-            dest_size_left -= copy_length;
-            src_ptr += original_width;
-            src_size_left -= original_width * sizeof(u16);
-        }
-    } else {
-        std::size_t buffer_size = buffer.size() * sizeof(u16);
-        if (port.dest_size != buffer_size) {
-            LOG_ERROR(Service_CAM, "The destination size ({}) doesn't match the source ({})!",
-                      port.dest_size, buffer_size);
-        }
-        system.Memory().WriteBlock(*port.dest_process, port.dest, buffer.data(),
-                                   std::min<std::size_t>(port.dest_size, buffer_size));
     }
 
-    port.is_receiving = false;
-    port.completion_event->Signal();
-}
-
-void Module::StartReceiving(int port_id) {
-    PortConfig& port = ports[port_id];
-    port.is_receiving = true;
-
-    // launches a capture task asynchronously
-    CameraConfig& camera = cameras[port.camera_id];
-    port.capture_result = std::async(std::launch::async, [&camera, &port, this] {
-        if (is_camera_reload_pending.exchange(false)) {
-            // reinitialize the camera according to new settings
-            camera.impl->StopCapture();
-            LoadCameraImplementation(camera, port.camera_id);
-            camera.impl->StartCapture();
-        }
-        return camera.impl->ReceiveFrame();
-    });
+    // hands the capture to the capture thread
+    {
+        std::lock_guard lock{capture_mutex};
+        port.capture_camera_id = port.camera_id;
+        port.capture_width = port.is_trimming ? resolution.width : 0;
+        port.trim_x = trim_x;
+        port.trim_y = trim_y;
+        port.trim_width = trim_width;
+        port.trim_height = trim_height;
+        port.is_capture_pending = true;
+    }
+    capture_cv.notify_all();
 
     // schedules a completion event according to the frame rate. The event will block on the
-    // capture task if it is not finished within the expected time
+    // capture thread if the frame is not received within the expected time
     system.CoreTiming().ScheduleEvent(
         msToCycles(LATENCY_BY_FRAME_RATE[static_cast<int>(camera.frame_rate)]),
         completion_event_callback, port_id);
@@ -161,10 +148,71 @@ void Module::CancelReceiving(int port_id) {
         return;
     LOG_WARNING(Service_CAM, "tries to cancel an ongoing receiving process.");
     system.CoreTiming().UnscheduleEvent(completion_event_callback, port_id);
-    ports[port_id].capture_result.wait();
+    {
+        std::unique_lock lock{capture_mutex};
+        capture_cv.wait(lock, [this, port_id] { return !ports[port_id].is_capture_pending; });
+    }
     ports[port_id].is_receiving = false;
 }
 
+void Module::CaptureThreadLoop() {
+    std::unique_lock lock{capture_mutex};
+    while (true) {
+        capture_cv.wait(lock, [this] {
+            return is_capture_thread_stopping ||
+                   std::any_of(ports.begin(), ports.end(),
+                               [](const PortConfig& port) { return port.is_capture_pending; });
+        });
+        if (is_capture_thread_stopping) {
+            return;
+        }
+        for (std::size_t port_id = 0; port_id < ports.size(); ++port_id) {
+            if (!ports[port_id].is_capture_pending) {
+                continue;
+            }
+            // The emulation thread doesn't touch the frame while the capture is pending
+            lock.unlock();
+            CaptureFrame(static_cast<int>(port_id));
+            lock.lock();
+            ports[port_id].is_capture_pending = false;
+            capture_cv.notify_all();
+        }
+    }
+}
+
+void Module::CaptureFrame(int port_id) {
+    PortConfig& port = ports[port_id];
+    CameraConfig& camera = cameras[port.capture_camera_id];
+    if (is_camera_reload_pending.exchange(false)) {
+        // reinitialize the camera according to new settings
+        camera.impl->StopCapture();
+        LoadCameraImplementation(camera, port.capture_camera_id);
+        camera.impl->StartCapture();
+    }
+    camera.impl->ReceiveFrameInto(port.frame);
+
+    if (port.capture_width == 0) {
+        port.frame_size = port.frame.size();
+        return;
+    }
+
+    // Moves the trimmed lines to the front of the frame. Each line moves to a lower address than
+    // it came from, so the lines that are still to be moved are never overwritten.
+    std::size_t size = 0;
+    for (u32 y = 0; y < port.trim_height; ++y) {
+        const std::size_t src_offset = (port.trim_y + y) * port.capture_width + port.trim_x;
+        if (src_offset >= port.frame.size()) {
+            break;
+        }
+        const std::size_t length =
+            std::min<std::size_t>(port.trim_width, port.frame.size() - src_offset);
+        std::memmove(port.frame.data() + size, port.frame.data() + src_offset,
+                     length * sizeof(u16));
+        size += length;
+    }
+    port.frame_size = size;
+}
+
 void Module::ActivatePort(int port_id, int camera_id) {
     if (ports[port_id].is_busy && ports[port_id].camera_id != camera_id) {
         CancelReceiving(port_id);
@@ -1032,11 +1080,18 @@ Module::Module(Core::System& system) : system(system) {
     completion_event_callback = system.CoreTiming().RegisterEvent(
         "CAM::CompletionEventCallBack",
         [this](u64 userdata, s64 cycles_late) { CompletionEventCallBack(userdata, cycles_late); });
+    capture_thread = std::thread([this] { CaptureThreadLoop(); });
 }
 
 Module::~Module() {
     CancelReceiving(0);
     CancelReceiving(1);
+    {
+        std::lock_guard lock{capture_mutex};
+        is_capture_thread_stopping = true;
+    }
+    capture_cv.notify_all();
+    capture_thread.join();
 }
 
 void Module::ReloadCameraDevices() {
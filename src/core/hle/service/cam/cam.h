@@ -5,8 +5,11 @@
 #pragma once
 
 #include <array>
-#include <future>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
@@ -730,6 +733,13 @@ private:
     // Activates the specified port with the specfied camera.
     void ActivatePort(int port_id, int camera_id);
 
+    // Runs on the capture thread, receiving frames for the ports that requested one.
+    void CaptureThreadLoop();
+
+    // Receives a frame for the specified port into its frame buffer and trims it. Called on the
+    // capture thread.
+    void CaptureFrame(int port_id);
+
     template <typename PackageParameterType>
     ResultCode SetPackageParameter(const PackageParameterType& package);
 
@@ -773,7 +783,19 @@ private:
         std::shared_ptr<Kernel::Event> buffer_error_interrupt_event;
         std::shared_ptr<Kernel::Event> vsync_interrupt_event;
 
-        std::future<std::vector<u16>> capture_result; // will hold the received frame.
+        // The following are shared with the capture thread and guarded by capture_mutex.
+        bool is_capture_pending{false}; // set until the capture thread has received the frame.
+        int capture_camera_id{0};
+        // Trimming applied to the received frame. The rectangle is empty if trimming is disabled.
+        u32 capture_width{0};
+        u32 trim_x{0};
+        u32 trim_y{0};
+        u32 trim_width{0};
+        u32 trim_height{0};
+        // Holds the received frame. Reused between frames to avoid allocating at the frame rate.
+        std::vector<u16> frame;
+        std::size_t frame_size{0}; // number of pixels of the frame after trimming
+
         Kernel::Process* dest_process{nullptr};
         VAddr dest{0};    // the destination address of the receiving process
         u32 dest_size{0}; // the destination size of the receiving process
@@ -788,6 +810,12 @@ private:
     std::array<PortConfig, 2> ports;
     Core::TimingEventType* completion_event_callback;
     std::atomic<bool> is_camera_reload_pending{false};
+
+    std::thread capture_thread;
+    std::mutex capture_mutex;
+    // Notified when a port requests a frame, when a frame is received and on shutdown.
+    std::condition_variable capture_cv;
+    bool is_capture_thread_stopping{false};
 };
 
 std::shared_ptr<Module> GetModule(Core::System& system);
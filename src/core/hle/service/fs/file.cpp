@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "common/logging/log.h"
+#include "common/thread_pool.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/file_backend.h"
@@ -15,6 +16,32 @@
 
 namespace Service::FS {
 
+/// Reads at least this large are performed on the I/O worker during the emulated read delay.
+constexpr u32 AsyncReadThreshold = 0x4000;
+
+static Common::ThreadPool& GetIOPool() {
+    static Common::ThreadPool io_pool(1);
+    return io_pool;
+}
+
+/// Reads from the backend straight into the given host memory blocks, stopping at the first short
+/// read.
+static ResultVal<std::size_t> ReadIntoBlocks(FileSys::FileBackend& backend, u64 offset,
+                                             const std::vector<std::pair<u8*, u32>>& blocks) {
+    std::size_t total_read = 0;
+    for (const auto& [block, block_size] : blocks) {
+        ResultVal<std::size_t> read = backend.Read(offset + total_read, block_size, block);
+        if (read.Failed()) {
+            return read;
+        }
+        total_read += *read;
+        if (*read != block_size) {
+            break;
+        }
+    }
+    return MakeResult(total_read);
+}
+
 File::File(Core::System& system, std::unique_ptr<FileSys::FileBackend>&& backend,
            const FileSys::Path& path)
     : ServiceFramework("", 1), path(path), backend(std::move(backend)), system(system) {
@@ -33,6 +60,17 @@ File::File(Core::System& system, std::unique_ptr<FileSys::FileBackend>&& backend
     RegisterHandlers(functions);
 }
 
+File::~File() {
+    WaitForPendingRead();
+}
+
+void File::WaitForPendingRead() {
+    if (pending_read.valid()) {
+        pending_read.wait();
+        pending_read = {};
+    }
+}
+
 void File::Read(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x0802, 3, 2);
     u64 offset = rp.Pop<u64>();
@@ -50,27 +88,72 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
 
+    WaitForPendingRead();
+
     if (offset + length > backend->GetSize()) {
         LOG_ERROR(Service_FS,
                   "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
                   offset, length, backend->GetSize());
     }
 
+    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+
+    std::optional<std::vector<std::pair<u8*, u32>>> backing_blocks;
+    if (length <= buffer.GetSize()) {
+        backing_blocks = buffer.GetWritableBackingBlocks(0, length);
+    }
+
+    if (backing_blocks && length >= AsyncReadThreshold && read_timeout_ns.count() > 0) {
+        // Read straight into guest memory on the I/O worker while the client thread sleeps for
+        // the emulated delay, and only build the response once it wakes up.
+        auto read = std::make_shared<ResultVal<std::size_t>>();
+        pending_read = GetIOPool()
+                           .Push([backend = backend.get(), offset,
+                                  blocks = std::move(*backing_blocks), read] {
+                               *read = ReadIntoBlocks(*backend, offset, blocks);
+                           })
+                           .share();
+        ctx.SleepClientThread(
+            "file::read", read_timeout_ns,
+            [pending_read = pending_read, read,
+             buffer](std::shared_ptr<Kernel::Thread> /*thread*/, Kernel::HLERequestContext& ctx,
+                     Kernel::ThreadWakeupReason /*reason*/) {
+                pending_read.wait();
+                IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
+                if (read->Failed()) {
+                    rb.Push(read->Code());
+                    rb.Push<u32>(0);
+                } else {
+                    rb.Push(RESULT_SUCCESS);
+                    rb.Push<u32>(static_cast<u32>(**read));
+                }
+                rb.PushMappedBuffer(buffer);
+            });
+        return;
+    }
+
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
 
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
+    ResultVal<std::size_t> read;
+    if (backing_blocks) {
+        read = ReadIntoBlocks(*backend, offset, *backing_blocks);
+    } else {
+        std::vector<u8> data(length);
+        read = backend->Read(offset, data.size(), data.data());
+        if (read.Succeeded()) {
+            buffer.Write(data.data(), 0, *read);
+        }
+    }
+
     if (read.Failed()) {
         rb.Push(read.Code());
         rb.Push<u32>(0);
     } else {
-        buffer.Write(data.data(), 0, *read);
         rb.Push(RESULT_SUCCESS);
         rb.Push<u32>(static_cast<u32>(*read));
     }
     rb.PushMappedBuffer(buffer);
 
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
     ctx.SleepClientThread("file::read", read_timeout_ns,
                           [](std::shared_ptr<Kernel::Thread> /*thread*/,
                              Kernel::HLERequestContext& /*ctx*/,
@@ -100,6 +183,8 @@ void File::Write(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingRead();
+
     std::vector<u8> data(length);
     buffer.Read(data.data(), 0, data.size());
     ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
@@ -137,6 +222,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingRead();
     file->size = size;
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
@@ -150,6 +236,7 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
 
+    WaitForPendingRead();
     backend->Close();
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -168,6 +255,7 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingRead();
     backend->Flush();
     rb.Push(RESULT_SUCCESS);
 }
@@ -205,6 +293,7 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
 
     slot->priority = original_file->priority;
     slot->offset = 0;
+    WaitForPendingRead();
     slot->size = backend->GetSize();
     slot->subfile = false;
 
@@ -263,6 +352,7 @@ std::shared_ptr<Kernel::ClientSession> File::Connect() {
     FileSessionSlot* slot = GetSessionData(server);
     slot->priority = 0;
     slot->offset = 0;
+    WaitForPendingRead();
     slot->size = backend->GetSize();
     slot->subfile = false;
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <future>
 #include <memory>
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/service/service.h"
@@ -27,7 +28,7 @@ class File final : public ServiceFramework<File, FileSessionSlot> {
 public:
     File(Core::System& system, std::unique_ptr<FileSys::FileBackend>&& backend,
          const FileSys::Path& path);
-    ~File() = default;
+    ~File();
 
     std::string GetName() const {
         return "Path: " + path.DebugStr();
@@ -59,7 +60,13 @@ private:
     void OpenLinkFile(Kernel::HLERequestContext& ctx);
     void OpenSubFile(Kernel::HLERequestContext& ctx);
 
+    /// Blocks until the in-flight asynchronous read (if any) has finished using the backend.
+    void WaitForPendingRead();
+
     Core::System& system;
+
+    /// Host read into guest memory that is running on the I/O worker while the client sleeps.
+    std::shared_future<void> pending_read;
 };
 
 } // namespace Service::FS
@@ -7,12 +7,18 @@
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/service/gsp/gsp.h"
+#include "core/hw/gpu.h"
 
 namespace Service::GSP {
 
 static std::weak_ptr<GSP_GPU> gsp_gpu;
 
 void SignalInterrupt(InterruptId interrupt_id) {
+    // Interrupts raised on the GPU thread are delivered later, on the emulation thread.
+    if (GPU::DeferInterrupt(interrupt_id)) {
+        return;
+    }
+
     std::shared_ptr<Service::GSP::GSP_GPU> gpu = gsp_gpu.lock();
     ASSERT(gpu != nullptr);
     return gpu->SignalInterrupt(interrupt_id);
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include "common/logging/log.h"
 #include "core/3ds.h"
@@ -79,6 +80,9 @@ void Module::UpdatePadCallback(u64 userdata, s64 cycles_late) {
     if (is_device_reload_pending.exchange(false))
         LoadInputDevices();
 
+    // Read every device from one snapshot of the host input state
+    Input::BeginPoll();
+
     using namespace Settings::NativeButton;
     state.a.Assign(buttons[A - BUTTON_HID_BEGIN]->GetStatus());
     state.b.Assign(buttons[B - BUTTON_HID_BEGIN]->GetStatus());
@@ -131,6 +135,20 @@ void Module::UpdatePadCallback(u64 userdata, s64 cycles_late) {
     pad_entry.circle_pad_x = circle_pad_x;
     pad_entry.circle_pad_y = circle_pad_y;
 
+    if (changed.hex != 0) {
+        const s64 event_time = Input::GetLastInputEventTime();
+        if (event_time != 0 && event_time != last_measured_input_event) {
+            const s64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count();
+            const s64 latency = now - event_time;
+            ++input_latency_stats.samples;
+            input_latency_stats.total_ns += latency;
+            input_latency_stats.max_ns = std::max(input_latency_stats.max_ns, latency);
+            last_measured_input_event = event_time;
+        }
+    }
+
     // If we just updated index 0, provide a new timestamp
     if (mem->pad.index == 0) {
         mem->pad.index_reset_ticks_previous = mem->pad.index_reset_ticks;
@@ -402,6 +420,14 @@ Module::Module(Core::System& system) : system(system) {
     timing.ScheduleEvent(pad_update_ticks, pad_update_event);
 }
 
+Module::~Module() {
+    if (input_latency_stats.samples != 0) {
+        LOG_INFO(Service_HID, "Input latency: average {} us, max {} us over {} changes",
+                 input_latency_stats.total_ns / input_latency_stats.samples / 1000,
+                 input_latency_stats.max_ns / 1000, input_latency_stats.samples);
+    }
+}
+
 void Module::ReloadInputDevices() {
     is_device_reload_pending.store(true);
 }
@@ -410,6 +436,10 @@ const PadState& Module::GetState() const {
     return state;
 }
 
+const InputLatencyStats& Module::GetInputLatencyStats() const {
+    return input_latency_stats;
+}
+
 std::shared_ptr<Module> GetModule(Core::System& system) {
     std::shared_ptr<Service::HID::Module::Interface> hid =
         system.ServiceManager().GetService<Service::HID::Module::Interface>("hid:USER");
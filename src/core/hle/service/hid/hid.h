@@ -201,9 +201,17 @@ struct DirectionState {
 /// Translates analog stick axes to directions. This is exposed for ir_rst module to use.
 DirectionState GetStickDirectionState(s16 circle_pad_x, s16 circle_pad_y);
 
+/// Time from the host reporting an input event until the pad state it changed reached HID
+struct InputLatencyStats {
+    u64 samples = 0;
+    s64 total_ns = 0;
+    s64 max_ns = 0;
+};
+
 class Module final {
 public:
     explicit Module(Core::System& system);
+    ~Module();
 
     class Interface : public ServiceFramework<Interface> {
     public:
@@ -302,6 +310,8 @@ public:
 
     const PadState& GetState() const;
 
+    const InputLatencyStats& GetInputLatencyStats() const;
+
 private:
     void LoadInputDevices();
     void UpdatePadCallback(u64 userdata, s64 cycles_late);
@@ -342,6 +352,10 @@ private:
     std::unique_ptr<Input::AnalogDevice> circle_pad;
     std::unique_ptr<Input::MotionDevice> motion_device;
     std::unique_ptr<Input::TouchDevice> touch_device;
+
+    InputLatencyStats input_latency_stats;
+    /// Time of the last input event that was counted in input_latency_stats
+    s64 last_measured_input_event = 0;
 };
 
 std::shared_ptr<Module> GetModule(Core::System& system);
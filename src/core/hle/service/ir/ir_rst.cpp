@@ -54,6 +54,8 @@ void IR_RST::UpdateCallback(u64 userdata, s64 cycles_late) {
     if (is_device_reload_pending.exchange(false))
         LoadInputDevices();
 
+    Input::BeginPoll();
+
     PadState state;
     state.zl.Assign(zl_button->GetStatus());
     state.zr.Assign(zr_button->GetStatus());
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -10,6 +11,7 @@
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_port.h"
 #include "core/hle/kernel/server_session.h"
@@ -180,7 +182,17 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
+
+    IPCDebugger::Profiler& profiler = context.GetKernel().GetIPCProfiler();
+    if (!profiler.IsEnabled()) {
+        handler_invoker(this, info->handler_callback, context);
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
     handler_invoker(this, info->handler_callback, context);
+    profiler.RecordCall(service_name, header_code, info->name,
+                        std::chrono::steady_clock::now() - start);
 }
 
 std::string ServiceFrameworkBase::GetFunctionName(u32 header) const {
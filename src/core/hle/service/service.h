@@ -64,6 +64,11 @@ public:
 
     void HandleSyncRequest(Kernel::HLERequestContext& context) override;
 
+    /// Profiles requests under the service name, the same key the calls themselves are timed under.
+    std::string GetProfilerName() const override {
+        return service_name;
+    }
+
     /// Retrieves name of a function based on the header code. For IPC Recorder.
     std::string GetFunctionName(u32 header) const;
 
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <cryptopp/aes.h>
@@ -444,7 +445,10 @@ void LoadPresetKeys() {
 } // namespace
 
 void InitKeys() {
+    // The game list initializes the keys from its worker thread while the UI may start a game
+    static std::mutex init_mutex;
     static bool initialized = false;
+    std::lock_guard lock(init_mutex);
     if (initialized) {
         return;
     }
@@ -0,0 +1,110 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/assert.h"
+#include "common/thread_pool.h"
+#include "core/hw/aes/parallel.h"
+
+namespace HW::AES {
+
+namespace {
+/// Pieces are at least this large, so that small reads stay on the calling thread
+constexpr std::size_t MinPieceSize = 0x100000;
+
+/// Crypto++ picks the AES-NI implementation by itself where the host supports it, so the workers
+/// only have to split the work.
+struct CryptoPool {
+    CryptoPool() : pool(std::max(1U, std::thread::hardware_concurrency())) {}
+
+    Common::ThreadPool pool;
+    /// The pool's queues have a single producer, so concurrent loads take turns
+    std::mutex mutex;
+};
+
+CryptoPool& GetCryptoPool() {
+    static CryptoPool crypto_pool;
+    return crypto_pool;
+}
+
+/// Returns the size of the pieces to split size bytes into, a multiple of AES_BLOCK_SIZE.
+std::size_t GetPieceSize(std::size_t size) {
+    const std::size_t max_pieces = GetCryptoPool().pool.TotalThreads() + 1;
+    const std::size_t pieces = std::clamp<std::size_t>(size / MinPieceSize, 1, max_pieces);
+    if (pieces == 1) {
+        return size;
+    }
+    return (size / pieces + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+}
+
+/// Calls process(begin, end) for consecutive pieces of [0, size), on the pool and the calling
+/// thread.
+template <typename Process>
+void ForEachPiece(std::size_t size, std::size_t piece_size, Process&& process) {
+    if (piece_size >= size) {
+        process(0, size);
+        return;
+    }
+
+    CryptoPool& crypto_pool = GetCryptoPool();
+    std::vector<std::future<void>> futures;
+    {
+        std::lock_guard lock(crypto_pool.mutex);
+        for (std::size_t begin = piece_size; begin < size; begin += piece_size) {
+            futures.push_back(
+                crypto_pool.pool.Push(process, begin, std::min(begin + piece_size, size)));
+        }
+    }
+    process(0, piece_size);
+    for (std::future<void>& future : futures) {
+        future.get();
+    }
+}
+} // Anonymous namespace
+
+void TransformCTR(const AESKey& key, const AESKey& ctr, u64 offset, u8* data, std::size_t size) {
+    if (size == 0) {
+        return; // Crypto++ does not like zero size buffer
+    }
+
+    ForEachPiece(size, GetPieceSize(size), [&](std::size_t begin, std::size_t end) {
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
+        d.Seek(offset + begin);
+        d.ProcessData(data + begin, data + begin, end - begin);
+    });
+}
+
+void DecryptCBC(const AESKey& key, AESKey& iv, u8* data, std::size_t size) {
+    ASSERT_MSG(size % AES_BLOCK_SIZE == 0, "CBC data is not block aligned");
+    if (size == 0) {
+        return;
+    }
+
+    // Decrypting in place overwrites the cipher text each piece starts from, so remember the block
+    // before every piece first
+    const std::size_t piece_size = GetPieceSize(size);
+    std::vector<AESKey> piece_ivs{iv};
+    for (std::size_t begin = piece_size; begin < size; begin += piece_size) {
+        std::memcpy(piece_ivs.emplace_back().data(), data + begin - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+    }
+    AESKey next_iv;
+    std::memcpy(next_iv.data(), data + size - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+
+    ForEachPiece(size, piece_size, [&](std::size_t begin, std::size_t end) {
+        const AESKey& piece_iv = piece_ivs[begin / piece_size];
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), piece_iv.data());
+        d.ProcessData(data + begin, data + begin, end - begin);
+    });
+
+    iv = next_iv;
+}
+
+} // namespace HW::AES
@@ -0,0 +1,31 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+#include "core/hw/aes/key.h"
+
+namespace HW::AES {
+
+/**
+ * Encrypts or decrypts data in place with AES-CTR. Large buffers are split into pieces that are
+ * processed on worker threads, each seeking the keystream to its own offset.
+ * @param key The normal key
+ * @param ctr The initial counter of the stream
+ * @param offset Position of data in the stream, in bytes
+ */
+void TransformCTR(const AESKey& key, const AESKey& ctr, u64 offset, u8* data, std::size_t size);
+
+/**
+ * Decrypts data in place with AES-CBC. Large buffers are split on block boundaries and processed
+ * on worker threads, each starting from the cipher text block before its piece.
+ * @param iv The IV for the first block. Updated to the last cipher text block, so that consecutive
+ * calls continue the same stream.
+ * @param size Size of data, must be a multiple of AES_BLOCK_SIZE
+ */
+void DecryptCBC(const AESKey& key, AESKey& iv, u8* data, std::size_t size);
+
+} // namespace HW::AES
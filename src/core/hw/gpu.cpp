@@ -3,8 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/common_types.h"
@@ -14,6 +19,7 @@
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hw/gpu.h"
+#include "core/hw/gpu_thread.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
 #include "core/settings.h"
@@ -32,6 +38,45 @@ Memory::MemorySystem* g_memory;
 
 /// Event id for CoreTiming
 static Core::TimingEventType* vblank_event;
+/// Event id for delivering the results of work run on the GPU thread
+static Core::TimingEventType* gpu_poll_event;
+static bool gpu_poll_scheduled = false;
+
+/**
+ * Interval at which finished GPU thread work is picked up while the emulated CPU keeps running.
+ * Polling never waits, it only bounds how late the interrupt of a finished command is seen. Each
+ * poll is an atomic load, so polling 4000 times per emulated second costs nothing measurable.
+ * Nothing waits for the GPU thread until the CPU idles, touches memory the queued work uses,
+ * reads the registers of a busy unit or a frame is presented.
+ */
+constexpr u64 GPU_THREAD_POLL_CYCLES = BASE_CLOCK_RATE_ARM11 / 4000;
+
+static std::unique_ptr<GPUThread> gpu_thread;
+/// Interrupt raised on the GPU thread, delivered once the command that raised it has finished
+struct DeferredInterrupt {
+    Service::GSP::InterruptId id;
+    u64 fence;
+};
+static std::mutex deferred_interrupts_mutex;
+static std::deque<DeferredInterrupt> deferred_interrupts;
+
+/// Fences of the latest queued work of each unit, 0 once its completion has been reported
+static std::array<u64, 2> memory_fill_fences{};
+static u64 display_transfer_fence = 0;
+static u64 command_list_fence = 0;
+
+/// Physical range that queued work reads or writes, fenced until the work has run
+struct FencedRange {
+    PAddr start;
+    u32 size;
+    u64 fence;
+};
+/// Fenced ranges in submission order
+static std::deque<FencedRange> fenced_ranges;
+/// Number of fenced ranges covering each physical page
+static std::unordered_map<PAddr, u32> fenced_pages;
+
+static u64 ReleaseCompletedWork();
 
 template <typename T>
 inline void Read(T& var, const u32 raw_addr) {
@@ -44,6 +89,9 @@ inline void Read(T& var, const u32 raw_addr) {
         return;
     }
 
+    // The trigger and "finished" bits of units with queued work change once it has run
+    ReleaseCompletedWork();
+
     var = g_regs[addr / 4];
 }
 
@@ -123,6 +171,45 @@ static void MemoryFill(const Regs::MemoryFillConfig& config) {
     }
 }
 
+/// Sizes of the memory read and written by a display transfer or a texture copy
+struct TransferSizes {
+    u32 input = 0;
+    u32 output = 0;
+};
+
+static TransferSizes GetTransferSizes(const Regs::DisplayTransferConfig& config) {
+    TransferSizes sizes;
+    if (config.is_texture_copy) {
+        const u32 size = config.texture_copy.size;
+        const u32 input_gap = config.texture_copy.input_gap * 16;
+        const u32 output_gap = config.texture_copy.output_gap * 16;
+
+        // Zero gap means contiguous input/output even if width = 0
+        const u32 aligned_size = Common::AlignDown(size, 16);
+        const u32 input_width =
+            input_gap == 0 ? aligned_size : config.texture_copy.input_width * 16;
+        const u32 output_width =
+            output_gap == 0 ? aligned_size : config.texture_copy.output_width * 16;
+
+        if (input_width != 0) {
+            sizes.input = size / input_width * (input_width + input_gap);
+        }
+        if (output_width != 0) {
+            sizes.output = size / output_width * (output_width + output_gap);
+        }
+        return sizes;
+    }
+
+    const int horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
+    const int vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
+    sizes.input =
+        config.input_width * config.input_height * GPU::Regs::BytesPerPixel(config.input_format);
+    sizes.output = (config.output_width >> horizontal_scale) *
+                   (config.output_height >> vertical_scale) *
+                   GPU::Regs::BytesPerPixel(config.output_format);
+    return sizes;
+}
+
 static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     const PAddr src_addr = config.GetPhysicalInputAddress();
     const PAddr dst_addr = config.GetPhysicalOutputAddress();
@@ -183,12 +270,9 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     u32 output_width = config.output_width >> horizontal_scale;
     u32 output_height = config.output_height >> vertical_scale;
 
-    u32 input_size =
-        config.input_width * config.input_height * GPU::Regs::BytesPerPixel(config.input_format);
-    u32 output_size = output_width * output_height * GPU::Regs::BytesPerPixel(config.output_format);
-
-    Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), input_size);
-    Memory::RasterizerInvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
+    const TransferSizes sizes = GetTransferSizes(config);
+    Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), sizes.input);
+    Memory::RasterizerInvalidateRegion(config.GetPhysicalOutputAddress(), sizes.output);
 
     for (u32 y = 0; y < output_height; ++y) {
         for (u32 x = 0; x < output_width; ++x) {
@@ -345,17 +429,13 @@ static void TextureCopy(const Regs::DisplayTransferConfig& config) {
         return;
     }
 
-    std::size_t contiguous_input_size =
-        config.texture_copy.size / input_width * (input_width + input_gap);
-    Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(),
-                                  static_cast<u32>(contiguous_input_size));
+    const TransferSizes sizes = GetTransferSizes(config);
+    Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), sizes.input);
 
-    std::size_t contiguous_output_size =
-        config.texture_copy.size / output_width * (output_width + output_gap);
     // Only need to flush output if it has a gap
     const auto FlushInvalidate_fn = (output_gap != 0) ? Memory::RasterizerFlushAndInvalidateRegion
                                                       : Memory::RasterizerInvalidateRegion;
-    FlushInvalidate_fn(config.GetPhysicalOutputAddress(), static_cast<u32>(contiguous_output_size));
+    FlushInvalidate_fn(config.GetPhysicalOutputAddress(), sizes.output);
 
     u32 remaining_input = input_width;
     u32 remaining_output = output_width;
@@ -381,6 +461,216 @@ static void TextureCopy(const Regs::DisplayTransferConfig& config) {
     }
 }
 
+static void RunMemoryFill(const Regs::MemoryFillConfig& config, bool is_second_filler) {
+    MemoryFill(config);
+    LOG_TRACE(HW_GPU, "MemoryFill from {:#010X} to {:#010X}", config.GetStartAddress(),
+              config.GetEndAddress());
+
+    // It seems that it won't signal interrupt if "address_start" is zero.
+    // TODO: hwtest this
+    if (config.GetStartAddress() != 0) {
+        if (!is_second_filler) {
+            Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC0);
+        } else {
+            Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC1);
+        }
+    }
+}
+
+static void RunDisplayTransfer(const Regs::DisplayTransferConfig& config) {
+    if (Pica::g_debug_context)
+        Pica::g_debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer,
+                                       nullptr);
+
+    if (config.is_texture_copy) {
+        TextureCopy(config);
+        LOG_TRACE(HW_GPU,
+                  "TextureCopy: {:#X} bytes from {:#010X}({}+{})-> "
+                  "{:#010X}({}+{}), flags {:#010X}",
+                  config.texture_copy.size, config.GetPhysicalInputAddress(),
+                  config.texture_copy.input_width * 16, config.texture_copy.input_gap * 16,
+                  config.GetPhysicalOutputAddress(), config.texture_copy.output_width * 16,
+                  config.texture_copy.output_gap * 16, config.flags);
+    } else {
+        DisplayTransfer(config);
+        LOG_TRACE(HW_GPU,
+                  "DisplayTransfer: {:#010X}({}x{})-> "
+                  "{:#010X}({}x{}), dst format {:x}, flags {:#010X}",
+                  config.GetPhysicalInputAddress(), config.input_width.Value(),
+                  config.input_height.Value(), config.GetPhysicalOutputAddress(),
+                  config.output_width.Value(), config.output_height.Value(),
+                  static_cast<u32>(config.output_format.Value()), config.flags);
+    }
+
+    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PPF);
+}
+
+static void ExecuteCommand(const CommandData& command) {
+    if (const auto* submit_list = std::get_if<SubmitListCommand>(&command)) {
+        Pica::CommandProcessor::ProcessCommandList(submit_list->list, submit_list->size);
+    } else if (const auto* memory_fill = std::get_if<MemoryFillCommand>(&command)) {
+        RunMemoryFill(memory_fill->config, memory_fill->is_second_filler);
+    } else if (const auto* display_transfer = std::get_if<DisplayTransferCommand>(&command)) {
+        RunDisplayTransfer(display_transfer->config);
+    }
+}
+
+static bool UseGPUThread() {
+    // The OpenGL rasterizer must stay on the thread that owns the context, and the CiTrace
+    // recorder expects memory accesses in the order of register writes.
+    return Settings::values.use_gpu_thread && !VideoCore::g_hw_renderer_enabled &&
+           !(Pica::g_debug_context && Pica::g_debug_context->recorder);
+}
+
+/// Takes the pages of a range off the CPU fast path, so that accesses wait for the GPU thread.
+static void FenceRange(PAddr start, u32 size, u64 fence) {
+    if (size == 0 || !g_memory->IsValidPhysicalAddress(start)) {
+        // The command logs and skips invalid ranges itself
+        return;
+    }
+    fenced_ranges.push_back({start, size, fence});
+    const PAddr end = start + size;
+    for (PAddr page = start & ~Memory::PAGE_MASK; page < end; page += Memory::PAGE_SIZE) {
+        if (fenced_pages[page]++ == 0) {
+            g_memory->RasterizerMarkRegionCached(page, Memory::PAGE_SIZE, true);
+        }
+    }
+}
+
+static void ReleaseRange(const FencedRange& range) {
+    const PAddr end = range.start + range.size;
+    for (PAddr page = range.start & ~Memory::PAGE_MASK; page < end; page += Memory::PAGE_SIZE) {
+        const auto it = fenced_pages.find(page);
+        if (--it->second == 0) {
+            fenced_pages.erase(it);
+            g_memory->RasterizerMarkRegionCached(page, Memory::PAGE_SIZE, false);
+        }
+    }
+}
+
+/**
+ * Reports the completion of the work the GPU thread has finished so far, without waiting: clears
+ * the trigger registers, sets the memory fill "finished" flags and releases fenced memory.
+ * @returns the fence of the latest finished command
+ */
+static u64 ReleaseCompletedWork() {
+    if (gpu_thread == nullptr) {
+        return 0;
+    }
+    const u64 signaled_fence = gpu_thread->GetSignaledFence();
+    const auto completed = [signaled_fence](u64& fence) {
+        if (fence == 0 || fence > signaled_fence) {
+            return false;
+        }
+        fence = 0;
+        return true;
+    };
+
+    for (std::size_t i = 0; i < memory_fill_fences.size(); ++i) {
+        if (completed(memory_fill_fences[i])) {
+            // NOTE: This was confirmed to happen on hardware even if "address_start" is zero.
+            g_regs.memory_fill_config[i].trigger.Assign(0);
+            g_regs.memory_fill_config[i].finished.Assign(1);
+        }
+    }
+    if (completed(display_transfer_fence)) {
+        g_regs.display_transfer_config.trigger = 0;
+    }
+    if (completed(command_list_fence)) {
+        g_regs.command_processor_config.trigger = 0;
+    }
+
+    while (!fenced_ranges.empty() && fenced_ranges.front().fence <= signaled_fence) {
+        ReleaseRange(fenced_ranges.front());
+        fenced_ranges.pop_front();
+    }
+    return signaled_fence;
+}
+
+/**
+ * Delivers the interrupts raised by commands up to the given fence. A command queues its
+ * interrupts before its fence is signaled, so these never arrive before the work is reported
+ * complete.
+ * @returns whether any interrupt was delivered
+ */
+static bool DeliverInterrupts(u64 signaled_fence) {
+    std::vector<Service::GSP::InterruptId> interrupts;
+    {
+        std::lock_guard lock(deferred_interrupts_mutex);
+        while (!deferred_interrupts.empty() &&
+               deferred_interrupts.front().fence <= signaled_fence) {
+            interrupts.push_back(deferred_interrupts.front().id);
+            deferred_interrupts.pop_front();
+        }
+    }
+    for (Service::GSP::InterruptId interrupt_id : interrupts) {
+        Service::GSP::SignalInterrupt(interrupt_id);
+    }
+    return !interrupts.empty();
+}
+
+/**
+ * Runs GPU work, on the GPU thread if it is enabled.
+ * @param fence Set to the fence of the command if it was queued on the GPU thread, or 0 if it
+ * already ran.
+ */
+static void Submit(CommandData command, u64& fence) {
+    if (!UseGPUThread()) {
+        // Finish work queued while the GPU thread was enabled first, to keep the order.
+        SyncGPUThread();
+        ExecuteCommand(command);
+        fence = 0;
+        return;
+    }
+
+    if (gpu_thread == nullptr) {
+        gpu_thread = std::make_unique<GPUThread>(ExecuteCommand);
+    }
+    fence = gpu_thread->Push(std::move(command));
+
+    if (!gpu_poll_scheduled) {
+        gpu_poll_scheduled = true;
+        Core::System::GetInstance().CoreTiming().ScheduleEvent(GPU_THREAD_POLL_CYCLES,
+                                                               gpu_poll_event);
+    }
+}
+
+void WaitForGPUThread() {
+    if (gpu_thread == nullptr || GPUThread::IsCurrentThread()) {
+        return;
+    }
+    gpu_thread->WaitIdle();
+    ReleaseCompletedWork();
+}
+
+bool SyncGPUThread() {
+    if (gpu_thread == nullptr) {
+        return false;
+    }
+    gpu_thread->WaitIdle();
+    return DeliverInterrupts(ReleaseCompletedWork());
+}
+
+bool DeferInterrupt(Service::GSP::InterruptId interrupt_id) {
+    if (!GPUThread::IsCurrentThread()) {
+        return false;
+    }
+    std::lock_guard lock(deferred_interrupts_mutex);
+    deferred_interrupts.push_back({interrupt_id, GPUThread::GetRunningFence()});
+    return true;
+}
+
+static void GPUPollCallback(u64 userdata, s64 cycles_late) {
+    DeliverInterrupts(ReleaseCompletedWork());
+
+    if (gpu_thread->IsIdle()) {
+        gpu_poll_scheduled = false;
+        return;
+    }
+    Core::System::GetInstance().CoreTiming().ScheduleEvent(GPU_THREAD_POLL_CYCLES - cycles_late,
+                                                           gpu_poll_event);
+}
+
 template <typename T>
 inline void Write(u32 addr, const T data) {
     addr -= HW::VADDR_GPU;
@@ -403,24 +693,21 @@ inline void Write(u32 addr, const T data) {
         GPU::Regs::MemoryFillConfig& config = g_regs.memory_fill_config[is_second_filler];
 
         if (config.trigger) {
-            MemoryFill(config);
-            LOG_TRACE(HW_GPU, "MemoryFill from {:#010X} to {:#010X}", config.GetStartAddress(),
-                      config.GetEndAddress());
-
-            // It seems that it won't signal interrupt if "address_start" is zero.
-            // TODO: hwtest this
-            if (config.GetStartAddress() != 0) {
-                if (!is_second_filler) {
-                    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC0);
-                } else {
-                    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PSC1);
+            u64& fence = memory_fill_fences[is_second_filler];
+            Submit(MemoryFillCommand{config, is_second_filler}, fence);
+            if (fence == 0) {
+                // Reset "trigger" flag and set the "finish" flag
+                // NOTE: This was confirmed to happen on hardware even if "address_start" is zero.
+                config.trigger.Assign(0);
+                config.finished.Assign(1);
+            } else {
+                // Done by ReleaseCompletedWork once the fill has run
+                config.finished.Assign(0);
+                if (config.GetEndAddress() > config.GetStartAddress()) {
+                    FenceRange(config.GetStartAddress(),
+                               config.GetEndAddress() - config.GetStartAddress(), fence);
                 }
             }
-
-            // Reset "trigger" flag and set the "finish" flag
-            // NOTE: This was confirmed to happen on hardware even if "address_start" is zero.
-            config.trigger.Assign(0);
-            config.finished.Assign(1);
         }
         break;
     }
@@ -428,33 +715,15 @@ inline void Write(u32 addr, const T data) {
     case GPU_REG_INDEX(display_transfer_config.trigger): {
         const GPU::Regs::DisplayTransferConfig& config = g_regs.display_transfer_config;
         if (config.trigger & 1) {
-
-            if (Pica::g_debug_context)
-                Pica::g_debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer,
-                                               nullptr);
-
-            if (config.is_texture_copy) {
-                TextureCopy(config);
-                LOG_TRACE(HW_GPU,
-                          "TextureCopy: {:#X} bytes from {:#010X}({}+{})-> "
-                          "{:#010X}({}+{}), flags {:#010X}",
-                          config.texture_copy.size, config.GetPhysicalInputAddress(),
-                          config.texture_copy.input_width * 16, config.texture_copy.input_gap * 16,
-                          config.GetPhysicalOutputAddress(), config.texture_copy.output_width * 16,
-                          config.texture_copy.output_gap * 16, config.flags);
+            Submit(DisplayTransferCommand{config}, display_transfer_fence);
+            if (display_transfer_fence == 0) {
+                g_regs.display_transfer_config.trigger = 0;
             } else {
-                DisplayTransfer(config);
-                LOG_TRACE(HW_GPU,
-                          "DisplayTransfer: {:#010X}({}x{})-> "
-                          "{:#010X}({}x{}), dst format {:x}, flags {:#010X}",
-                          config.GetPhysicalInputAddress(), config.input_width.Value(),
-                          config.input_height.Value(), config.GetPhysicalOutputAddress(),
-                          config.output_width.Value(), config.output_height.Value(),
-                          static_cast<u32>(config.output_format.Value()), config.flags);
+                const TransferSizes sizes = GetTransferSizes(config);
+                FenceRange(config.GetPhysicalInputAddress(), sizes.input, display_transfer_fence);
+                FenceRange(config.GetPhysicalOutputAddress(), sizes.output,
+                           display_transfer_fence);
             }
-
-            g_regs.display_transfer_config.trigger = 0;
-            Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PPF);
         }
         break;
     }
@@ -470,9 +739,12 @@ inline void Write(u32 addr, const T data) {
                                                                 config.GetPhysicalAddress());
             }
 
-            Pica::CommandProcessor::ProcessCommandList(buffer, config.size);
-
-            g_regs.command_processor_config.trigger = 0;
+            Submit(SubmitListCommand{buffer, config.size}, command_list_fence);
+            if (command_list_fence == 0) {
+                g_regs.command_processor_config.trigger = 0;
+            } else {
+                FenceRange(config.GetPhysicalAddress(), config.size, command_list_fence);
+            }
         }
         break;
     }
@@ -504,6 +776,8 @@ template void Write<u8>(u32 addr, const u8 data);
 
 /// Update hardware
 static void VBlankCallback(u64 userdata, s64 cycles_late) {
+    // The frame is presented from emulated memory, so finish the GPU work that renders it first.
+    SyncGPUThread();
     VideoCore::g_renderer->SwapBuffers();
 
     // Signal to GSP that GPU interrupt has occurred
@@ -556,6 +830,8 @@ void Init(Memory::MemorySystem& memory) {
 
     Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     vblank_event = timing.RegisterEvent("GPU::VBlankCallback", VBlankCallback);
+    gpu_poll_event = timing.RegisterEvent("GPU::GPUPollCallback", GPUPollCallback);
+    gpu_poll_scheduled = false;
     Core::System::GetInstance().CoreTiming().ScheduleEvent(
         static_cast<u64>(BASE_CLOCK_RATE_ARM11 / (Settings::values.custom_screen_refresh_rate
                                                       ? Settings::values.screen_refresh_rate
@@ -567,6 +843,16 @@ void Init(Memory::MemorySystem& memory) {
 
 /// Shutdown hardware
 void Shutdown() {
+    if (gpu_thread != nullptr) {
+        // Give the memory fenced for the queued work back to the CPU
+        gpu_thread->WaitIdle();
+        ReleaseCompletedWork();
+        gpu_thread.reset();
+    }
+    deferred_interrupts.clear();
+    memory_fill_fences = {};
+    display_transfer_fence = 0;
+    command_list_fence = 0;
     LOG_DEBUG(HW_GPU, "shutdown OK");
 }
 
@@ -15,6 +15,10 @@ namespace Memory {
 class MemorySystem;
 }
 
+namespace Service::GSP {
+enum class InterruptId : u8;
+}
+
 namespace GPU {
 
 // Returns index corresponding to the Regs member labeled by field_name
@@ -327,6 +331,25 @@ void Read(T& var, const u32 addr);
 template <typename T>
 void Write(u32 addr, const T data);
 
+/**
+ * Waits for the work queued on the GPU thread to finish, without delivering its interrupts. Memory
+ * that the work used is given back to the CPU fast path.
+ */
+void WaitForGPUThread();
+
+/**
+ * Waits for the work queued on the GPU thread to finish and delivers the interrupts it raised.
+ * @returns whether any interrupt was delivered
+ */
+bool SyncGPUThread();
+
+/**
+ * Queues an interrupt raised by work running on the GPU thread, to be delivered on the emulation
+ * thread once the command raising it has finished.
+ * @returns false if not called from the GPU thread.
+ */
+bool DeferInterrupt(Service::GSP::InterruptId interrupt_id);
+
 /// Initialize hardware
 void Init(Memory::MemorySystem& memory);
 
@@ -0,0 +1,81 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/thread.h"
+#include "core/hw/gpu_thread.h"
+
+namespace GPU {
+
+namespace {
+thread_local bool is_gpu_thread = false;
+thread_local u64 running_fence = 0;
+} // Anonymous namespace
+
+GPUThread::GPUThread(Executor executor) : executor(std::move(executor)) {
+    thread = std::thread([this] { Run(); });
+}
+
+GPUThread::~GPUThread() {
+    WaitIdle();
+    queue.Push(Command{{}, 0});
+    thread.join();
+}
+
+u64 GPUThread::Push(CommandData command) {
+    queue.Push(Command{std::move(command), ++last_fence});
+    return last_fence;
+}
+
+void GPUThread::WaitForFence(u64 fence) {
+    if (signaled_fence.load(std::memory_order_acquire) >= fence) {
+        return;
+    }
+    std::unique_lock lock(fence_mutex);
+    fence_cv.wait(lock, [this, fence] {
+        return signaled_fence.load(std::memory_order_acquire) >= fence;
+    });
+}
+
+void GPUThread::WaitIdle() {
+    WaitForFence(last_fence);
+}
+
+u64 GPUThread::GetSignaledFence() const {
+    return signaled_fence.load(std::memory_order_acquire);
+}
+
+bool GPUThread::IsIdle() const {
+    return GetSignaledFence() >= last_fence;
+}
+
+bool GPUThread::IsCurrentThread() {
+    return is_gpu_thread;
+}
+
+u64 GPUThread::GetRunningFence() {
+    return running_fence;
+}
+
+void GPUThread::Run() {
+    Common::SetCurrentThreadName("GPUThread");
+    is_gpu_thread = true;
+
+    while (true) {
+        Command command = queue.PopWait();
+        if (command.fence == 0) {
+            break;
+        }
+
+        running_fence = command.fence;
+        executor(command.data);
+
+        {
+            std::lock_guard lock(fence_mutex);
+            signaled_fence.store(command.fence, std::memory_order_release);
+        }
+        fence_cv.notify_all();
+    }
+}
+
+} // namespace GPU
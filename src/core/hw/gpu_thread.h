@@ -0,0 +1,95 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include "common/common_types.h"
+#include "common/threadsafe_queue.h"
+#include "core/hw/gpu.h"
+
+namespace GPU {
+
+/// Runs a PICA command list.
+struct SubmitListCommand {
+    const u32* list;
+    u32 size;
+};
+
+/// Runs a memory fill. The config is copied, as the registers can be rewritten before it runs.
+struct MemoryFillCommand {
+    Regs::MemoryFillConfig config;
+    bool is_second_filler;
+};
+
+/// Runs a display transfer or a texture copy.
+struct DisplayTransferCommand {
+    Regs::DisplayTransferConfig config;
+};
+
+using CommandData = std::variant<SubmitListCommand, MemoryFillCommand, DisplayTransferCommand>;
+
+/**
+ * Thread that runs GPU work submitted by the emulation thread, in submission order, so that CPU
+ * and GPU emulation overlap.
+ *
+ * Commands are passed through a single-producer single-consumer queue and numbered with
+ * increasing fences. The emulation thread waits for a fence before touching anything the GPU
+ * may still be using.
+ */
+class GPUThread {
+public:
+    using Executor = std::function<void(const CommandData&)>;
+
+    explicit GPUThread(Executor executor);
+    ~GPUThread();
+
+    /// Queues a command and returns its fence.
+    u64 Push(CommandData command);
+
+    /// Blocks until the command with the given fence has been run.
+    void WaitForFence(u64 fence);
+
+    /// Blocks until every queued command has been run.
+    void WaitIdle();
+
+    /// Returns the fence of the latest command that has been run, without blocking.
+    u64 GetSignaledFence() const;
+
+    /// Returns whether every queued command has been run, without blocking.
+    bool IsIdle() const;
+
+    /// Returns whether the calling thread is a GPU thread.
+    static bool IsCurrentThread();
+
+    /// Returns the fence of the command the calling GPU thread is running.
+    static u64 GetRunningFence();
+
+private:
+    struct Command {
+        CommandData data;
+        /// Fence signaled once the command has run. Fences start at 1, 0 stops the thread.
+        u64 fence;
+    };
+
+    void Run();
+
+    Executor executor;
+
+    Common::SPSCQueue<Command> queue;
+    u64 last_fence = 0;
+
+    std::atomic<u64> signaled_fence{0};
+    std::mutex fence_mutex;
+    std::condition_variable fence_cv;
+
+    std::thread thread;
+};
+
+} // namespace GPU
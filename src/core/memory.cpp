@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include "audio_core/dsp_interface.h"
@@ -14,6 +15,7 @@
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/lock.h"
+#include "core/hw/gpu.h"
 #include "core/memory.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
@@ -35,7 +37,27 @@ public:
         return false;
     }
 
+    /// Calls func(page) for each marked page among the page numbers [begin, end).
+    template <typename Func>
+    void ForEachCachedPage(u32 begin, u32 end, Func&& func) const {
+        ForEachCachedPage(vram, VRAM_VADDR, begin, end, func);
+        ForEachCachedPage(linear_heap, LINEAR_HEAP_VADDR, begin, end, func);
+        ForEachCachedPage(new_linear_heap, NEW_LINEAR_HEAP_VADDR, begin, end, func);
+    }
+
 private:
+    template <std::size_t N, typename Func>
+    static void ForEachCachedPage(const std::array<bool, N>& marks, VAddr region, u32 begin,
+                                  u32 end, Func& func) {
+        const u32 region_begin = region / PAGE_SIZE;
+        const u32 region_end = region_begin + static_cast<u32>(N);
+        for (u32 page = std::max(begin, region_begin); page < std::min(end, region_end); ++page) {
+            if (marks[page - region_begin]) {
+                func(page);
+            }
+        }
+    }
+
     bool* At(VAddr addr) {
         if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
             return &vram[(addr - VRAM_VADDR) / PAGE_SIZE];
@@ -65,10 +87,67 @@ public:
     PageTable* current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
     std::vector<PageTable*> page_table_list;
+    /// Number of debugger watchpoints on each watched page, by page number
+    std::map<u32, u32> watched_pages;
 
     AudioCore::DspInterface* dsp = nullptr;
+
+    /// Size of the physical pages. Every memory area begins and ends on a page boundary.
+    static constexpr u32 PhysicalPageBits = 19;
+    static constexpr u32 PhysicalPageSize = 1U << PhysicalPageBits;
+    static constexpr u32 PhysicalPageMask = PhysicalPageSize - 1;
+    static constexpr std::size_t NumPhysicalPages = std::size_t{1} << (32 - PhysicalPageBits);
+
+    /// Host pointer to the beginning of each physical page, null outside of the memory areas
+    std::array<u8*, NumPhysicalPages> physical_pointers{};
+    /// End of the memory area each physical page is in
+    std::array<PAddr, NumPhysicalPages> physical_area_ends{};
+
+    Impl() {
+        MapPhysicalArea(VRAM_PADDR, VRAM_SIZE, vram.get());
+        MapPhysicalArea(FCRAM_PADDR, FCRAM_N3DS_SIZE, fcram.get());
+        MapPhysicalArea(N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE, n3ds_extra_ram.get());
+    }
+
+    void MapPhysicalArea(PAddr base, u32 size, u8* memory) {
+        static_assert((VRAM_PADDR | VRAM_SIZE | DSP_RAM_PADDR | DSP_RAM_SIZE | FCRAM_PADDR |
+                       FCRAM_N3DS_SIZE | N3DS_EXTRA_RAM_PADDR | N3DS_EXTRA_RAM_SIZE) %
+                              PhysicalPageSize ==
+                          0,
+                      "Memory areas must be aligned to the physical page size");
+        for (u32 offset = 0; offset < size; offset += PhysicalPageSize) {
+            physical_pointers[(base + offset) >> PhysicalPageBits] = memory + offset;
+            physical_area_ends[(base + offset) >> PhysicalPageBits] = base + size;
+        }
+    }
 };
 
+/// Moves the pointer of a regular memory page aside while it is watched, and back once it is not
+static void SetPageWatched(PageTable& page_table, u32 page, bool watched) {
+    PageType& page_type = page_table.attributes[page];
+    if (watched && page_type == PageType::Memory) {
+        page_type = PageType::WatchedMemory;
+        page_table.watched_pointers[page] = page_table.pointers[page];
+        page_table.pointers[page] = nullptr;
+    } else if (!watched && page_type == PageType::WatchedMemory) {
+        const auto iter = page_table.watched_pointers.find(page);
+        page_type = PageType::Memory;
+        page_table.pointers[page] = iter->second;
+        page_table.watched_pointers.erase(iter);
+    }
+}
+
+/**
+ * This function should only be called for virtual addreses with attribute
+ * `PageType::WatchedMemory`.
+ */
+static u8* GetWatchedPointer(const PageTable& page_table, VAddr vaddr) {
+    const auto iter = page_table.watched_pointers.find(vaddr >> PAGE_BITS);
+    ASSERT_MSG(iter != page_table.watched_pointers.end(), "Watched page without a pointer @ {:08X}",
+               vaddr);
+    return iter->second + (vaddr & PAGE_MASK);
+}
+
 MemorySystem::MemorySystem() : impl(std::make_unique<Impl>()) {}
 MemorySystem::~MemorySystem() = default;
 
@@ -87,22 +166,36 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memor
     RasterizerFlushVirtualRegion(base << PAGE_BITS, size * PAGE_SIZE,
                                  FlushMode::FlushAndInvalidate);
 
-    u32 end = base + size;
-    while (base != end) {
-        ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
+    ASSERT_MSG(base <= PAGE_TABLE_NUM_ENTRIES && size <= PAGE_TABLE_NUM_ENTRIES - base,
+               "out of range mapping at {:08X}", base);
+
+    // Fill the whole range at once, then fix up the few pages the rasterizer caches
+    const u32 end = base + size;
+    std::fill(page_table.attributes.begin() + base, page_table.attributes.begin() + end, type);
+    if (memory == nullptr) {
+        std::fill(page_table.pointers.begin() + base, page_table.pointers.begin() + end, nullptr);
+    } else {
+        for (u32 page = base; page != end; ++page, memory += PAGE_SIZE) {
+            page_table.pointers[page] = memory;
+        }
+    }
 
-        page_table.attributes[base] = type;
-        page_table.pointers[base] = memory;
+    // If the memory to map is already rasterizer-cached, mark the page
+    if (type == PageType::Memory) {
+        impl->cache_marker.ForEachCachedPage(base, end, [&page_table](u32 page) {
+            page_table.attributes[page] = PageType::RasterizerCachedMemory;
+            page_table.pointers[page] = nullptr;
+        });
+    }
 
-        // If the memory to map is already rasterizer-cached, mark the page
-        if (type == PageType::Memory && impl->cache_marker.IsCached(base * PAGE_SIZE)) {
-            page_table.attributes[base] = PageType::RasterizerCachedMemory;
-            page_table.pointers[base] = nullptr;
+    // Likewise for watched pages, whose previous mappings are gone
+    page_table.watched_pointers.erase(page_table.watched_pointers.lower_bound(base),
+                                      page_table.watched_pointers.lower_bound(end));
+    if (type == PageType::Memory) {
+        for (auto iter = impl->watched_pages.lower_bound(base);
+             iter != impl->watched_pages.end() && iter->first < end; ++iter) {
+            SetPageWatched(page_table, iter->first, true);
         }
-
-        base += 1;
-        if (memory != nullptr)
-            memory += PAGE_SIZE;
     }
 }
 
@@ -190,6 +283,11 @@ T MemorySystem::Read(const VAddr vaddr) {
         std::memcpy(&value, GetPointerForRasterizerCache(vaddr), sizeof(T));
         return value;
     }
+    case PageType::WatchedMemory: {
+        T value;
+        std::memcpy(&value, GetWatchedPointer(*impl->current_page_table, vaddr), sizeof(T));
+        return value;
+    }
     case PageType::Special:
         return ReadMMIO<T>(GetMMIOHandler(*impl->current_page_table, vaddr), vaddr);
     default:
@@ -223,6 +321,9 @@ void MemorySystem::Write(const VAddr vaddr, const T data) {
         std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
         break;
     }
+    case PageType::WatchedMemory:
+        std::memcpy(GetWatchedPointer(*impl->current_page_table, vaddr), &data, sizeof(T));
+        break;
     case PageType::Special:
         WriteMMIO<T>(GetMMIOHandler(*impl->current_page_table, vaddr), vaddr, data);
         break;
@@ -239,7 +340,8 @@ bool IsValidVirtualAddress(const Kernel::Process& process, const VAddr vaddr) {
         return true;
     }
 
-    if (page_table.attributes[vaddr >> PAGE_BITS] == PageType::RasterizerCachedMemory) {
+    if (page_table.attributes[vaddr >> PAGE_BITS] == PageType::RasterizerCachedMemory ||
+        page_table.attributes[vaddr >> PAGE_BITS] == PageType::WatchedMemory) {
         return true;
     }
 
@@ -270,6 +372,10 @@ u8* MemorySystem::GetPointer(const VAddr vaddr) {
         return GetPointerForRasterizerCache(vaddr);
     }
 
+    if (impl->current_page_table->attributes[vaddr >> PAGE_BITS] == PageType::WatchedMemory) {
+        return GetWatchedPointer(*impl->current_page_table, vaddr);
+    }
+
     LOG_ERROR(HW_Memory, "unknown GetPointer @ 0x{:08x}", vaddr);
     return nullptr;
 }
@@ -289,51 +395,29 @@ std::string MemorySystem::ReadCString(VAddr vaddr, std::size_t max_length) {
 }
 
 u8* MemorySystem::GetPhysicalPointer(PAddr address) {
-    struct MemoryArea {
-        PAddr paddr_base;
-        u32 size;
-    };
-
-    static constexpr MemoryArea memory_areas[] = {
-        {VRAM_PADDR, VRAM_SIZE},
-        {DSP_RAM_PADDR, DSP_RAM_SIZE},
-        {FCRAM_PADDR, FCRAM_N3DS_SIZE},
-        {N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE},
-    };
-
-    const MemoryArea* area =
-        std::find_if(std::begin(memory_areas), std::end(memory_areas), [&](const MemoryArea& area) {
-            // Note: the region end check is inclusive because the user can pass in an address that
-            // represents an open right bound
-            return address >= area.paddr_base && address <= area.paddr_base + area.size;
-        });
-
-    if (area == std::end(memory_areas)) {
-        LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x{:08X}", address);
-        return nullptr;
+    u8* const page_pointer = impl->physical_pointers[address >> Impl::PhysicalPageBits];
+    if (page_pointer) {
+        return page_pointer + (address & Impl::PhysicalPageMask);
     }
+    return GetPhysicalSpan(address).first;
+}
 
-    u32 offset_into_region = address - area->paddr_base;
+std::pair<u8*, u32> MemorySystem::GetPhysicalSpan(PAddr address) {
+    const std::size_t page = address >> Impl::PhysicalPageBits;
+    if (u8* const page_pointer = impl->physical_pointers[page]) {
+        return {page_pointer + (address & Impl::PhysicalPageMask),
+                impl->physical_area_ends[page] - address};
+    }
 
-    u8* target_pointer = nullptr;
-    switch (area->paddr_base) {
-    case VRAM_PADDR:
-        target_pointer = impl->vram.get() + offset_into_region;
-        break;
-    case DSP_RAM_PADDR:
-        target_pointer = impl->dsp->GetDspMemory().data() + offset_into_region;
-        break;
-    case FCRAM_PADDR:
-        target_pointer = impl->fcram.get() + offset_into_region;
-        break;
-    case N3DS_EXTRA_RAM_PADDR:
-        target_pointer = impl->n3ds_extra_ram.get() + offset_into_region;
-        break;
-    default:
-        UNREACHABLE();
+    // Note: the end of an area is accepted too, because the user can pass in an address that
+    // represents an open right bound
+    if (page > 0 && impl->physical_pointers[page - 1] &&
+        impl->physical_area_ends[page - 1] == address) {
+        return {impl->physical_pointers[page - 1] + Impl::PhysicalPageSize, 0};
     }
 
-    return target_pointer;
+    LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x{:08X}", address);
+    return {nullptr, 0};
 }
 
 /// For a rasterizer-accessible PAddr, gets a list of all possible VAddr
@@ -380,6 +464,11 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         page_type = PageType::RasterizerCachedMemory;
                         page_table->pointers[vaddr >> PAGE_BITS] = nullptr;
                         break;
+                    case PageType::WatchedMemory:
+                        // Cached pages have no pointer either, so they are still checked
+                        page_type = PageType::RasterizerCachedMemory;
+                        page_table->watched_pointers.erase(vaddr >> PAGE_BITS);
+                        break;
                     default:
                         UNREACHABLE();
                     }
@@ -394,6 +483,9 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         page_type = PageType::Memory;
                         page_table->pointers[vaddr >> PAGE_BITS] =
                             GetPointerForRasterizerCache(vaddr & ~PAGE_MASK);
+                        if (impl->watched_pages.count(vaddr >> PAGE_BITS)) {
+                            SetPageWatched(*page_table, vaddr >> PAGE_BITS, true);
+                        }
                         break;
                     }
                     default:
@@ -405,6 +497,34 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
     }
 }
 
+void MemorySystem::MarkRegionWatched(VAddr start, u32 size, bool watched) {
+    if (size == 0) {
+        return;
+    }
+
+    const u32 first_page = start >> PAGE_BITS;
+    const u32 last_page = static_cast<u32>(
+        (std::min<u64>(u64{start} + size, u64{1} << 32) - 1) >> PAGE_BITS);
+    for (u32 page = first_page; page <= last_page; ++page) {
+        // Only the first mark and the last unmark of a page change it
+        if (watched) {
+            if (impl->watched_pages[page]++ != 0) {
+                continue;
+            }
+        } else {
+            const auto iter = impl->watched_pages.find(page);
+            if (iter == impl->watched_pages.end() || --iter->second != 0) {
+                continue;
+            }
+            impl->watched_pages.erase(iter);
+        }
+
+        for (PageTable* page_table : impl->page_table_list) {
+            SetPageWatched(*page_table, page, watched);
+        }
+    }
+}
+
 void RasterizerFlushRegion(PAddr start, u32 size) {
     if (VideoCore::g_renderer == nullptr) {
         return;
@@ -438,6 +558,9 @@ void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
         return;
     }
 
+    // Work queued on the GPU thread may still be using this region.
+    GPU::WaitForGPUThread();
+
     VAddr end = start + size;
 
     auto CheckRegion = [&](VAddr region_start, VAddr region_end, PAddr paddr_region_start) {
@@ -513,6 +636,10 @@ void MemorySystem::ReadBlock(const Kernel::Process& process, const VAddr src_add
             std::memcpy(dest_buffer, src_ptr, copy_amount);
             break;
         }
+        case PageType::WatchedMemory: {
+            std::memcpy(dest_buffer, GetWatchedPointer(page_table, current_vaddr), copy_amount);
+            break;
+        }
         case PageType::Special: {
             MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
             DEBUG_ASSERT(handler);
@@ -577,6 +704,10 @@ void MemorySystem::WriteBlock(const Kernel::Process& process, const VAddr dest_a
             std::memcpy(dest_ptr, src_buffer, copy_amount);
             break;
         }
+        case PageType::WatchedMemory: {
+            std::memcpy(GetWatchedPointer(page_table, current_vaddr), src_buffer, copy_amount);
+            break;
+        }
         case PageType::Special: {
             MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
             DEBUG_ASSERT(handler);
@@ -627,6 +758,10 @@ void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_ad
             std::memset(dest_ptr, 0, copy_amount);
             break;
         }
+        case PageType::WatchedMemory: {
+            std::memset(GetWatchedPointer(page_table, current_vaddr), 0, copy_amount);
+            break;
+        }
         case PageType::Special: {
             MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
             DEBUG_ASSERT(handler);
@@ -680,6 +815,11 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
             WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
             break;
         }
+        case PageType::WatchedMemory: {
+            WriteBlock(dest_process, dest_addr, GetWatchedPointer(page_table, current_vaddr),
+                       copy_amount);
+            break;
+        }
         case PageType::Special: {
             MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
             DEBUG_ASSERT(handler);
@@ -759,6 +899,7 @@ u8* MemorySystem::GetFCRAMPointer(u32 offset) {
 
 void MemorySystem::SetDSP(AudioCore::DspInterface& dsp) {
     impl->dsp = &dsp;
+    impl->MapPhysicalArea(DSP_RAM_PADDR, DSP_RAM_SIZE, dsp.GetDspMemory().data());
 }
 
 } // namespace Memory
@@ -6,8 +6,10 @@
 
 #include <array>
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "common/common_types.h"
 #include "core/mmio.h"
@@ -46,6 +48,9 @@ enum class PageType {
     RasterizerCachedMemory,
     /// Page is mapped to a I/O region. Writing and reading to this page is handled by functions.
     Special,
+    /// Page is mapped to regular memory, but has a debugger watchpoint on it. Its pointer is kept
+    /// aside so that the CPU JIT accesses it through its callbacks, which check the watchpoints.
+    WatchedMemory,
 };
 
 struct SpecialRegion {
@@ -78,6 +83,12 @@ struct PageTable {
      * the corresponding entry in `pointers` MUST be set to null.
      */
     std::array<PageType, PAGE_TABLE_NUM_ENTRIES> attributes;
+
+    /**
+     * Memory backing the pages whose entries in the `attributes` array are of type
+     * `WatchedMemory`, by page number.
+     */
+    std::map<u32, u8*> watched_pointers;
 };
 
 /// Physical memory regions as seen from the ARM11
@@ -272,6 +283,13 @@ public:
      */
     u8* GetPhysicalPointer(PAddr address);
 
+    /**
+     * Gets a pointer to the specified physical address, along with the number of bytes that can
+     * be accessed through it before the end of its memory area. Returns {nullptr, 0} for
+     * addresses outside every memory area.
+     */
+    std::pair<u8*, u32> GetPhysicalSpan(PAddr address);
+
     u8* GetPointer(VAddr vaddr);
 
     bool IsValidPhysicalAddress(PAddr paddr);
@@ -287,10 +305,17 @@ public:
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
-    /// Registers page table for rasterizer cache marking
+    /**
+     * Marks each page touching the region as watched by the debugger, or removes one such mark.
+     * Watched pages of regular memory are only reachable through the slow path, so that the CPU can
+     * check its accesses to them for watchpoints without slowing down accesses to other pages.
+     */
+    void MarkRegionWatched(VAddr start, u32 size, bool watched);
+
+    /// Registers page table for rasterizer cache and watchpoint marking
     void RegisterPageTable(PageTable* page_table);
 
-    /// Unregisters page table for rasterizer cache marking
+    /// Unregisters page table for rasterizer cache and watchpoint marking
     void UnregisterPageTable(PageTable* page_table);
 
     void SetDSP(AudioCore::DspInterface& dsp);
@@ -11,6 +11,7 @@
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
+#include "core/core_timing.h"
 #include "core/hw/gpu.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
@@ -87,7 +88,9 @@ double PerfStats::GetMeanFrametime() {
     return sum / (current_index - IgnoreFrames);
 }
 
-PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
+PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us,
+                                               u64 skipped_idle_loop_ticks,
+                                               u64 texture_hash_lookups, u64 texture_hash_hits) {
     std::lock_guard<std::mutex> lock(object_mutex);
 
     const auto now = Clock::now();
@@ -105,9 +108,25 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
 
+    const microseconds system_us_elapsed = current_system_time_us - reset_point_system_us;
+    const s64 skipped_us =
+        cyclesToUs(static_cast<s64>(skipped_idle_loop_ticks - reset_point_skipped_idle_loop_ticks));
+    results.idle_skip_ratio =
+        system_us_elapsed.count() > 0
+            ? static_cast<double>(skipped_us) / static_cast<double>(system_us_elapsed.count())
+            : 0.0;
+
+    const u64 lookups = texture_hash_lookups - reset_point_texture_hash_lookups;
+    const u64 hits = texture_hash_hits - reset_point_texture_hash_hits;
+    results.texture_hash_hit_ratio =
+        lookups != 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+
     // Reset counters
     reset_point = now;
     reset_point_system_us = current_system_time_us;
+    reset_point_skipped_idle_loop_ticks = skipped_idle_loop_ticks;
+    reset_point_texture_hash_lookups = texture_hash_lookups;
+    reset_point_texture_hash_hits = texture_hash_hits;
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
@@ -35,13 +35,19 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Fraction of emulated time that was skipped by fast-forwarding through guest idle loops
+        double idle_skip_ratio;
+        /// Fraction of hashed texture reloads whose upload was skipped, 0 if none were hashed
+        double texture_hash_hit_ratio;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
-    Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
+    Results GetAndResetStats(std::chrono::microseconds current_system_time_us,
+                             u64 skipped_idle_loop_ticks, u64 texture_hash_lookups,
+                             u64 texture_hash_hits);
 
     /**
      * Returns the Arthimetic Mean of all frametime values stored in the performance history.
@@ -69,6 +75,11 @@ private:
     Clock::time_point reset_point = Clock::now();
     /// System time when the cumulative counters were reset
     std::chrono::microseconds reset_point_system_us{0};
+    /// Total cycles skipped in guest idle loops when the cumulative counters were reset
+    u64 reset_point_skipped_idle_loop_ticks = 0;
+    /// Texture hash lookups and hits when the cumulative counters were reset
+    u64 reset_point_texture_hash_lookups = 0;
+    u64 reset_point_texture_hash_hits = 0;
 
     /// Cumulative duration (excluding v-sync/frame-limiting) of frames since last reset
     Clock::duration accumulated_frametime = Clock::duration::zero();
@@ -14,6 +14,9 @@ enum class PacketType {
     Undefined = 0,
     ReadMemory,
     WriteMemory,
+    SetIPCProfilerEnabled,
+    ResetIPCProfiler,
+    ReadIPCProfile,
 };
 
 struct PacketHeader {
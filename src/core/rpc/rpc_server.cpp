@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <cstring>
 #include "common/logging/log.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
 #include "core/rpc/packet.h"
@@ -52,11 +56,49 @@ void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u
     packet.SendReply();
 }
 
+void RPCServer::HandleSetIPCProfilerEnabled(Packet& packet, bool enabled) {
+    Core::System& system = Core::System::GetInstance();
+    if (system.IsPoweredOn()) {
+        system.Kernel().GetIPCProfiler().SetEnabled(enabled);
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+void RPCServer::HandleResetIPCProfiler(Packet& packet) {
+    Core::System& system = Core::System::GetInstance();
+    if (system.IsPoweredOn()) {
+        system.Kernel().GetIPCProfiler().Reset();
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+void RPCServer::HandleReadIPCProfile(Packet& packet, u32 offset, u32 data_size) {
+    // The report doesn't fit in a packet, so clients read it in chunks until an empty reply.
+    if (offset == 0) {
+        Core::System& system = Core::System::GetInstance();
+        ipc_profile_report =
+            system.IsPoweredOn() ? system.Kernel().GetIPCProfiler().GetReport() : std::string{};
+    }
+
+    u32 size = 0;
+    if (offset < ipc_profile_report.size()) {
+        size = std::min<u32>(data_size, static_cast<u32>(ipc_profile_report.size() - offset));
+        std::memcpy(packet.GetPacketData().data(), ipc_profile_report.data() + offset, size);
+    }
+    packet.SetPacketDataSize(size);
+    packet.SendReply();
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
         case PacketType::ReadMemory:
         case PacketType::WriteMemory:
+        case PacketType::SetIPCProfilerEnabled:
+        case PacketType::ResetIPCProfiler:
+        case PacketType::ReadIPCProfile:
             if (packet_header.packet_size >= (sizeof(u32) * 2)) {
                 return true;
             }
@@ -93,6 +135,22 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
                 success = true;
             }
             break;
+        case PacketType::SetIPCProfilerEnabled:
+            // The address field holds the new status
+            HandleSetIPCProfilerEnabled(*request_packet, address != 0);
+            success = true;
+            break;
+        case PacketType::ResetIPCProfiler:
+            HandleResetIPCProfiler(*request_packet);
+            success = true;
+            break;
+        case PacketType::ReadIPCProfile:
+            // The address field holds the offset in the report
+            if (data_size > 0 && data_size <= MAX_READ_SIZE) {
+                HandleReadIPCProfile(*request_packet, address, data_size);
+                success = true;
+            }
+            break;
         default:
             break;
         }
@@ -7,6 +7,7 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include "common/threadsafe_queue.h"
 #include "core/rpc/server.h"
@@ -28,6 +29,9 @@ private:
     void Stop();
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size);
+    void HandleSetIPCProfilerEnabled(Packet& packet, bool enabled);
+    void HandleResetIPCProfiler(Packet& packet);
+    void HandleReadIPCProfile(Packet& packet, u32 offset, u32 data_size);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop();
@@ -35,6 +39,9 @@ private:
     Server server;
     Common::SPSCQueue<std::unique_ptr<Packet>> request_queue;
     std::thread request_handler_thread;
+
+    // Snapshot of the IPC profiler report, taken when it is read from offset 0
+    std::string ipc_profile_report;
 };
 
 } // namespace RPC
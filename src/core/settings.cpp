@@ -6,6 +6,8 @@
 #include "audio_core/dsp_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/shared_page.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/ir/ir_rst.h"
@@ -42,6 +44,7 @@ void Apply() {
         system.CoreTiming().UpdateClockSpeed(values.cpu_clock_percentage);
         Core::DSP().SetSink(values.sink_id, values.audio_device_id);
         Core::DSP().EnableStretching(values.enable_audio_stretching);
+        system.Kernel().GetIPCProfiler().SetEnabled(values.profile_ipc);
 
         std::shared_ptr<Service::HID::Module> hid = Service::HID::GetModule(system);
         if (hid) {
@@ -81,13 +84,17 @@ void LogSettings() {
     LOG_INFO(Config, "Citra Valentin Configuration:");
     LogSetting("use_cpu_jit", Settings::values.use_cpu_jit);
     LogSetting("use_hw_renderer", Settings::values.use_hw_renderer);
+    LogSetting("use_gpu_thread", Settings::values.use_gpu_thread);
     LogSetting("use_hw_shader", Settings::values.use_hw_shader);
     LogSetting("shaders_accurate_mul", Settings::values.shaders_accurate_mul);
     LogSetting("use_shader_jit", Settings::values.use_shader_jit);
+    LogSetting("use_async_shader_compilation", Settings::values.use_async_shader_compilation);
     LogSetting("resolution_factor", Settings::values.resolution_factor);
     LogSetting("use_frame_limit", Settings::values.use_frame_limit);
     LogSetting("frame_limit", Settings::values.frame_limit);
     LogSetting("min_vertices_per_thread", Settings::values.min_vertices_per_thread);
+    LogSetting("texture_memory_budget", Settings::values.texture_memory_budget);
+    LogSetting("hash_texture_uploads", Settings::values.hash_texture_uploads);
     LogSetting("pp_shader_name", Settings::values.pp_shader_name);
     LogSetting("filter_mode", Settings::values.filter_mode);
     LogSetting("render_3d", static_cast<int>(Settings::values.render_3d));
@@ -97,6 +104,7 @@ void LogSettings() {
     LogSetting("swap_screen", Settings::values.swap_screen);
     LogSetting("dump_textures", Settings::values.dump_textures);
     LogSetting("custom_textures", Settings::values.custom_textures);
+    LogSetting("video_dumping_queue_depth", Settings::values.video_dumping_queue_depth);
     LogSetting("enable_dsp_lle", Settings::values.enable_dsp_lle);
     LogSetting("enable_dsp_lle_multithread", Settings::values.enable_dsp_lle_multithread);
     LogSetting("sink_id", Settings::values.sink_id);
@@ -116,6 +124,7 @@ void LogSettings() {
     LogSetting("use_virtual_sd", Settings::values.use_virtual_sd);
     LogSetting("is_new_3ds", Settings::values.is_new_3ds);
     LogSetting("region_value", Settings::values.region_value);
+    LogSetting("profile_ipc", Settings::values.profile_ipc);
     LogSetting("use_gdbstub", Settings::values.use_gdbstub);
     LogSetting("gdbstub_port", Settings::values.gdbstub_port);
     LogSetting("sharper_distant_objects", Settings::values.sharper_distant_objects);
@@ -125,6 +134,7 @@ void LogSettings() {
     LogSetting("use_custom_cpu_ticks", Settings::values.use_custom_cpu_ticks);
     LogSetting("custom_cpu_ticks", Settings::values.custom_cpu_ticks);
     LogSetting("cpu_clock_percentage", Settings::values.cpu_clock_percentage);
+    LogSetting("skip_idle_loops", Settings::values.skip_idle_loops);
     LogSetting("use_vsync_new", Settings::values.use_vsync_new);
     LogSetting("audio_speed", Settings::values.audio_speed);
 }
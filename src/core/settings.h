@@ -132,6 +132,7 @@ struct Values {
     bool use_custom_cpu_ticks;
     u64 custom_cpu_ticks;
     int cpu_clock_percentage;
+    bool skip_idle_loops;
 
     // Data Storage
     bool use_virtual_sd;
@@ -143,14 +144,18 @@ struct Values {
 
     // Renderer
     bool use_hw_renderer;
+    bool use_gpu_thread;
     bool use_hw_shader;
     bool enable_disk_shader_cache;
+    bool use_async_shader_compilation;
     bool shaders_accurate_mul;
     bool use_shader_jit;
     u16 resolution_factor;
     bool use_frame_limit;
     u16 frame_limit;
     int min_vertices_per_thread;
+    u32 texture_memory_budget;
+    bool hash_texture_uploads;
 
     LayoutOption layout_option;
     bool swap_screen;
@@ -178,6 +183,8 @@ struct Values {
     bool custom_textures;
     bool preload_textures;
 
+    u32 video_dumping_queue_depth;
+
     bool use_vsync_new;
 
     // Audio
@@ -198,6 +205,7 @@ struct Values {
 
     // Debugging
     bool record_frame_times;
+    bool profile_ipc;
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string log_filter;
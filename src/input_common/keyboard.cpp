@@ -53,6 +53,7 @@ public:
                 pair.key_button->status.store(pressed);
             }
         }
+        Input::NotifyInputEvent();
     }
 
     void ChangeAllKeyStatus(bool pressed) {
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cmath>
 #include <functional>
@@ -19,6 +20,7 @@
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/param_package.h"
+#include "common/seqlock.h"
 #include "common/threadsafe_queue.h"
 #include "core/frontend/input.h"
 #include "input_common/sdl/sdl_impl.h"
@@ -55,28 +57,52 @@ public:
         : guid{std::move(guid_)}, port{port_}, sdl_joystick{joystick, deleter} {}
 
     void SetButton(int button, bool value) {
-        std::lock_guard<std::mutex> lock(mutex);
-        state.buttons[button] = value;
+        if (button < 0 || button >= MaxButtons) {
+            return;
+        }
+        state.Modify([&](State& current) {
+            if (current.buttons[button] != value) {
+                current.buttons[button] = value;
+                Input::NotifyInputEvent();
+            }
+        });
     }
 
     bool GetButton(int button) const {
-        std::lock_guard<std::mutex> lock(mutex);
-        return state.buttons.at(button);
+        if (button < 0 || button >= MaxButtons) {
+            return false;
+        }
+        return GetState().buttons[button];
     }
 
     void SetAxis(int axis, Sint16 value) {
-        std::lock_guard<std::mutex> lock(mutex);
-        state.axes[axis] = value;
+        if (axis < 0 || axis >= MaxAxes) {
+            return;
+        }
+        state.Modify([&](State& current) {
+            if (current.axes[axis] != value) {
+                current.axes[axis] = value;
+                Input::NotifyInputEvent();
+            }
+        });
     }
 
     float GetAxis(int axis) const {
-        std::lock_guard<std::mutex> lock(mutex);
-        return state.axes.at(axis) / 32767.0f;
+        if (axis < 0 || axis >= MaxAxes) {
+            return 0.0f;
+        }
+        return GetState().axes[axis] / 32767.0f;
     }
 
     std::tuple<float, float> GetAnalog(int axis_x, int axis_y) const {
-        float x = GetAxis(axis_x);
-        float y = GetAxis(axis_y);
+        if (axis_x < 0 || axis_x >= MaxAxes || axis_y < 0 || axis_y >= MaxAxes) {
+            return {0.0f, 0.0f};
+        }
+        // Both axes come from the same snapshot, so a stick moving diagonally is never seen
+        // with only one of its axes updated
+        const State& snapshot = GetState();
+        float x = snapshot.axes[axis_x] / 32767.0f;
+        float y = snapshot.axes[axis_y] / 32767.0f;
         y = -y; // 3DS uses an y-axis inverse from SDL
 
         // Make sure the coordinates are in the unit circle,
@@ -92,13 +118,22 @@ public:
     }
 
     void SetHat(int hat, Uint8 direction) {
-        std::lock_guard<std::mutex> lock(mutex);
-        state.hats[hat] = direction;
+        if (hat < 0 || hat >= MaxHats) {
+            return;
+        }
+        state.Modify([&](State& current) {
+            if (current.hats[hat] != direction) {
+                current.hats[hat] = direction;
+                Input::NotifyInputEvent();
+            }
+        });
     }
 
     bool GetHatDirection(int hat, Uint8 direction) const {
-        std::lock_guard<std::mutex> lock(mutex);
-        return (state.hats.at(hat) & direction) != 0;
+        if (hat < 0 || hat >= MaxHats) {
+            return false;
+        }
+        return (GetState().hats[hat] & direction) != 0;
     }
 
     /**
@@ -126,15 +161,42 @@ public:
     }
 
 private:
+    static constexpr int MaxButtons = 128;
+    static constexpr int MaxAxes = 32;
+    static constexpr int MaxHats = 8;
+
     struct State {
-        std::unordered_map<int, bool> buttons;
-        std::unordered_map<int, Sint16> axes;
-        std::unordered_map<int, Uint8> hats;
-    } state;
+        std::array<bool, MaxButtons> buttons;
+        std::array<Sint16, MaxAxes> axes;
+        std::array<Uint8, MaxHats> hats;
+    };
+
+    /**
+     * Returns the joystick state as of the current input poll. The polling thread copies the shared
+     * state once per poll, other threads copy it on every call.
+     */
+    const State& GetState() const {
+        const u64 generation = Input::GetPollGeneration();
+        if (generation == 0) {
+            thread_local State unpolled_state;
+            unpolled_state = state.Read();
+            return unpolled_state;
+        }
+        if (generation != polled_generation) {
+            polled_state = state.Read();
+            polled_generation = generation;
+        }
+        return polled_state;
+    }
+
+    /// Written by the SDL event thread, read by the emulation thread without locking
+    Common::SeqLock<State> state;
+    /// Snapshot of state taken by the polling thread, only accessed by that thread
+    mutable State polled_state{};
+    mutable u64 polled_generation = 0;
     std::string guid;
     int port;
     std::unique_ptr<SDL_Joystick, decltype(&SDL_JoystickClose)> sdl_joystick;
-    mutable std::mutex mutex;
 };
 
 /**
@@ -409,8 +471,6 @@ public:
             } else {
                 direction = 0;
             }
-            // This is necessary so accessing GetHat with hat won't crash
-            joystick->SetHat(hat, SDL_HAT_CENTERED);
             return std::make_unique<SDLDirectionButton>(joystick, hat, direction);
         }
 
@@ -427,14 +487,10 @@ public:
                 trigger_if_greater = true;
                 LOG_ERROR(Input, "Unknown direction {}", direction_name);
             }
-            // This is necessary so accessing GetAxis with axis won't crash
-            joystick->SetAxis(axis, 0);
             return std::make_unique<SDLAxisButton>(joystick, axis, threshold, trigger_if_greater);
         }
 
         const int button = params.Get("button", 0);
-        // This is necessary so accessing GetButton with button won't crash
-        joystick->SetButton(button, false);
         return std::make_unique<SDLButton>(joystick, button);
     }
 
@@ -464,9 +520,6 @@ public:
         std::shared_ptr<InputCommon::SDL::SDLJoystick> joystick =
             state.GetSDLJoystickByGUID(guid, port);
 
-        // This is necessary so accessing GetAxis with axis_x and axis_y won't crash
-        joystick->SetAxis(axis_x, 0);
-        joystick->SetAxis(axis_y, 0);
         return std::make_unique<SDLAnalog>(joystick, axis_x, axis_y, deadzone);
     }
 
@@ -495,9 +548,11 @@ SDLState::SDLState() {
     if (start_thread) {
         poll_thread = std::thread([this] {
             using namespace std::chrono_literals;
+            // SDL has no way to block until a joystick event arrives, so poll often enough that
+            // pumping adds at most a millisecond of latency
             while (initialized) {
                 SDL_PumpEvents();
-                std::this_thread::sleep_for(10ms);
+                std::this_thread::sleep_for(1ms);
             }
         });
     }
@@ -0,0 +1,92 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <catch2/catch.hpp>
+#include "audio_core/audio_output.h"
+#include "audio_core/audio_types.h"
+
+namespace {
+thread_local bool count_allocations = false;
+thread_local std::size_t allocation_count = 0;
+} // Anonymous namespace
+
+// Counts allocations made by the current thread while count_allocations is set. Replacing the
+// global operator affects the whole test binary, but only adds a thread local check otherwise.
+void* operator new(std::size_t size) {
+    if (count_allocations) {
+        ++allocation_count;
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+/// Pushes and pulls a frame at a time, as the DSP and the sink do.
+void RunFrames(AudioCore::AudioOutput& output, int count) {
+    std::array<s16, AudioCore::samples_per_frame * 2> in{};
+    std::array<s16, AudioCore::samples_per_frame * 2> out{};
+    for (int i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < in.size(); ++j) {
+            in[j] = static_cast<s16>((i * 37 + j * 11) & 0x3FFF);
+        }
+        output.Push(in.data(), AudioCore::samples_per_frame);
+        output.Pull(out.data(), AudioCore::samples_per_frame);
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("AudioOutput::Pull does not allocate", "[audio_core]") {
+    AudioCore::AudioOutput output;
+    output.SetOutputSampleRate(AudioCore::native_sample_rate);
+
+    SECTION("without time stretching") {
+        output.EnableStretching(false);
+    }
+    SECTION("with time stretching") {
+        output.EnableStretching(true);
+    }
+
+    // Let the time stretcher size its internal buffers first
+    RunFrames(output, 200);
+
+    allocation_count = 0;
+    count_allocations = true;
+    RunFrames(output, 200);
+    count_allocations = false;
+
+    REQUIRE(allocation_count == 0);
+}
+
+TEST_CASE("AudioOutput counts underruns", "[audio_core]") {
+    AudioCore::AudioOutput output;
+    std::array<s16, 64 * 2> in{};
+    std::array<s16, 64 * 2> out{};
+
+    output.Push(in.data(), 64);
+    output.Pull(out.data(), 64);
+    REQUIRE(output.GetStats().underruns == 0);
+
+    output.Push(in.data(), 16);
+    output.Pull(out.data(), 64);
+    const AudioCore::AudioOutput::Stats stats = output.GetStats();
+    REQUIRE(stats.callbacks == 2);
+    REQUIRE(stats.underruns == 1);
+    REQUIRE(stats.underrun_frames == 48);
+
+    output.ResetStats();
+    REQUIRE(output.GetStats().callbacks == 0);
+}
@@ -0,0 +1,81 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/mixers.h"
+#include "audio_core/hle/shared_memory.h"
+
+namespace {
+using AudioCore::QuadFrame32;
+using AudioCore::StereoFrame16;
+using AudioCore::HLE::DspConfiguration;
+
+s16 ClampToS16(s32 value) {
+    return static_cast<s16>(std::clamp(value, -32768, 32767));
+}
+
+/// The per-sample downmix the mixer implements, kept scalar as a reference
+StereoFrame16 ReferenceMix(DspConfiguration::OutputFormat format,
+                           const std::array<float, 3>& volumes,
+                           const std::array<QuadFrame32, 3>& input) {
+    StereoFrame16 output{};
+    for (std::size_t mix = 0; mix < 3; ++mix) {
+        const float gain = volumes[mix];
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            const std::array<s32, 4>& sample = input[mix][i];
+            s16 left, right;
+            if (format == DspConfiguration::OutputFormat::Mono) {
+                left = right = ClampToS16(static_cast<s32>(
+                    (gain * sample[0] + gain * sample[1] + gain * sample[2] + gain * sample[3]) /
+                    2));
+            } else {
+                left = ClampToS16(static_cast<s32>(gain * sample[0] + gain * sample[2]));
+                right = ClampToS16(static_cast<s32>(gain * sample[1] + gain * sample[3]));
+            }
+            output[i][0] = ClampToS16(output[i][0] + left);
+            output[i][1] = ClampToS16(output[i][1] + right);
+        }
+    }
+    return output;
+}
+} // Anonymous namespace
+
+TEST_CASE("HLE Mixers downmix matches the per-sample mix", "[audio_core][hle]") {
+    const auto format = GENERATE(DspConfiguration::OutputFormat::Mono,
+                                 DspConfiguration::OutputFormat::Stereo);
+    const std::array<float, 3> volumes{0.8f, 0.37f, 1.25f};
+
+    // Large enough that some frames saturate, at the downmix and when accumulating the mixes
+    std::array<QuadFrame32, 3> input;
+    u32 seed = 1;
+    for (QuadFrame32& frame : input) {
+        for (std::array<s32, 4>& sample : frame) {
+            for (s32& channel : sample) {
+                seed = seed * 1103515245 + 12345;
+                channel = static_cast<s32>(seed >> 8) % 80000 - 40000;
+            }
+        }
+    }
+
+    DspConfiguration config;
+    std::memset(&config, 0, sizeof(config));
+    config.volume_0_dirty.Assign(1);
+    config.volume_1_dirty.Assign(1);
+    config.volume_2_dirty.Assign(1);
+    config.output_format_dirty.Assign(1);
+    for (std::size_t mix = 0; mix < 3; ++mix) {
+        config.volume[mix] = volumes[mix];
+    }
+    config.output_format = format;
+
+    AudioCore::HLE::Mixers mixers;
+    AudioCore::HLE::IntermediateMixSamples read_samples{};
+    AudioCore::HLE::IntermediateMixSamples write_samples{};
+    mixers.Tick(config, read_samples, write_samples, input);
+
+    REQUIRE(mixers.GetOutput() == ReferenceMix(format, volumes, input));
+}
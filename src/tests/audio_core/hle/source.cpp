@@ -0,0 +1,96 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/shared_memory.h"
+#include "audio_core/hle/source.h"
+#include "core/memory.h"
+
+namespace {
+using Configuration = AudioCore::HLE::SourceConfiguration::Configuration;
+
+constexpr u32 BufferLength = 0x4000; // samples
+
+/// Configures a source to loop a buffer at address, feeding all three intermediate mixes.
+void ConfigureSource(Configuration& config, PAddr address, Configuration::Format format,
+                     Configuration::MonoOrStereo mono_or_stereo, float rate) {
+    std::memset(&config, 0, sizeof(config));
+    config.enable = 1;
+    config.enable_dirty.Assign(1);
+    config.rate_multiplier = rate;
+    config.rate_multiplier_dirty.Assign(1);
+    config.interpolation_mode = Configuration::InterpolationMode::Linear;
+    config.interpolation_dirty.Assign(1);
+    config.format.Assign(format);
+    config.format_dirty.Assign(1);
+    config.mono_or_stereo.Assign(mono_or_stereo);
+    config.mono_or_stereo_dirty.Assign(1);
+    config.adpcm_coefficients_dirty.Assign(1);
+    for (std::size_t mix = 0; mix < 3; ++mix) {
+        for (std::size_t channel = 0; channel < 4; ++channel) {
+            config.gain[mix][channel] = 0.5f;
+        }
+    }
+    config.gain_0_dirty.Assign(1);
+    config.gain_1_dirty.Assign(1);
+    config.gain_2_dirty.Assign(1);
+    config.physical_address = address;
+    config.length = BufferLength;
+    config.is_looping.Assign(1);
+    config.embedded_buffer_dirty.Assign(1);
+}
+} // Anonymous namespace
+
+TEST_CASE("HLE Source 24 source benchmark", "[.][benchmark][audio_core]") {
+    Memory::MemorySystem memory;
+
+    // Fill the buffers with noise, so that the ADPCM decoder does real work
+    u8* const fcram = memory.GetFCRAMPointer(0);
+    u32 seed = 1;
+    for (std::size_t i = 0; i < BufferLength * 4; ++i) {
+        seed = seed * 1103515245 + 12345;
+        fcram[i] = static_cast<u8>(seed >> 16);
+    }
+
+    const s16_le adpcm_coeffs[16] = {};
+    std::array<std::unique_ptr<AudioCore::HLE::Source>, AudioCore::HLE::num_sources> sources;
+    std::array<Configuration, AudioCore::HLE::num_sources> configs;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        sources[i] = std::make_unique<AudioCore::HLE::Source>(i);
+        sources[i]->SetMemory(memory);
+
+        // A mix of every format, at rates that need resampling
+        const auto format = static_cast<Configuration::Format>(i % 3);
+        const auto mono_or_stereo = format == Configuration::Format::ADPCM || i % 2 == 0
+                                        ? Configuration::MonoOrStereo::Mono
+                                        : Configuration::MonoOrStereo::Stereo;
+        ConfigureSource(configs[i], Memory::FCRAM_PADDR, format, mono_or_stereo,
+                        0.75f + 0.05f * static_cast<float>(i));
+    }
+
+    constexpr int frames = 20000;
+    std::array<AudioCore::QuadFrame32, 3> mixes{};
+    u64 checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        mixes = {};
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            sources[i]->Tick(configs[i], adpcm_coeffs);
+            for (std::size_t mix = 0; mix < mixes.size(); ++mix) {
+                sources[i]->MixInto(mixes[mix], mix);
+            }
+        }
+        checksum += static_cast<u32>(mixes[0][frame % AudioCore::samples_per_frame][0]);
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    WARN("24 sources: " << elapsed / frames << " ns per frame (checksum " << checksum << ")");
+}
@@ -0,0 +1,105 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cmath>
+#include <catch2/catch.hpp>
+#include "audio_core/interpolate.h"
+
+namespace {
+using Interpolator = void (*)(AudioCore::AudioInterp::State&,
+                              const AudioCore::AudioInterp::StereoBuffer16&, std::size_t&, float,
+                              AudioCore::StereoFrame16&, std::size_t&);
+
+constexpr double pi = 3.14159265358979323846;
+
+/// Resamples a sine wave with the given period (in input samples) and returns the RMS error of
+/// the output, relative to the amplitude.
+double MeasureError(Interpolator interpolate, double period, float rate, int frames) {
+    constexpr double amplitude = 16000.0;
+    const auto signal = [period](double t) { return amplitude * std::sin(2.0 * pi * t / period); };
+
+    AudioCore::AudioInterp::State state;
+    AudioCore::AudioInterp::StereoBuffer16 input;
+    std::size_t inputi = 0;
+    std::size_t next_input = 0;
+
+    double error = 0.0;
+    std::size_t count = 0;
+    double position = 0.0;
+    for (int frame = 0; frame < frames; frame++) {
+        AudioCore::StereoFrame16 output{};
+        std::size_t outputi = 0;
+        while (outputi < output.size()) {
+            if (AudioCore::AudioInterp::IsBufferConsumed(input, inputi)) {
+                AudioCore::AudioInterp::StartBuffer(state, input, inputi);
+                for (int i = 0; i < 100; i++, next_input++) {
+                    const s16 sample = static_cast<s16>(std::lround(signal(next_input)));
+                    input.push_back({sample, sample});
+                }
+            }
+            interpolate(state, input, inputi, rate, output, outputi);
+        }
+
+        for (const auto& sample : output) {
+            // Outputs are two samples behind the input. Skip the first few, made from silence.
+            const double expected = signal(position - 2.0);
+            if (position > 8.0) {
+                error += (sample[0] - expected) * (sample[0] - expected);
+                count++;
+            }
+            position += static_cast<double>(static_cast<u64>(rate * (1 << 24))) / (1 << 24);
+        }
+    }
+    return std::sqrt(error / count) / amplitude;
+}
+} // Anonymous namespace
+
+TEST_CASE("AudioInterp::Polyphase is more accurate than Linear", "[audio_core]") {
+    for (const float rate : {0.5f, 0.9f, 1.3f}) {
+        const double linear = MeasureError(AudioCore::AudioInterp::Linear, 12.0, rate, 20);
+        const double polyphase = MeasureError(AudioCore::AudioInterp::Polyphase, 12.0, rate, 20);
+        REQUIRE(polyphase < linear);
+    }
+}
+
+TEST_CASE("AudioInterp benchmark", "[.][benchmark][audio_core]") {
+    const std::array<std::pair<const char*, Interpolator>, 3> modes{{
+        {"None", AudioCore::AudioInterp::None},
+        {"Linear", AudioCore::AudioInterp::Linear},
+        {"Polyphase", AudioCore::AudioInterp::Polyphase},
+    }};
+
+    for (const auto& [name, interpolate] : modes) {
+        // Accuracy on a low and a high frequency tone
+        const double low_error = MeasureError(interpolate, 40.0, 0.9f, 200);
+        const double high_error = MeasureError(interpolate, 6.0, 0.9f, 200);
+
+        // Throughput for 24 sources, as many as the DSP mixes each frame
+        AudioCore::AudioInterp::StereoBuffer16 input(0x4000 + 3);
+        for (std::size_t i = 0; i < input.size(); i++) {
+            input[i] = {static_cast<s16>(i * 37), static_cast<s16>(i * 91)};
+        }
+        AudioCore::AudioInterp::State state;
+        AudioCore::StereoFrame16 output;
+        constexpr int frames = 20000;
+        constexpr int sources = 24;
+        s64 checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames * sources; frame++) {
+            std::size_t inputi = 0;
+            std::size_t outputi = 0;
+            state.fposition = 0;
+            interpolate(state, input, inputi, 1.3f, output, outputi);
+            checksum += output[frame % output.size()][0];
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+        WARN(name << ": RMS error " << low_error << " (low tone), " << high_error
+                  << " (high tone), " << elapsed / frames << " ns per frame for " << sources
+                  << " sources (checksum " << checksum << ")");
+    }
+}
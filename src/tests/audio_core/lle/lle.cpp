@@ -0,0 +1,118 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/lle/lle.h"
+#include "common/file_util.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+
+namespace {
+/// Emulated CPU ticks between two DSP slice events
+constexpr s64 TicksPerSlice = 40000;
+
+/// The tests need a DSP firmware dumped from a console, placed in the sysdata directory.
+std::vector<u8> LoadFirmware() {
+    FileUtil::IOFile file(FileUtil::GetUserPath(FileUtil::UserPath::SysDataDir) + "dspfirm.cdc",
+                          "rb");
+    if (!file.IsOpen()) {
+        return {};
+    }
+    std::vector<u8> firmware(file.GetSize());
+    file.ReadBytes(firmware.data(), firmware.size());
+    return firmware;
+}
+
+/**
+ * Emulates the given number of DSP slices, raising the semaphore once per audio frame as games
+ * do. arm_work is spent busy waiting on the emulation thread before each slice, standing in for
+ * the CPU emulation that multithread mode overlaps with the DSP.
+ */
+void RunSlices(Core::Timing& timing, AudioCore::DspLle& dsp, int slices,
+               std::chrono::nanoseconds arm_work) {
+    for (int slice = 0; slice < slices; ++slice) {
+        const auto until = std::chrono::steady_clock::now() + arm_work;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+        if (slice % 4 == 0) {
+            dsp.SetSemaphore(0x4000);
+        }
+        timing.AddTicks(TicksPerSlice);
+        timing.Advance();
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("DSP LLE deterministic multithread mode matches single thread mode", "[audio_core]") {
+    const std::vector<u8> firmware = LoadFirmware();
+    if (firmware.empty()) {
+        WARN("dspfirm.cdc not found, skipping");
+        return;
+    }
+
+    Memory::MemorySystem single_memory;
+    Core::Timing single_timing(100);
+    AudioCore::DspLle single(single_memory, single_timing, false);
+    Memory::MemorySystem multi_memory;
+    Core::Timing multi_timing(100);
+    AudioCore::DspLle multi(multi_memory, multi_timing, true, true);
+
+    single_timing.Advance();
+    multi_timing.Advance();
+    single.LoadComponent(firmware);
+    multi.LoadComponent(firmware);
+    RunSlices(single_timing, single, 200, {});
+    RunSlices(multi_timing, multi, 200, {});
+
+    REQUIRE(single.GetDspMemory() == multi.GetDspMemory());
+
+    single.UnloadComponent();
+    multi.UnloadComponent();
+}
+
+TEST_CASE("DSP LLE benchmark", "[.][benchmark][audio_core]") {
+    const std::vector<u8> firmware = LoadFirmware();
+    if (firmware.empty()) {
+        WARN("dspfirm.cdc not found, skipping");
+        return;
+    }
+
+    struct Mode {
+        const char* name;
+        bool multithread;
+        bool deterministic;
+    };
+    constexpr std::array<Mode, 3> modes{{
+        {"single thread", false, false},
+        {"multithread", true, false},
+        {"multithread (deterministic)", true, true},
+    }};
+
+    // One emulated second, at the CPU clock rate
+    constexpr int slices = static_cast<int>(BASE_CLOCK_RATE_ARM11 / TicksPerSlice);
+    constexpr std::chrono::microseconds arm_work{50};
+
+    for (const Mode& mode : modes) {
+        Memory::MemorySystem memory;
+        Core::Timing timing(100);
+        AudioCore::DspLle dsp(memory, timing, mode.multithread, mode.deterministic);
+        timing.Advance();
+        dsp.LoadComponent(firmware);
+
+        const auto start = std::chrono::steady_clock::now();
+        RunSlices(timing, dsp, slices, arm_work);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+        dsp.UnloadComponent();
+
+        WARN(mode.name << ": " << elapsed / 1000 << " ms per emulated second, "
+                       << (elapsed - arm_work.count() * slices) / 1000
+                       << " ms of it spent on the DSP");
+    }
+}
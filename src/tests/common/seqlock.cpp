@@ -0,0 +1,48 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <catch2/catch.hpp>
+#include "common/seqlock.h"
+
+namespace {
+/// Bigger than one word, and with a size that isn't a multiple of one
+struct Snapshot {
+    std::array<u32, 9> values;
+    u8 tail;
+};
+} // Anonymous namespace
+
+TEST_CASE("SeqLock readers never see a partial write", "[common]") {
+    Common::SeqLock<Snapshot> lock;
+    REQUIRE(lock.Read().values[0] == 0);
+
+    constexpr u32 writes = 100000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (u32 i = 1; i <= writes; ++i) {
+            lock.Modify([i](Snapshot& snapshot) {
+                snapshot.values.fill(i);
+                snapshot.tail = static_cast<u8>(i);
+            });
+        }
+        done = true;
+    });
+
+    u32 previous = 0;
+    while (!done) {
+        const Snapshot snapshot = lock.Read();
+        for (const u32 value : snapshot.values) {
+            REQUIRE(value == snapshot.values[0]);
+        }
+        REQUIRE(snapshot.tail == static_cast<u8>(snapshot.values[0]));
+        REQUIRE(snapshot.values[0] >= previous);
+        previous = snapshot.values[0];
+    }
+    writer.join();
+
+    REQUIRE(lock.Read().values[8] == writes);
+}
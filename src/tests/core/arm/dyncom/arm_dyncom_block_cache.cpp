@@ -0,0 +1,60 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/dyncom/arm_dyncom_block_cache.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+TEST_CASE("BlockCache only invalidates overlapping blocks", "[arm_dyncom]") {
+    BlockCache cache;
+    cache.Insert(0x1000, 0x1010, 0);
+    cache.Insert(0x1FF0, 0x2008, 100); // Crosses into the next page
+    cache.Insert(0x3000, 0x3004, 200);
+    REQUIRE(cache.Find(0x1000) == 0);
+    REQUIRE(cache.Find(0x1004) == BlockCache::NotFound);
+
+    const u32 generation = cache.Generation();
+    cache.InvalidateRange(0x2000, 4);
+    REQUIRE(cache.Generation() != generation);
+    REQUIRE(cache.Find(0x1000) == 0);
+    REQUIRE(cache.Find(0x1FF0) == BlockCache::NotFound);
+    REQUIRE(cache.Find(0x3000) == 200);
+
+    // Nothing was translated from here, so links stay valid
+    const u32 unchanged = cache.Generation();
+    cache.InvalidateRange(0x1800, 0x10);
+    REQUIRE(cache.Generation() == unchanged);
+
+    cache.Clear();
+    REQUIRE(cache.Find(0x3000) == BlockCache::NotFound);
+}
+
+TEST_CASE("ARM_DynCom: InvalidateCacheRange retranslates written code", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0, 0xE3A00001); // mov r0, #1
+    test_env.SetMemory32(4, 0xEAFFFFFD); // b #0
+
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE);
+    dyncom.SetPC(0);
+    dyncom.Step();
+    REQUIRE(dyncom.GetReg(0) == 1);
+
+    test_env.SetMemory32(0, 0xE3A00002); // mov r0, #2
+
+    // Writes elsewhere keep the old translation
+    dyncom.InvalidateCacheRange(0x1000, 4);
+    dyncom.SetPC(0);
+    dyncom.Step();
+    REQUIRE(dyncom.GetReg(0) == 1);
+
+    dyncom.InvalidateCacheRange(0, 4);
+    dyncom.SetPC(0);
+    dyncom.Step();
+    REQUIRE(dyncom.GetReg(0) == 2);
+}
+
+} // namespace ArmTests
@@ -0,0 +1,174 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/catch.hpp>
+#include "core/arm/idle_loop_detector.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+namespace {
+
+constexpr u32 ARM_CPSR = 0x10;            // User mode
+constexpr u32 THUMB_CPSR = 0x10 | 1 << 5; // User mode, Thumb
+
+std::array<u32, 16> MakeRegs(VAddr pc) {
+    std::array<u32, 16> regs{};
+    regs[0] = 0x2000; // Polled address
+    regs[15] = pc;
+    return regs;
+}
+
+/// Samples the same state twice, as if two timing slices ended inside the loop.
+bool SampleTwice(IdleLoopDetector& detector, const std::array<u32, 16>& regs, u32 cpsr) {
+    detector.Sample(regs, cpsr);
+    return detector.Sample(regs, cpsr);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("IdleLoopDetector detects ARM polling loops", "[arm][idle_loop]") {
+    TestEnvironment test_env(false);
+    IdleLoopDetector detector(test_env.GetMemory());
+
+    test_env.SetMemory32(0x100, 0xE5901000); // ldr r1, [r0]
+    test_env.SetMemory32(0x104, 0xE3510000); // cmp r1, #0
+    test_env.SetMemory32(0x108, 0x0AFFFFFC); // beq 0x100
+
+    auto regs = MakeRegs(0x100);
+    REQUIRE(!detector.Sample(regs, ARM_CPSR));
+
+    // Registers written by the loop may differ between samples
+    regs[1] = 0x1234;
+    regs[15] = 0x104;
+    REQUIRE(detector.Sample(regs, ARM_CPSR));
+
+    SECTION("a different loop-invariant register is not the same state") {
+        regs[0] = 0x3000;
+        REQUIRE(!detector.Sample(regs, ARM_CPSR));
+        REQUIRE(detector.Sample(regs, ARM_CPSR));
+    }
+
+    SECTION("Reset forgets the previous sample") {
+        detector.Reset();
+        REQUIRE(!detector.Sample(regs, ARM_CPSR));
+    }
+}
+
+TEST_CASE("IdleLoopDetector rejects ARM loops that are not idle", "[arm][idle_loop]") {
+    TestEnvironment test_env(false);
+    IdleLoopDetector detector(test_env.GetMemory());
+
+    SECTION("loop storing to memory") {
+        test_env.SetMemory32(0x100, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(0x104, 0xE5801004); // str r1, [r0, #4]
+        test_env.SetMemory32(0x108, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(0x10C, 0x0AFFFFFB); // beq 0x100
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x100), ARM_CPSR));
+    }
+
+    SECTION("loop calling an SVC") {
+        test_env.SetMemory32(0x100, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(0x104, 0xEF00000A); // svc #0xA
+        test_env.SetMemory32(0x108, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(0x10C, 0x0AFFFFFB); // beq 0x100
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x100), ARM_CPSR));
+    }
+
+    SECTION("loop carrying a spin counter") {
+        test_env.SetMemory32(0x100, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(0x104, 0xE2822001); // add r2, r2, #1
+        test_env.SetMemory32(0x108, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(0x10C, 0x0AFFFFFB); // beq 0x100
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x100), ARM_CPSR));
+    }
+
+    SECTION("loop calling a function") {
+        test_env.SetMemory32(0x100, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(0x104, 0xEB000100); // bl 0x50C
+        test_env.SetMemory32(0x108, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(0x10C, 0x0AFFFFFB); // beq 0x100
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x100), ARM_CPSR));
+    }
+}
+
+TEST_CASE("IdleLoopDetector detects Thumb polling loops", "[arm][idle_loop]") {
+    TestEnvironment test_env(false);
+    IdleLoopDetector detector(test_env.GetMemory());
+
+    test_env.SetMemory16(0x200, 0x6801); // ldr r1, [r0, #0]
+    test_env.SetMemory16(0x202, 0x2900); // cmp r1, #0
+    test_env.SetMemory16(0x204, 0xD0FC); // beq 0x200
+
+    auto regs = MakeRegs(0x202);
+    REQUIRE(!detector.Sample(regs, THUMB_CPSR));
+    REQUIRE(detector.Sample(regs, THUMB_CPSR));
+
+    // The same bytes decoded as ARM are not the same loop
+    REQUIRE(!detector.Sample(regs, ARM_CPSR));
+}
+
+TEST_CASE("IdleLoopDetector detects loops waiting for a system tick", "[arm][idle_loop]") {
+    TestEnvironment test_env(false);
+    IdleLoopDetector detector(test_env.GetMemory());
+
+    auto regs = MakeRegs(0);
+    regs[4] = 0x10000; // Deadline
+    const auto sample_twice = [&](VAddr pc, u32 cpsr) {
+        // svcGetSystemTick returns a different tick in r0 and r1 every time
+        regs[0] = 0x1000;
+        regs[15] = pc;
+        detector.Sample(regs, cpsr);
+        regs[0] = 0x5000;
+        return detector.Sample(regs, cpsr);
+    };
+
+    SECTION("ARM") {
+        test_env.SetMemory32(0x100, 0xEF000028); // svc #0x28
+        test_env.SetMemory32(0x104, 0xE0502004); // subs r2, r0, r4
+        test_env.SetMemory32(0x108, 0xE0D12005); // sbcs r2, r1, r5
+        test_env.SetMemory32(0x10C, 0xBAFFFFFB); // blt 0x100
+        REQUIRE(sample_twice(0x104, ARM_CPSR));
+    }
+
+    SECTION("Thumb") {
+        test_env.SetMemory16(0x200, 0xDF28); // svc #0x28
+        test_env.SetMemory16(0x202, 0x1B02); // subs r2, r0, r4
+        test_env.SetMemory16(0x204, 0x41A9); // sbcs r1, r5
+        test_env.SetMemory16(0x206, 0xDBFB); // blt 0x200
+        REQUIRE(sample_twice(0x202, THUMB_CPSR));
+    }
+}
+
+TEST_CASE("IdleLoopDetector rejects Thumb loops that are not idle", "[arm][idle_loop]") {
+    TestEnvironment test_env(false);
+    IdleLoopDetector detector(test_env.GetMemory());
+
+    SECTION("loop storing to memory") {
+        test_env.SetMemory16(0x200, 0x6801); // ldr r1, [r0, #0]
+        test_env.SetMemory16(0x202, 0x6041); // str r1, [r0, #4]
+        test_env.SetMemory16(0x204, 0x2900); // cmp r1, #0
+        test_env.SetMemory16(0x206, 0xD0FB); // beq 0x200
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x200), THUMB_CPSR));
+    }
+
+    SECTION("loop calling an SVC") {
+        test_env.SetMemory16(0x200, 0x6801); // ldr r1, [r0, #0]
+        test_env.SetMemory16(0x202, 0xDF0A); // svc #0xA
+        test_env.SetMemory16(0x204, 0x2900); // cmp r1, #0
+        test_env.SetMemory16(0x206, 0xD0FB); // beq 0x200
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x200), THUMB_CPSR));
+    }
+
+    SECTION("loop carrying a spin counter") {
+        test_env.SetMemory16(0x200, 0x6801); // ldr r1, [r0, #0]
+        test_env.SetMemory16(0x202, 0x3201); // adds r2, #1
+        test_env.SetMemory16(0x204, 0x2900); // cmp r1, #0
+        test_env.SetMemory16(0x206, 0xD0FB); // beq 0x200
+        REQUIRE(!SampleTwice(detector, MakeRegs(0x200), THUMB_CPSR));
+    }
+}
+
+} // namespace ArmTests
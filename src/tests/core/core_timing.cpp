@@ -174,6 +174,33 @@ TEST_CASE("CoreTiming[PredictableLateness]", "[core]") {
     AdvanceAndCheck(timing, 1, MAX_SLICE_LENGTH, 50, -50);
 }
 
+TEST_CASE("CoreTiming[SkipToNextEvent]", "[core]") {
+    Core::Timing timing(100);
+
+    Core::TimingEventType* cb_a = timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+
+    // Enter slice 0
+    timing.Advance();
+
+    timing.ScheduleEvent(MAX_SLICE_LENGTH * 2 + 500, cb_a, CB_IDS[0]);
+    REQUIRE(MAX_SLICE_LENGTH == timing.GetDowncount());
+
+    // Pretend the CPU spun through the whole slice, then skip the rest of the wait.
+    timing.AddTicks(timing.GetDowncount());
+    REQUIRE(MAX_SLICE_LENGTH + 500 == timing.SkipToNextEvent());
+    REQUIRE(MAX_SLICE_LENGTH + 500 == timing.GetSkippedIdleLoopTicks());
+
+    callbacks_ran_flags = 0;
+    expected_callback = CB_IDS[0];
+    lateness = 0;
+    timing.Advance();
+    REQUIRE(callbacks_ran_flags.test(0));
+    REQUIRE(MAX_SLICE_LENGTH * 2 + 500 == timing.GetTicks());
+
+    // Nothing left to skip to
+    REQUIRE(0 == timing.SkipToNextEvent());
+}
+
 namespace ChainSchedulingTest {
 static int reschedules = 0;
 
@@ -2,17 +2,21 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <catch2/catch.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/ipc.h"
+#include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/ipc_debugger/profiler.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/service.h"
 
 namespace Kernel {
 
@@ -383,4 +387,119 @@ TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
     }
 }
 
+namespace {
+class EchoService final : public Service::ServiceFramework<EchoService> {
+public:
+    EchoService() : ServiceFramework("test:echo") {
+        static const FunctionInfo functions[] = {
+            {0x00010002, &EchoService::Echo, "Echo"},
+        };
+        RegisterHandlers(functions);
+    }
+
+private:
+    void Echo(HLERequestContext& ctx) {
+        IPC::RequestParser rp(ctx, 0x1, 0, 2);
+        std::vector<u8> data = rp.PopStaticBuffer();
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+        rb.Push(RESULT_SUCCESS);
+        rb.PushStaticBuffer(std::move(data), 0);
+    }
+};
+} // Anonymous namespace
+
+TEST_CASE("IPC profiler reports calls and translated bytes together", "[core][kernel]") {
+    Core::Timing timing(100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    std::shared_ptr<Kernel::Process> process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    std::vector<u8> buffer(Memory::PAGE_SIZE, 0xAB);
+    const VAddr buffer_address = 0x10000000;
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(buffer_address, buffer.data(), buffer.size(),
+                                  MemoryState::Private)
+                .Code() == RESULT_SUCCESS);
+
+    auto service = std::make_shared<EchoService>();
+    auto [server, client] = kernel.CreateSessionPair("test:echo");
+    server->SetHleHandler(service);
+
+    IPCDebugger::Profiler& profiler = kernel.GetIPCProfiler();
+    profiler.SetEnabled(true);
+
+    const u32_le input[]{
+        IPC::MakeHeader(0x1, 0, 2),
+        IPC::StaticBufferDesc(0x100, 0),
+        buffer_address,
+    };
+    std::array<u32_le, IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS> output{};
+    output[IPC::COMMAND_BUFFER_LENGTH] = IPC::StaticBufferDesc(0x100, 0);
+    output[IPC::COMMAND_BUFFER_LENGTH + 1] = buffer_address;
+
+    HLERequestContext context(kernel, server, nullptr);
+    context.PopulateFromIncomingCommandBuffer(input, *process);
+    service->HandleSyncRequest(context);
+    context.WriteToOutgoingCommandBuffer(output.data(), *process);
+
+    const auto stats = profiler.GetStats();
+    REQUIRE(stats.size() == 1);
+    const auto& [key, entry] = *stats.begin();
+    CHECK(key == IPCDebugger::CallKey{"test:echo", IPC::MakeHeader(0x1, 0, 2)});
+    CHECK(entry.function_name == "Echo");
+    CHECK(entry.calls == 1);
+    CHECK(entry.translated_bytes == 0x200);
+
+    // Keep the profiler from writing a report when the kernel is destroyed
+    profiler.Reset();
+    REQUIRE(process->vm_manager.UnmapRange(buffer_address, buffer.size()) == RESULT_SUCCESS);
+}
+
+TEST_CASE("HLERequestContext round trip benchmark", "[.][benchmark][core][kernel]") {
+    Core::Timing timing(100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    std::shared_ptr<Kernel::Process> process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    std::vector<u8> buffer(Memory::PAGE_SIZE, 0xAB);
+    const VAddr buffer_address = 0x10000000;
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(buffer_address, buffer.data(), buffer.size(),
+                                  MemoryState::Private)
+                .Code() == RESULT_SUCCESS);
+
+    // A request with one normal parameter and a small static buffer, answered with a result code
+    // and one value, like most trivial service commands.
+    const u32_le input[]{
+        IPC::MakeHeader(0x1, 1, 2),
+        0x12345678,
+        IPC::StaticBufferDesc(0x100, 0),
+        buffer_address,
+    };
+    std::array<u32_le, IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS> output{};
+    auto [server, client] = kernel.CreateSessionPair();
+
+    constexpr int iterations = 1000000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        HLERequestContext context(kernel, server, nullptr);
+        context.PopulateFromIncomingCommandBuffer(input, *process);
+
+        IPC::RequestParser rp(context, 0x1, 1, 2);
+        const u32 value = rp.Pop<u32>();
+        const std::vector<u8>& data = rp.PopStaticBuffer();
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
+        rb.Push(RESULT_SUCCESS);
+        rb.Push<u32>(value + static_cast<u32>(data.size()));
+
+        context.WriteToOutgoingCommandBuffer(output.data(), *process);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(output[2] == 0x12345678 + 0x100);
+    WARN(static_cast<u64>(iterations / elapsed.count()) << " round trips per second");
+
+    REQUIRE(process->vm_manager.UnmapRange(buffer_address, buffer.size()) == RESULT_SUCCESS);
+}
+
 } // namespace Kernel
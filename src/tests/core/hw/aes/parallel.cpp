@@ -0,0 +1,111 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/hw/aes/parallel.h"
+
+namespace {
+/// Below the size TransformCTR and DecryptCBC start splitting work at, so each call is serial
+constexpr std::size_t SerialChunkSize = 0x8000;
+
+constexpr HW::AES::AESKey Key{0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE,
+                              0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+constexpr HW::AES::AESKey Counter{0xFF, 0xEE, 0xDD, 0xCC, 0xBB, 0xAA, 0x99, 0x88,
+                                  0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00};
+
+std::vector<u8> MakeData(std::size_t size) {
+    std::vector<u8> data(size);
+    u32 seed = 1;
+    for (u8& byte : data) {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast<u8>(seed >> 16);
+    }
+    return data;
+}
+
+/// Transforms data a serial chunk at a time, the way one thread would.
+void TransformCTRSerial(u64 offset, u8* data, std::size_t size) {
+    for (std::size_t begin = 0; begin < size; begin += SerialChunkSize) {
+        const std::size_t chunk = std::min(SerialChunkSize, size - begin);
+        HW::AES::TransformCTR(Key, Counter, offset + begin, data + begin, chunk);
+    }
+}
+
+/// Decrypts data a serial chunk at a time, chaining the IV between chunks.
+void DecryptCBCSerial(HW::AES::AESKey& iv, u8* data, std::size_t size) {
+    for (std::size_t begin = 0; begin < size; begin += SerialChunkSize) {
+        const std::size_t chunk = std::min(SerialChunkSize, size - begin);
+        HW::AES::DecryptCBC(Key, iv, data + begin, chunk);
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("HW::AES::TransformCTR matches serial decryption", "[core][aes]") {
+    // Odd sizes and offsets, so that pieces start in the middle of a block
+    for (const std::size_t size :
+         {std::size_t{0x10}, std::size_t{0x500030}, std::size_t{0x2500007}}) {
+        constexpr u64 offset = 0x3039;
+        const std::vector<u8> plain = MakeData(size);
+
+        std::vector<u8> serial = plain;
+        TransformCTRSerial(offset, serial.data(), size);
+        std::vector<u8> parallel = plain;
+        HW::AES::TransformCTR(Key, Counter, offset, parallel.data(), size);
+        REQUIRE(parallel == serial);
+
+        HW::AES::TransformCTR(Key, Counter, offset, parallel.data(), size);
+        REQUIRE(parallel == plain);
+    }
+}
+
+TEST_CASE("HW::AES::DecryptCBC matches serial decryption", "[core][aes]") {
+    for (const std::size_t size :
+         {std::size_t{0x10}, std::size_t{0x500030}, std::size_t{0x2500000}}) {
+        const std::vector<u8> cipher = MakeData(size);
+
+        std::vector<u8> serial = cipher;
+        HW::AES::AESKey serial_iv = Counter;
+        DecryptCBCSerial(serial_iv, serial.data(), size);
+
+        // Split the way CIA installs receive contents, in two writes
+        std::vector<u8> parallel = cipher;
+        HW::AES::AESKey parallel_iv = Counter;
+        const std::size_t half = size / 2 / 0x10 * 0x10;
+        HW::AES::DecryptCBC(Key, parallel_iv, parallel.data(), half);
+        HW::AES::DecryptCBC(Key, parallel_iv, parallel.data() + half, size - half);
+
+        REQUIRE(parallel == serial);
+        REQUIRE(parallel_iv == serial_iv);
+    }
+}
+
+TEST_CASE("HW::AES parallel decryption benchmark", "[.][benchmark][core][aes]") {
+    // About the size of a small RomFS, or of a CIA content
+    constexpr std::size_t size = 64 * 1024 * 1024;
+    std::vector<u8> data = MakeData(size);
+
+    const auto time = [&](auto&& function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    const auto ctr_serial = time([&] { TransformCTRSerial(0, data.data(), size); });
+    const auto ctr_parallel =
+        time([&] { HW::AES::TransformCTR(Key, Counter, 0, data.data(), size); });
+    HW::AES::AESKey iv = Counter;
+    const auto cbc_serial = time([&] { DecryptCBCSerial(iv, data.data(), size); });
+    const auto cbc_parallel = time([&] { HW::AES::DecryptCBC(Key, iv, data.data(), size); });
+
+    const auto throughput = [](s64 us) { return us == 0 ? 0 : (size / 0x100000) * 1000000 / us; };
+    WARN("CTR (NCCH sections, RomFS): " << throughput(ctr_serial) << " MiB/s serial, "
+                                        << throughput(ctr_parallel) << " MiB/s parallel");
+    WARN("CBC (CIA contents): " << throughput(cbc_serial) << " MiB/s serial, "
+                                << throughput(cbc_parallel) << " MiB/s parallel");
+}
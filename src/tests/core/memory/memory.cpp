@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <chrono>
+#include <cstring>
 #include <catch2/catch.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -58,3 +61,130 @@ TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
         CHECK(Memory::IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("MemorySystem::MarkRegionWatched", "[core][memory]") {
+    Core::Timing timing(100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    std::shared_ptr<Kernel::Process> process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.MapSharedPages(process->vm_manager);
+
+    const Memory::PageTable& page_table = process->vm_manager.page_table;
+    const std::size_t page = Memory::SHARED_PAGE_VADDR >> Memory::PAGE_BITS;
+    u8* const backing = page_table.pointers[page];
+    REQUIRE(backing != nullptr);
+
+    // Two watchpoints on the same page
+    memory.MarkRegionWatched(Memory::SHARED_PAGE_VADDR + 0x10, 4, true);
+    memory.MarkRegionWatched(Memory::SHARED_PAGE_VADDR + 0x20, 4, true);
+    CHECK(page_table.pointers[page] == nullptr);
+    CHECK(page_table.attributes[page] == Memory::PageType::WatchedMemory);
+    CHECK(page_table.attributes[page - 1] == Memory::PageType::Memory);
+    CHECK(Memory::IsValidVirtualAddress(*process, Memory::SHARED_PAGE_VADDR));
+
+    SECTION("watched pages are still backed by the same memory") {
+        const u32 value = 0x12345678;
+        memory.WriteBlock(*process, Memory::SHARED_PAGE_VADDR + 0x10, &value, sizeof(value));
+        u32 read = 0;
+        std::memcpy(&read, backing + 0x10, sizeof(read));
+        CHECK(read == value);
+        read = 0;
+        memory.ReadBlock(*process, Memory::SHARED_PAGE_VADDR + 0x10, &read, sizeof(read));
+        CHECK(read == value);
+    }
+
+    SECTION("a page stays watched until its last watchpoint is removed") {
+        memory.MarkRegionWatched(Memory::SHARED_PAGE_VADDR + 0x10, 4, false);
+        CHECK(page_table.attributes[page] == Memory::PageType::WatchedMemory);
+        memory.MarkRegionWatched(Memory::SHARED_PAGE_VADDR + 0x20, 4, false);
+        CHECK(page_table.pointers[page] == backing);
+        CHECK(page_table.attributes[page] == Memory::PageType::Memory);
+        CHECK(page_table.watched_pointers.empty());
+    }
+
+    SECTION("memory mapped onto a watched page is watched") {
+        process->vm_manager.UnmapRange(Memory::SHARED_PAGE_VADDR, Memory::SHARED_PAGE_SIZE);
+        CHECK(page_table.attributes[page] == Memory::PageType::Unmapped);
+        CHECK(page_table.watched_pointers.empty());
+
+        std::array<u8, Memory::PAGE_SIZE> other_backing{};
+        process->vm_manager.MapBackingMemory(Memory::SHARED_PAGE_VADDR, other_backing.data(),
+                                             Memory::PAGE_SIZE, Kernel::MemoryState::Shared);
+        CHECK(page_table.pointers[page] == nullptr);
+        CHECK(page_table.attributes[page] == Memory::PageType::WatchedMemory);
+        CHECK(page_table.watched_pointers.at(static_cast<u32>(page)) == other_backing.data());
+        process->vm_manager.UnmapRange(Memory::SHARED_PAGE_VADDR, Memory::SHARED_PAGE_SIZE);
+    }
+}
+
+TEST_CASE("MemorySystem::GetPhysicalPointer", "[core][memory]") {
+    Memory::MemorySystem memory;
+
+    CHECK(memory.GetPhysicalPointer(Memory::FCRAM_PADDR) == memory.GetFCRAMPointer(0));
+    CHECK(memory.GetPhysicalPointer(Memory::FCRAM_PADDR + 0x123456) ==
+          memory.GetFCRAMPointer(0x123456));
+    CHECK(memory.GetPhysicalPointer(Memory::VRAM_PADDR + 0x100) ==
+          memory.GetPhysicalPointer(Memory::VRAM_PADDR) + 0x100);
+
+    // The end of an area is a valid open right bound
+    CHECK(memory.GetPhysicalPointer(Memory::FCRAM_N3DS_PADDR_END) ==
+          memory.GetFCRAMPointer(Memory::FCRAM_N3DS_SIZE));
+    CHECK(memory.GetPhysicalPointer(Memory::VRAM_PADDR_END) ==
+          memory.GetPhysicalPointer(Memory::VRAM_PADDR) + Memory::VRAM_SIZE);
+
+    CHECK(memory.GetPhysicalPointer(Memory::VRAM_PADDR_END + Memory::PAGE_SIZE) == nullptr);
+    CHECK(memory.GetPhysicalPointer(Memory::IO_AREA_PADDR) == nullptr);
+    CHECK(memory.GetPhysicalPointer(0) == nullptr);
+
+    const auto [pointer, span] = memory.GetPhysicalSpan(Memory::N3DS_EXTRA_RAM_PADDR + 0x10);
+    CHECK(pointer == memory.GetPhysicalPointer(Memory::N3DS_EXTRA_RAM_PADDR) + 0x10);
+    CHECK(span == Memory::N3DS_EXTRA_RAM_SIZE - 0x10);
+}
+
+TEST_CASE("MemorySystem::GetPhysicalPointer benchmark", "[.][benchmark][core][memory]") {
+    Memory::MemorySystem memory;
+    constexpr int lookups = 10000000;
+
+    const auto time = [](auto&& function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    // Vertex arrays in FCRAM, read at a fixed stride
+    std::uintptr_t checksum = 0;
+    const s64 vertex_ns = time([&] {
+        for (int i = 0; i < lookups; ++i) {
+            const PAddr address = Memory::FCRAM_PADDR + static_cast<u32>(i) * 32 % 0x100000;
+            checksum += reinterpret_cast<std::uintptr_t>(memory.GetPhysicalPointer(address));
+        }
+    });
+
+    // Surfaces and textures, alternating between VRAM and FCRAM as the rasterizer cache loads them
+    const s64 surface_ns = time([&] {
+        u32 seed = 1;
+        for (int i = 0; i < lookups; ++i) {
+            seed = seed * 1103515245 + 12345;
+            const PAddr address = i % 2 == 0 ? Memory::VRAM_PADDR + seed % Memory::VRAM_SIZE
+                                             : Memory::FCRAM_PADDR + seed % Memory::FCRAM_SIZE;
+            checksum += reinterpret_cast<std::uintptr_t>(memory.GetPhysicalPointer(address));
+        }
+    });
+
+    // Display transfers between VRAM and the N3DS extra RAM
+    const s64 transfer_ns = time([&] {
+        for (int i = 0; i < lookups; ++i) {
+            const u32 offset = static_cast<u32>(i) * 0x400 % Memory::N3DS_EXTRA_RAM_SIZE;
+            const PAddr address = i % 2 == 0 ? Memory::VRAM_PADDR + offset
+                                             : Memory::N3DS_EXTRA_RAM_PADDR + offset;
+            checksum += memory.GetPhysicalSpan(address).second;
+        }
+    });
+
+    WARN(vertex_ns * 1000 / lookups << " ps per vertex array lookup, "
+                                    << surface_ns * 1000 / lookups << " ps per surface lookup, "
+                                    << transfer_ns * 1000 / lookups
+                                    << " ps per transfer lookup (checksum " << checksum << ")");
+}
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <catch2/catch.hpp>
 #include "core/hle/kernel/errors.h"
@@ -148,3 +150,130 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         REQUIRE(code == RESULT_SUCCESS);
     }
 }
+
+namespace {
+/// Maps count one page blocks of FCRAM into the heap, leaving a free page after every third one,
+/// with alternating states so that neighbours do not merge.
+void MapScatteredBlocks(Kernel::VMManager& manager, u8* backing, u32 count) {
+    for (u32 i = 0; i < count; ++i) {
+        const VAddr address = Memory::HEAP_VADDR + (i + i / 3) * Memory::PAGE_SIZE;
+        const auto state = i % 2 == 0 ? Kernel::MemoryState::Private : Kernel::MemoryState::Shared;
+        REQUIRE(manager.MapBackingMemory(address, backing + i * Memory::PAGE_SIZE,
+                                         Memory::PAGE_SIZE, state)
+                    .Succeeded());
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("VMManager::FindVMA matches the VMA map", "[kernel][memory]") {
+    constexpr u32 count = 300;
+    std::vector<u8> backing(count * Memory::PAGE_SIZE);
+    Memory::MemorySystem memory;
+    std::unique_ptr<Kernel::VMManager> manager = std::make_unique<Kernel::VMManager>(memory);
+
+    MapScatteredBlocks(*manager, backing.data(), count);
+    // Merge some blocks by making their states equal, and split others by unmapping them
+    for (u32 i = 0; i < count; i += 7) {
+        const VAddr address = Memory::HEAP_VADDR + (i + i / 3) * Memory::PAGE_SIZE;
+        if (i % 2 == 0) {
+            REQUIRE(manager->UnmapRange(address, Memory::PAGE_SIZE) == RESULT_SUCCESS);
+        } else {
+            REQUIRE(manager->ChangeMemoryState(address, Memory::PAGE_SIZE,
+                                               Kernel::MemoryState::Shared,
+                                               Kernel::VMAPermission::ReadWrite,
+                                               Kernel::MemoryState::Private,
+                                               Kernel::VMAPermission::ReadWrite) == RESULT_SUCCESS);
+        }
+    }
+
+    const VAddr end = Memory::HEAP_VADDR + (count + count / 3 + 1) * Memory::PAGE_SIZE;
+    for (VAddr address = Memory::HEAP_VADDR - Memory::PAGE_SIZE; address < end;
+         address += Memory::PAGE_SIZE / 2) {
+        const auto expected = std::prev(manager->vma_map.upper_bound(address));
+        REQUIRE(manager->FindVMA(address) == expected);
+
+        const u8* pointer = manager->page_table.pointers[address >> Memory::PAGE_BITS];
+        if (expected->second.type == Kernel::VMAType::BackingMemory) {
+            REQUIRE(pointer == expected->second.backing_memory +
+                                   ((address - expected->second.base) & ~Memory::PAGE_MASK));
+        } else {
+            REQUIRE(pointer == nullptr);
+        }
+    }
+    REQUIRE(manager->FindVMA(Kernel::VMManager::MAX_ADDRESS) == manager->vma_map.end());
+}
+
+TEST_CASE("VMManager benchmark", "[.][benchmark][kernel][memory]") {
+    constexpr u32 count = 1000;
+    std::vector<u8> backing(count * Memory::PAGE_SIZE);
+    Memory::MemorySystem memory;
+    std::unique_ptr<Kernel::VMManager> manager = std::make_unique<Kernel::VMManager>(memory);
+
+    const auto time = [](auto&& function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    constexpr int lookups = 1000000;
+    const u32 span = (count + count / 3) * Memory::PAGE_SIZE;
+    const s64 map_ns = time([&] { MapScatteredBlocks(*manager, backing.data(), count); });
+
+    // Lookups at scattered addresses miss the last-hit cache, as svcQueryMemory loops do
+    u64 checksum = 0;
+    const s64 find_ns = time([&] {
+        u32 seed = 1;
+        for (int i = 0; i < lookups; ++i) {
+            seed = seed * 1103515245 + 12345;
+            checksum += manager->FindVMA(Memory::HEAP_VADDR + seed % span)->second.size;
+        }
+    });
+
+    // Walking an address range a page at a time, as memory reads and svcQueryMemory do
+    const s64 walk_ns = time([&] {
+        for (int i = 0; i < lookups; ++i) {
+            const u32 offset = static_cast<u32>(i) * (Memory::PAGE_SIZE / 4) % span;
+            checksum += manager->FindVMA(Memory::HEAP_VADDR + offset)->second.size;
+        }
+    });
+
+    // Mapped buffers of IPC requests, translated a block at a time
+    const s64 blocks_ns = time([&] {
+        for (int i = 0; i < 1000; ++i) {
+            auto blocks = manager->GetBackingBlocksForRange(Memory::HEAP_VADDR,
+                                                                  3 * Memory::PAGE_SIZE);
+            checksum += blocks.Unwrap().size();
+        }
+    });
+
+    const s64 reprotect_ns = time([&] {
+        for (u32 i = 0; i < count; ++i) {
+            const VAddr address = Memory::HEAP_VADDR + (i + i / 3) * Memory::PAGE_SIZE;
+            manager->ReprotectRange(address, Memory::PAGE_SIZE, Kernel::VMAPermission::Read);
+        }
+    });
+
+    const s64 unmap_ns = time([&] {
+        for (u32 i = 0; i < count; ++i) {
+            const VAddr address = Memory::HEAP_VADDR + (i + i / 3) * Memory::PAGE_SIZE;
+            manager->UnmapRange(address, Memory::PAGE_SIZE);
+        }
+    });
+
+    // A large heap mapping, as svcControlMemory does for the application heap
+    std::vector<u8> heap(0x4000000);
+    const s64 large_map_ns = time([&] {
+        manager->MapBackingMemory(Memory::HEAP_VADDR, heap.data(), static_cast<u32>(heap.size()),
+                                  Kernel::MemoryState::Private);
+        manager->UnmapRange(Memory::HEAP_VADDR, static_cast<u32>(heap.size()));
+    });
+
+    WARN(count << " VMAs: " << map_ns / count << " ns per map, " << find_ns / lookups
+               << " ns per scattered lookup, " << walk_ns / lookups
+               << " ns per sequential lookup, " << blocks_ns / 1000 << " ns per block list, "
+               << reprotect_ns / count << " ns per reprotect, " << unmap_ns / count
+               << " ns per unmap, " << large_map_ns / 1000 << " us to map and unmap 64 MiB"
+               << " (checksum " << checksum << ")");
+}
@@ -0,0 +1,145 @@
+// Copyright 2020 Citra Valentin Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include <catch2/catch.hpp>
+#include "core/memory.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/regs_pipeline.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader.h"
+#include "video_core/video_core.h"
+
+namespace {
+using Format = Pica::PipelineRegs::VertexAttributeFormat;
+
+constexpr u32 Stride = 32;
+
+/**
+ * Sets up a layout with one attribute of every format, read through two loaders:
+ *  - loader 0: attribute 0 (3 floats), 4 bytes of padding, attribute 1 (2 shorts)
+ *  - loader 1: attribute 2 (4 unsigned bytes), attribute 3 (1 signed byte)
+ */
+Pica::PipelineRegs MakeRegs() {
+    Pica::PipelineRegs regs;
+    std::memset(&regs, 0, sizeof(regs));
+    auto& attributes = regs.vertex_attributes;
+    attributes.base_address.Assign(Memory::FCRAM_PADDR / 16);
+    attributes.format0.Assign(Format::FLOAT);
+    attributes.size0.Assign(2);
+    attributes.format1.Assign(Format::SHORT);
+    attributes.size1.Assign(1);
+    attributes.format2.Assign(Format::UBYTE);
+    attributes.size2.Assign(3);
+    attributes.format3.Assign(Format::BYTE);
+    attributes.size3.Assign(0);
+    attributes.max_attribute_index.Assign(3);
+
+    attributes.attribute_loaders[0].data_offset.Assign(0);
+    attributes.attribute_loaders[0].comp0.Assign(0);
+    attributes.attribute_loaders[0].comp1.Assign(12);
+    attributes.attribute_loaders[0].comp2.Assign(1);
+    attributes.attribute_loaders[0].component_count.Assign(3);
+    attributes.attribute_loaders[0].byte_count.Assign(Stride);
+
+    attributes.attribute_loaders[1].data_offset.Assign(0x10000);
+    attributes.attribute_loaders[1].comp0.Assign(2);
+    attributes.attribute_loaders[1].comp1.Assign(3);
+    attributes.attribute_loaders[1].component_count.Assign(2);
+    attributes.attribute_loaders[1].byte_count.Assign(Stride);
+    return regs;
+}
+
+/// Fills the attribute arrays of the layout above with a distinct pattern.
+void FillVertices(Memory::MemorySystem& memory, int count) {
+    for (int vertex = 0; vertex < count; ++vertex) {
+        u8* const first = memory.GetFCRAMPointer(vertex * Stride);
+        for (int i = 0; i < 3; ++i) {
+            const float value = vertex * 0.5f + i;
+            std::memcpy(first + i * 4, &value, sizeof(value));
+        }
+        for (int i = 0; i < 2; ++i) {
+            const s16 value = static_cast<s16>(vertex * (i == 0 ? 3 : -7));
+            std::memcpy(first + 16 + i * 2, &value, sizeof(value));
+        }
+
+        u8* const second = memory.GetFCRAMPointer(0x10000 + vertex * Stride);
+        for (int i = 0; i < 4; ++i) {
+            second[i] = static_cast<u8>(vertex + i * 60);
+        }
+        second[4] = static_cast<u8>(static_cast<s8>(-vertex));
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("VertexLoader converts every attribute format", "[video_core]") {
+    Memory::MemorySystem memory;
+    VideoCore::g_memory = &memory;
+    constexpr int count = 200;
+    FillVertices(memory, count);
+
+    Pica::VertexLoader loader(MakeRegs());
+    REQUIRE(loader.GetNumTotalAttributes() == 4);
+
+    Pica::DebugUtils::MemoryAccessTracker memory_accesses;
+    for (int vertex = 0; vertex < count; ++vertex) {
+        Pica::Shader::AttributeBuffer input{};
+        loader.LoadVertex(vertex, vertex, input, memory_accesses);
+
+        REQUIRE(input.attr[0][0].ToFloat32() == vertex * 0.5f);
+        REQUIRE(input.attr[0][1].ToFloat32() == vertex * 0.5f + 1);
+        REQUIRE(input.attr[0][2].ToFloat32() == vertex * 0.5f + 2);
+        REQUIRE(input.attr[0][3].ToFloat32() == 1.0f);
+
+        REQUIRE(input.attr[1][0].ToFloat32() == static_cast<s16>(vertex * 3));
+        REQUIRE(input.attr[1][1].ToFloat32() == static_cast<s16>(vertex * -7));
+        REQUIRE(input.attr[1][2].ToFloat32() == 0.0f);
+        REQUIRE(input.attr[1][3].ToFloat32() == 1.0f);
+
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(input.attr[2][i].ToFloat32() == static_cast<u8>(vertex + i * 60));
+        }
+
+        REQUIRE(input.attr[3][0].ToFloat32() == static_cast<s8>(-vertex));
+        REQUIRE(input.attr[3][1].ToFloat32() == 0.0f);
+        REQUIRE(input.attr[3][3].ToFloat32() == 1.0f);
+    }
+
+    // Vertices past the end of FCRAM are not read
+    Pica::Shader::AttributeBuffer input{};
+    loader.LoadVertex(0, Memory::FCRAM_N3DS_SIZE / Stride, input, memory_accesses);
+    REQUIRE(input.attr[0][0].ToFloat32() == 0.0f);
+    REQUIRE(input.attr[0][3].ToFloat32() == 1.0f);
+
+    VideoCore::g_memory = nullptr;
+}
+
+TEST_CASE("VertexLoader benchmark", "[.][benchmark][video_core]") {
+    Memory::MemorySystem memory;
+    VideoCore::g_memory = &memory;
+    constexpr int count = 0x800;
+    FillVertices(memory, count);
+
+    Pica::VertexLoader loader(MakeRegs());
+    Pica::DebugUtils::MemoryAccessTracker memory_accesses;
+    Pica::Shader::AttributeBuffer input{};
+    constexpr int iterations = 1000;
+    float checksum = 0.0f;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (int vertex = 0; vertex < count; ++vertex) {
+            loader.LoadVertex(vertex, vertex, input, memory_accesses);
+            checksum += input.attr[iteration % 4][vertex % 4].ToFloat32();
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    WARN("4 attributes: " << elapsed / (iterations * count) << " ns per vertex (checksum "
+                          << checksum << ")");
+    VideoCore::g_memory = nullptr;
+}
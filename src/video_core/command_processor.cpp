@@ -421,7 +421,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                     use_gs ? cached_vertex.output_attr : attribute_buffer;
 
                 // Initialize data for the current vertex
-                loader.LoadVertex(base_address, index, vertex, attribute_buffer, memory_accesses);
+                loader.LoadVertex(index, vertex, attribute_buffer, memory_accesses);
 
                 // Send to vertex shader
                 if (g_debug_context) {
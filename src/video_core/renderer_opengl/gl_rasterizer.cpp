@@ -15,7 +15,9 @@
 #include "common/scope_exit.h"
 #include "common/vector_math.h"
 #include "core/core.h"
+#include "core/frontend/emu_window.h"
 #include "core/hw/gpu.h"
+#include "core/settings.h"
 #include "video_core/pica_state.h"
 #include "video_core/regs_framebuffer.h"
 #include "video_core/regs_rasterizer.h"
@@ -31,6 +33,19 @@ namespace OpenGL {
 using PixelFormat = SurfaceParams::PixelFormat;
 using SurfaceType = SurfaceParams::SurfaceType;
 
+// Byte offsets of the LUTs in lut_buffer. Each LUT keeps its place, so that modified entries can
+// be uploaded in place.
+constexpr std::size_t LightingLutOffset = 0;
+constexpr std::size_t FogLutOffset =
+    LightingLutOffset + sizeof(GLvec2) * 256 * Pica::LightingRegs::NumLightingSampler;
+constexpr std::size_t ProcTexNoiseLutOffset = FogLutOffset + sizeof(GLvec2) * 128;
+constexpr std::size_t ProcTexColorMapOffset = ProcTexNoiseLutOffset + sizeof(GLvec2) * 128;
+constexpr std::size_t ProcTexAlphaMapOffset = ProcTexColorMapOffset + sizeof(GLvec2) * 128;
+constexpr std::size_t ProcTexLutOffset = ProcTexAlphaMapOffset + sizeof(GLvec2) * 128;
+constexpr std::size_t ProcTexDiffLutOffset = ProcTexLutOffset + sizeof(GLvec4) * 256;
+constexpr std::size_t LutBufferSize = ProcTexDiffLutOffset + sizeof(GLvec4) * 256;
+static_assert(ProcTexLutOffset % sizeof(GLvec4) == 0, "RGBA LUTs must be aligned to a texel");
+
 static bool IsVendorAmd() {
     std::string gpu_vendor{reinterpret_cast<char const*>(glGetString(GL_VENDOR))};
     std::string gpu_renderer{reinterpret_cast<char const*>(glGetString(GL_RENDERER))};
@@ -43,8 +58,7 @@ RasterizerOpenGL::RasterizerOpenGL(Frontend::EmuWindow& window)
     : is_amd(IsVendorAmd()), shader_dirty(true),
       vertex_buffer(GL_ARRAY_BUFFER, VERTEX_BUFFER_SIZE, is_amd),
       uniform_buffer(GL_UNIFORM_BUFFER, UNIFORM_BUFFER_SIZE, false),
-      index_buffer(GL_ELEMENT_ARRAY_BUFFER, INDEX_BUFFER_SIZE, false),
-      texture_buffer(GL_TEXTURE_BUFFER, TEXTURE_BUFFER_SIZE, false), emu_window{window} {
+      index_buffer(GL_ELEMENT_ARRAY_BUFFER, INDEX_BUFFER_SIZE, false), emu_window{window} {
 
     allow_shadow = GLAD_GL_ARB_shader_image_load_store && GLAD_GL_ARB_shader_image_size &&
                    GLAD_GL_ARB_framebuffer_no_attachments;
@@ -85,22 +99,49 @@ RasterizerOpenGL::RasterizerOpenGL(Frontend::EmuWindow& window)
 
     uniform_block_data.dirty = true;
 
-    uniform_block_data.lighting_lut_dirty.fill(true);
+    for (LutDirtyRange& range : uniform_block_data.lighting_lut_dirty) {
+        range = {0, 256};
+    }
     uniform_block_data.lighting_lut_dirty_any = true;
 
-    uniform_block_data.fog_lut_dirty = true;
+    uniform_block_data.fog_lut_dirty = {0, 128};
+
+    uniform_block_data.proctex_noise_lut_dirty = {0, 128};
+    uniform_block_data.proctex_color_map_dirty = {0, 128};
+    uniform_block_data.proctex_alpha_map_dirty = {0, 128};
+    uniform_block_data.proctex_lut_dirty = {0, 256};
+    uniform_block_data.proctex_diff_lut_dirty = {0, 256};
 
-    uniform_block_data.proctex_noise_lut_dirty = true;
-    uniform_block_data.proctex_color_map_dirty = true;
-    uniform_block_data.proctex_alpha_map_dirty = true;
-    uniform_block_data.proctex_lut_dirty = true;
-    uniform_block_data.proctex_diff_lut_dirty = true;
+    for (std::size_t index = 0; index < Pica::LightingRegs::NumLightingSampler; index++) {
+        uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
+            static_cast<GLint>((LightingLutOffset + sizeof(lighting_lut_data[0]) * index) /
+                               sizeof(GLvec2));
+    }
+    uniform_block_data.data.fog_lut_offset = FogLutOffset / sizeof(GLvec2);
+    uniform_block_data.data.proctex_noise_lut_offset = ProcTexNoiseLutOffset / sizeof(GLvec2);
+    uniform_block_data.data.proctex_color_map_offset = ProcTexColorMapOffset / sizeof(GLvec2);
+    uniform_block_data.data.proctex_alpha_map_offset = ProcTexAlphaMapOffset / sizeof(GLvec2);
+    uniform_block_data.data.proctex_lut_offset = ProcTexLutOffset / sizeof(GLvec4);
+    uniform_block_data.data.proctex_diff_lut_offset = ProcTexDiffLutOffset / sizeof(GLvec4);
 
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_alignment);
     uniform_size_aligned_vs =
         Common::AlignUp<std::size_t>(sizeof(VSUniformData), uniform_buffer_alignment);
-    uniform_size_aligned_fs =
-        Common::AlignUp<std::size_t>(sizeof(UniformData), uniform_buffer_alignment);
+
+    // The fragment uniforms and the LUTs start out zeroed, like the copies they are compared
+    // against before each upload
+    uniform_buffer_fs.Create();
+    state.draw.uniform_buffer = uniform_buffer_fs.handle;
+    state.Apply();
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(UniformData), &uploaded_uniform_data,
+                 GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::Common),
+                     uniform_buffer_fs.handle);
+
+    const std::vector<u8> zeroed_luts(LutBufferSize);
+    lut_buffer.Create();
+    glBindBuffer(GL_TEXTURE_BUFFER, lut_buffer.handle);
+    glBufferData(GL_TEXTURE_BUFFER, LutBufferSize, zeroed_luts.data(), GL_DYNAMIC_DRAW);
 
     // Set vertex attributes for software shader path
     state.draw.vertex_array = sw_vao.handle;
@@ -147,24 +188,41 @@ RasterizerOpenGL::RasterizerOpenGL(Frontend::EmuWindow& window)
     state.texture_buffer_lut_rgba.texture_buffer = texture_buffer_lut_rgba.handle;
     state.Apply();
     glActiveTexture(TextureUnits::TextureBufferLUT_RG.Enum());
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, texture_buffer.GetHandle());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, lut_buffer.handle);
     glActiveTexture(TextureUnits::TextureBufferLUT_RGBA.Enum());
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, texture_buffer.GetHandle());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, lut_buffer.handle);
 
     // Bind index buffer for hardware shader path
     state.draw.vertex_array = hw_vao.handle;
     state.Apply();
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer.GetHandle());
 
-    shader_program_manager =
-        std::make_unique<ShaderProgramManager>(GLAD_GL_ARB_separate_shader_objects, is_amd);
+    std::unique_ptr<Frontend::GraphicsContext> compile_context;
+    if (Settings::values.use_async_shader_compilation && GLAD_GL_ARB_separate_shader_objects) {
+        compile_context = emu_window.CreateSharedContext();
+        // Some frontends make a new context current, restore the rasterizer's
+        emu_window.MakeCurrent();
+    }
+    shader_program_manager = std::make_unique<ShaderProgramManager>(
+        GLAD_GL_ARB_separate_shader_objects, is_amd, std::move(compile_context));
 
     glEnable(GL_BLEND);
 
     SyncEntireState();
 }
 
-RasterizerOpenGL::~RasterizerOpenGL() {}
+RasterizerOpenGL::~RasterizerOpenGL() {
+    if (upload_stats_frames != 0) {
+        LOG_INFO(Render_OpenGL,
+                 "Uploaded {} bytes of LUTs and {} bytes of uniforms per frame on average",
+                 total_upload_stats.lut_bytes / upload_stats_frames,
+                 total_upload_stats.uniform_bytes / upload_stats_frames);
+    }
+    if (draw_stats.pica_draws != 0) {
+        LOG_INFO(Render_OpenGL, "Issued {} OpenGL draws for {} Pica draws", draw_stats.gl_draws,
+                 draw_stats.pica_draws);
+    }
+}
 
 void RasterizerOpenGL::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
@@ -396,6 +454,8 @@ bool RasterizerOpenGL::SetupGeometryShader() {
 }
 
 bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
+    FlushPendingDraw();
+
     const Pica::Regs& regs = Pica::g_state.regs;
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
         if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
@@ -412,6 +472,7 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
     if (!SetupGeometryShader())
         return false;
 
+    draw_stats.pica_draws++;
     return Draw(true, is_indexed);
 }
 
@@ -483,6 +544,11 @@ void RasterizerOpenGL::DrawTriangles() {
     if (vertex_batch.empty()) {
         return;
     }
+    draw_stats.pica_draws++;
+    if (pending_draw) {
+        // Nothing changed since the open batch was set up, these triangles are part of it now
+        return;
+    }
     Draw(false, false);
 }
 
@@ -523,6 +589,9 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
         regs.rasterizer.viewport_corner.y // bottom
     };
 
+    // No surface of the cache is in use yet
+    res_cache.EvictSurfaces();
+
     Surface color_surface;
     Surface depth_surface;
     Common::Rectangle<u32> surfaces_rect;
@@ -759,10 +828,10 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
         }
     }
 
-    // Sync and bind the shader
+    // Sync and bind the shader. While the ubershader stands in for a shader that is still
+    // compiling, it's synced again for every draw.
     if (shader_dirty) {
-        SetShader();
-        shader_dirty = false;
+        shader_dirty = !SetShader();
     }
 
     // Sync the LUTs within the texture buffer
@@ -782,10 +851,15 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     state.scissor.height = draw_rect.GetHeight();
     state.Apply();
 
+    const DrawTargets targets{color_surface,    depth_surface,  draw_rect,         res_scale,
+                              write_color_fb,   write_depth_fb, shadow_rendering,
+                              need_texture_barrier};
+
     // Draw the vertex batch
     bool succeeded = true;
     if (accelerate) {
         succeeded = AccelerateDrawBatchInternal(is_indexed);
+        draw_stats.gl_draws++;
     } else {
         state.draw.vertex_array = sw_vao.handle;
         state.draw.vertex_buffer = vertex_buffer.GetHandle();
@@ -794,26 +868,42 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
         shader_program_manager->ApplyTo(state);
         state.Apply();
 
-        std::size_t max_vertices = 3 * (VERTEX_BUFFER_SIZE / (3 * sizeof(HardwareVertex)));
-        for (std::size_t base_vertex = 0; base_vertex < vertex_batch.size();
-             base_vertex += max_vertices) {
-            std::size_t vertices = std::min(max_vertices, vertex_batch.size() - base_vertex);
-            std::size_t vertex_size = vertices * sizeof(HardwareVertex);
-            u8* vbo;
-            GLintptr offset;
-            std::tie(vbo, offset, std::ignore) =
-                vertex_buffer.Map(vertex_size, sizeof(HardwareVertex));
-            std::memcpy(vbo, vertex_batch.data() + base_vertex, vertex_size);
-            vertex_buffer.Unmap(vertex_size);
-            glDrawArrays(GL_TRIANGLES, offset / sizeof(HardwareVertex), (GLsizei)vertices);
+        // Keep the batch open, so that following draws with the same state are appended to it.
+        // Draws that read what the previous one wrote can't be merged.
+        if (!shadow_rendering && !need_texture_barrier) {
+            pending_draw = targets;
+            pending_draw_regs = regs.reg_array;
+            return true;
         }
+        DrawVertexBatch();
+    }
+
+    FinishDraw(targets);
+    return succeeded;
+}
+
+void RasterizerOpenGL::DrawVertexBatch() {
+    std::size_t max_vertices = 3 * (VERTEX_BUFFER_SIZE / (3 * sizeof(HardwareVertex)));
+    for (std::size_t base_vertex = 0; base_vertex < vertex_batch.size();
+         base_vertex += max_vertices) {
+        std::size_t vertices = std::min(max_vertices, vertex_batch.size() - base_vertex);
+        std::size_t vertex_size = vertices * sizeof(HardwareVertex);
+        u8* vbo;
+        GLintptr offset;
+        std::tie(vbo, offset, std::ignore) = vertex_buffer.Map(vertex_size, sizeof(HardwareVertex));
+        std::memcpy(vbo, vertex_batch.data() + base_vertex, vertex_size);
+        vertex_buffer.Unmap(vertex_size);
+        glDrawArrays(GL_TRIANGLES, offset / sizeof(HardwareVertex), (GLsizei)vertices);
+        draw_stats.gl_draws++;
     }
 
     vertex_batch.clear();
+}
 
+void RasterizerOpenGL::FinishDraw(const DrawTargets& targets) {
     // Reset textures in rasterizer state context because the rasterizer cache might delete them
-    for (unsigned texture_index = 0; texture_index < pica_textures.size(); ++texture_index) {
-        state.texture_units[texture_index].texture_2d = 0;
+    for (auto& texture_unit : state.texture_units) {
+        texture_unit.texture_2d = 0;
     }
     state.texture_cube_unit.texture_cube = 0;
     if (allow_shadow) {
@@ -827,37 +917,75 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     }
     state.Apply();
 
-    if (shadow_rendering) {
+    if (targets.shadow_rendering) {
         glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
                         GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
     }
 
-    if (need_texture_barrier && GLAD_GL_ARB_texture_barrier) {
+    if (targets.need_texture_barrier && GLAD_GL_ARB_texture_barrier) {
         glTextureBarrier();
     }
 
     // Mark framebuffer surfaces as dirty
+    const Common::Rectangle<u32>& draw_rect = targets.draw_rect;
+    const u16 res_scale = targets.res_scale;
     Common::Rectangle<u32> draw_rect_unscaled{draw_rect.left / res_scale, draw_rect.top / res_scale,
                                               draw_rect.right / res_scale,
                                               draw_rect.bottom / res_scale};
 
-    if (color_surface != nullptr && write_color_fb) {
-        OpenGL::SurfaceInterval interval = color_surface->GetSubRectInterval(draw_rect_unscaled);
+    if (targets.color_surface != nullptr && targets.write_color_fb) {
+        OpenGL::SurfaceInterval interval =
+            targets.color_surface->GetSubRectInterval(draw_rect_unscaled);
         res_cache.InvalidateRegion(boost::icl::first(interval), boost::icl::length(interval),
-                                   color_surface);
+                                   targets.color_surface);
     }
-    if (depth_surface != nullptr && write_depth_fb) {
-        OpenGL::SurfaceInterval interval = depth_surface->GetSubRectInterval(draw_rect_unscaled);
+    if (targets.depth_surface != nullptr && targets.write_depth_fb) {
+        OpenGL::SurfaceInterval interval =
+            targets.depth_surface->GetSubRectInterval(draw_rect_unscaled);
         res_cache.InvalidateRegion(boost::icl::first(interval), boost::icl::length(interval),
-                                   depth_surface);
+                                   targets.depth_surface);
     }
+}
 
-    return succeeded;
+void RasterizerOpenGL::FlushPendingDraw() {
+    if (!pending_draw) {
+        return;
+    }
+    const DrawTargets targets = std::move(*pending_draw);
+    pending_draw.reset();
+
+    // The renderer may have applied its own state in the meantime
+    state.Apply();
+    DrawVertexBatch();
+    FinishDraw(targets);
+}
+
+/// Whether writing the register has an effect even when it keeps its value
+static bool IsCommandRegister(u32 id) {
+    const auto InRange = [id](std::size_t first, std::size_t last) {
+        return id >= first && id <= last;
+    };
+    // The two registers after the output merger's flush and invalidate the framebuffer
+    return id == PICA_REG_INDEX(trigger_irq) ||
+           InRange(PICA_REG_INDEX(framebuffer.framebuffer),
+                   PICA_REG_INDEX(framebuffer.framebuffer) + 1) ||
+           InRange(PICA_REG_INDEX(texturing.fog_lut_data[0]),
+                   PICA_REG_INDEX(texturing.fog_lut_data[7])) ||
+           InRange(PICA_REG_INDEX(texturing.proctex_lut_data[0]),
+                   PICA_REG_INDEX(texturing.proctex_lut_data[7])) ||
+           InRange(PICA_REG_INDEX(lighting.lut_data[0]), PICA_REG_INDEX(lighting.lut_data[7]));
 }
 
 void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
     const Pica::Regs& regs = Pica::g_state.regs;
 
+    // The open batch is drawn before its state changes. Its vertices are already processed, so
+    // the vertex pipeline and shader registers don't affect it.
+    if (pending_draw && id < PICA_REG_INDEX(pipeline) &&
+        (regs.reg_array[id] != pending_draw_regs[id] || IsCommandRegister(id))) {
+        FlushPendingDraw();
+    }
+
     switch (id) {
     // Culling
     case PICA_REG_INDEX(rasterizer.cull_mode):
@@ -917,7 +1045,8 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(texturing.fog_lut_data[5]):
     case PICA_REG_INDEX(texturing.fog_lut_data[6]):
     case PICA_REG_INDEX(texturing.fog_lut_data[7]):
-        uniform_block_data.fog_lut_dirty = true;
+        // The entry was written at the offset before it got incremented
+        uniform_block_data.fog_lut_dirty.Add((regs.texturing.fog_lut_offset - 1) % 128);
         break;
 
     // ProcTex state
@@ -941,26 +1070,28 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(texturing.proctex_lut_data[4]):
     case PICA_REG_INDEX(texturing.proctex_lut_data[5]):
     case PICA_REG_INDEX(texturing.proctex_lut_data[6]):
-    case PICA_REG_INDEX(texturing.proctex_lut_data[7]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[7]): {
         using Pica::TexturingRegs;
+        const u32 index = (regs.texturing.proctex_lut_config.index - 1) & 0xFF;
         switch (regs.texturing.proctex_lut_config.ref_table.Value()) {
         case TexturingRegs::ProcTexLutTable::Noise:
-            uniform_block_data.proctex_noise_lut_dirty = true;
+            uniform_block_data.proctex_noise_lut_dirty.Add(index % 128);
             break;
         case TexturingRegs::ProcTexLutTable::ColorMap:
-            uniform_block_data.proctex_color_map_dirty = true;
+            uniform_block_data.proctex_color_map_dirty.Add(index % 128);
             break;
         case TexturingRegs::ProcTexLutTable::AlphaMap:
-            uniform_block_data.proctex_alpha_map_dirty = true;
+            uniform_block_data.proctex_alpha_map_dirty.Add(index % 128);
             break;
         case TexturingRegs::ProcTexLutTable::Color:
-            uniform_block_data.proctex_lut_dirty = true;
+            uniform_block_data.proctex_lut_dirty.Add(index);
             break;
         case TexturingRegs::ProcTexLutTable::ColorDiff:
-            uniform_block_data.proctex_diff_lut_dirty = true;
+            uniform_block_data.proctex_diff_lut_dirty.Add(index);
             break;
         }
         break;
+    }
 
     // Alpha test
     case PICA_REG_INDEX(framebuffer.output_merger.alpha_test):
@@ -1338,7 +1469,7 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(lighting.lut_data[6]):
     case PICA_REG_INDEX(lighting.lut_data[7]): {
         const Pica::LightingRegs::LutConfig lut_config = regs.lighting.lut_config;
-        uniform_block_data.lighting_lut_dirty[lut_config.type] = true;
+        uniform_block_data.lighting_lut_dirty[lut_config.type].Add((lut_config.index - 1) & 0xFF);
         uniform_block_data.lighting_lut_dirty_any = true;
         break;
     }
@@ -1346,23 +1477,29 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
 }
 
 void RasterizerOpenGL::FlushAll() {
+    FlushPendingDraw();
     res_cache.FlushAll();
 }
 
 void RasterizerOpenGL::FlushRegion(PAddr addr, u32 size) {
+    FlushPendingDraw();
     res_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(PAddr addr, u32 size) {
+    FlushPendingDraw();
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    FlushPendingDraw();
     res_cache.FlushRegion(addr, size);
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
+    FlushPendingDraw();
+
     SurfaceParams src_params;
     src_params.addr = config.GetPhysicalInputAddress();
     src_params.width = config.output_width;
@@ -1412,6 +1549,8 @@ bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransfe
 }
 
 bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) {
+    FlushPendingDraw();
+
     u32 copy_size = Common::AlignDown(config.texture_copy.size, 16);
     if (copy_size == 0) {
         return false;
@@ -1497,6 +1636,8 @@ bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferCon
 }
 
 bool RasterizerOpenGL::AccelerateFill(const GPU::Regs::MemoryFillConfig& config) {
+    FlushPendingDraw();
+
     Surface dst_surface = res_cache.GetFillSurface(config);
     if (dst_surface == nullptr)
         return false;
@@ -1508,6 +1649,8 @@ bool RasterizerOpenGL::AccelerateFill(const GPU::Regs::MemoryFillConfig& config)
 bool RasterizerOpenGL::AccelerateDisplay(const GPU::Regs::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
+    FlushPendingDraw();
+
     if (framebuffer_addr == 0) {
         return false;
     }
@@ -1617,8 +1760,8 @@ void RasterizerOpenGL::SamplerInfo::SyncWithConfig(
     }
 }
 
-void RasterizerOpenGL::SetShader() {
-    shader_program_manager->UseFragmentShader(Pica::g_state.regs);
+bool RasterizerOpenGL::SetShader() {
+    return shader_program_manager->UseFragmentShader(Pica::g_state.regs);
 }
 
 void RasterizerOpenGL::SyncClipEnabled() {
@@ -1939,198 +2082,157 @@ void RasterizerOpenGL::SyncShadowTextureBias() {
     }
 }
 
-void RasterizerOpenGL::SyncAndUploadLUTs() {
-    constexpr std::size_t max_size = sizeof(GLvec2) * 256 * Pica::LightingRegs::NumLightingSampler +
-                                     sizeof(GLvec2) * 128 +     // fog
-                                     sizeof(GLvec2) * 128 * 3 + // proctex: noise + color + alpha
-                                     sizeof(GLvec4) * 256 +     // proctex
-                                     sizeof(GLvec4) * 256;      // proctex diff
-
-    if (!uniform_block_data.lighting_lut_dirty_any && !uniform_block_data.fog_lut_dirty &&
-        !uniform_block_data.proctex_noise_lut_dirty &&
-        !uniform_block_data.proctex_color_map_dirty &&
-        !uniform_block_data.proctex_alpha_map_dirty && !uniform_block_data.proctex_lut_dirty &&
-        !uniform_block_data.proctex_diff_lut_dirty) {
-        return;
-    }
-
-    u8* buffer;
-    GLintptr offset;
-    bool invalidate;
-    std::size_t bytes_used = 0;
-    glBindBuffer(GL_TEXTURE_BUFFER, texture_buffer.GetHandle());
-    std::tie(buffer, offset, invalidate) = texture_buffer.Map(max_size, sizeof(GLvec4));
-
-    // Sync the lighting luts
-    if (uniform_block_data.lighting_lut_dirty_any || invalidate) {
-        for (unsigned index = 0; index < uniform_block_data.lighting_lut_dirty.size(); index++) {
-            if (uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<GLvec2, 256> new_data;
-                const Pica::State::Lighting::Lut& source_lut = Pica::g_state.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const Pica::State::Lighting::LutEntry& entry) {
-                                   return GLvec2{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
-                    std::memcpy(buffer + bytes_used, new_data.data(),
-                                new_data.size() * sizeof(GLvec2));
-                    uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
-                        (offset + bytes_used) / sizeof(GLvec2);
-                    uniform_block_data.dirty = true;
-                    bytes_used += new_data.size() * sizeof(GLvec2);
-                }
-                uniform_block_data.lighting_lut_dirty[index] = false;
-            }
+/**
+ * Converts the entries [begin, end) of a Pica LUT and uploads those that differ from lut_data, the
+ * copy of what lut_buffer holds at buffer_offset.
+ * @returns the number of bytes uploaded
+ */
+template <typename Entry, typename Value, std::size_t N, typename Converter>
+static std::size_t UploadLUTRange(const std::array<Entry, N>& lut, std::array<Value, N>& lut_data,
+                                  u32 begin, u32 end, std::size_t buffer_offset,
+                                  Converter&& convert) {
+    u32 first = end;
+    u32 last = begin;
+    for (u32 index = begin; index < end; index++) {
+        const Value value = convert(lut[index]);
+        if (value != lut_data[index]) {
+            lut_data[index] = value;
+            first = std::min(first, index);
+            last = index + 1;
         }
     }
-    uniform_block_data.lighting_lut_dirty_any = false;
-
-    // Sync the fog lut
-    if (uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<GLvec2, 128> new_data;
-
-        std::transform(Pica::g_state.fog.lut.begin(), Pica::g_state.fog.lut.end(), new_data.begin(),
-                       [](const Pica::State::Fog::LutEntry& entry) {
-                           return GLvec2{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(), new_data.size() * sizeof(GLvec2));
-            uniform_block_data.data.fog_lut_offset = (offset + bytes_used) / sizeof(GLvec2);
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(GLvec2);
-        }
-        uniform_block_data.fog_lut_dirty = false;
-    }
-
-    // Helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
-    auto SyncProcTexValueLUT = [this, buffer, offset, invalidate, &bytes_used](
-                                   const std::array<Pica::State::ProcTex::ValueEntry, 128>& lut,
-                                   std::array<GLvec2, 128>& lut_data, GLint& lut_offset) {
-        std::array<GLvec2, 128> new_data;
-        std::transform(lut.begin(), lut.end(), new_data.begin(),
-                       [](const Pica::State::ProcTex::ValueEntry& entry) {
-                           return GLvec2{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != lut_data || invalidate) {
-            lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(), new_data.size() * sizeof(GLvec2));
-            lut_offset = (offset + bytes_used) / sizeof(GLvec2);
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(GLvec2);
-        }
-    };
-
-    // Sync the proctex noise lut
-    if (uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        SyncProcTexValueLUT(Pica::g_state.proctex.noise_table, proctex_noise_lut_data,
-                            uniform_block_data.data.proctex_noise_lut_offset);
-        uniform_block_data.proctex_noise_lut_dirty = false;
+    if (first >= last) {
+        return 0;
     }
 
-    // Sync the proctex color map
-    if (uniform_block_data.proctex_color_map_dirty || invalidate) {
-        SyncProcTexValueLUT(Pica::g_state.proctex.color_map_table, proctex_color_map_data,
-                            uniform_block_data.data.proctex_color_map_offset);
-        uniform_block_data.proctex_color_map_dirty = false;
-    }
+    const std::size_t size = (last - first) * sizeof(Value);
+    glBufferSubData(GL_TEXTURE_BUFFER, buffer_offset + first * sizeof(Value), size,
+                    &lut_data[first]);
+    return size;
+}
 
-    // Sync the proctex alpha map
-    if (uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        SyncProcTexValueLUT(Pica::g_state.proctex.alpha_map_table, proctex_alpha_map_data,
-                            uniform_block_data.data.proctex_alpha_map_offset);
-        uniform_block_data.proctex_alpha_map_dirty = false;
+void RasterizerOpenGL::SyncAndUploadLUTs() {
+    if (!uniform_block_data.lighting_lut_dirty_any && uniform_block_data.fog_lut_dirty.Empty() &&
+        uniform_block_data.proctex_noise_lut_dirty.Empty() &&
+        uniform_block_data.proctex_color_map_dirty.Empty() &&
+        uniform_block_data.proctex_alpha_map_dirty.Empty() &&
+        uniform_block_data.proctex_lut_dirty.Empty() &&
+        uniform_block_data.proctex_diff_lut_dirty.Empty()) {
+        return;
     }
 
-    // Sync the proctex lut
-    if (uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<GLvec4, 256> new_data;
-
-        std::transform(Pica::g_state.proctex.color_table.begin(),
-                       Pica::g_state.proctex.color_table.end(), new_data.begin(),
-                       [](const Pica::State::ProcTex::ColorEntry& entry) {
-                           Common::Vec4f rgba = entry.ToVector() / 255.0f;
-                           return GLvec4{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
+    std::size_t bytes_used = 0;
+    glBindBuffer(GL_TEXTURE_BUFFER, lut_buffer.handle);
 
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(), new_data.size() * sizeof(GLvec4));
-            uniform_block_data.data.proctex_lut_offset = (offset + bytes_used) / sizeof(GLvec4);
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(GLvec4);
+    // Helper function for the LUTs, which all have a dirty range that is reset once uploaded
+    const auto SyncLUT = [&bytes_used](const auto& lut, auto& lut_data, LutDirtyRange& dirty,
+                                       std::size_t buffer_offset, auto&& convert) {
+        if (dirty.Empty()) {
+            return;
         }
+        bytes_used +=
+            UploadLUTRange(lut, lut_data, dirty.begin, dirty.end, buffer_offset, convert);
+        dirty = {};
+    };
 
-        uniform_block_data.proctex_lut_dirty = false;
-    }
-
-    // Sync the proctex difference lut
-    if (uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<GLvec4, 256> new_data;
-
-        std::transform(Pica::g_state.proctex.color_diff_table.begin(),
-                       Pica::g_state.proctex.color_diff_table.end(), new_data.begin(),
-                       [](const Pica::State::ProcTex::ColorDifferenceEntry& entry) {
-                           Common::Vec4f rgba = entry.ToVector() / 255.0f;
-                           return GLvec4{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
+    const auto ToGLvec2 = [](const auto& entry) {
+        return GLvec2{entry.ToFloat(), entry.DiffToFloat()};
+    };
+    const auto ToGLvec4 = [](const auto& entry) {
+        Common::Vec4f rgba = entry.ToVector() / 255.0f;
+        return GLvec4{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+    };
 
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(), new_data.size() * sizeof(GLvec4));
-            uniform_block_data.data.proctex_diff_lut_offset =
-                (offset + bytes_used) / sizeof(GLvec4);
-            uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(GLvec4);
+    // Sync the lighting luts
+    if (uniform_block_data.lighting_lut_dirty_any) {
+        for (unsigned index = 0; index < uniform_block_data.lighting_lut_dirty.size(); index++) {
+            SyncLUT(Pica::g_state.lighting.luts[index], lighting_lut_data[index],
+                    uniform_block_data.lighting_lut_dirty[index],
+                    LightingLutOffset + sizeof(lighting_lut_data[index]) * index, ToGLvec2);
         }
-        uniform_block_data.proctex_diff_lut_dirty = false;
+        uniform_block_data.lighting_lut_dirty_any = false;
     }
 
-    texture_buffer.Unmap(bytes_used);
+    // Sync the fog lut
+    SyncLUT(Pica::g_state.fog.lut, fog_lut_data, uniform_block_data.fog_lut_dirty, FogLutOffset,
+            ToGLvec2);
+
+    // Sync the proctex luts
+    SyncLUT(Pica::g_state.proctex.noise_table, proctex_noise_lut_data,
+            uniform_block_data.proctex_noise_lut_dirty, ProcTexNoiseLutOffset, ToGLvec2);
+    SyncLUT(Pica::g_state.proctex.color_map_table, proctex_color_map_data,
+            uniform_block_data.proctex_color_map_dirty, ProcTexColorMapOffset, ToGLvec2);
+    SyncLUT(Pica::g_state.proctex.alpha_map_table, proctex_alpha_map_data,
+            uniform_block_data.proctex_alpha_map_dirty, ProcTexAlphaMapOffset, ToGLvec2);
+    SyncLUT(Pica::g_state.proctex.color_table, proctex_lut_data,
+            uniform_block_data.proctex_lut_dirty, ProcTexLutOffset, ToGLvec4);
+    SyncLUT(Pica::g_state.proctex.color_diff_table, proctex_diff_lut_data,
+            uniform_block_data.proctex_diff_lut_dirty, ProcTexDiffLutOffset, ToGLvec4);
+
+    AccountUpload(bytes_used, 0);
 }
 
 void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
-    // glBindBufferRange below also changes the generic buffer binding point, so we sync the state
-    // first
-    state.draw.uniform_buffer = uniform_buffer.GetHandle();
-    state.Apply();
-
-    bool sync_vs = accelerate_draw;
-    bool sync_fs = uniform_block_data.dirty;
+    std::size_t uniform_bytes = 0;
+
+    // The fragment uniforms stay in place, only the bytes that differ from the last upload are
+    // sent
+    if (uniform_block_data.dirty) {
+        const auto* const data = reinterpret_cast<const u8*>(&uniform_block_data.data);
+        auto* const uploaded = reinterpret_cast<u8*>(&uploaded_uniform_data);
+        std::size_t begin = 0;
+        std::size_t end = sizeof(UniformData);
+        while (begin < end && data[begin] == uploaded[begin]) {
+            begin++;
+        }
+        while (end > begin && data[end - 1] == uploaded[end - 1]) {
+            end--;
+        }
+        if (begin < end) {
+            state.draw.uniform_buffer = uniform_buffer_fs.handle;
+            state.Apply();
+            glBufferSubData(GL_UNIFORM_BUFFER, begin, end - begin, data + begin);
+            std::memcpy(uploaded + begin, data + begin, end - begin);
+            uniform_bytes += end - begin;
+        }
+        uniform_block_data.dirty = false;
+    }
 
-    if (!sync_vs && !sync_fs)
-        return;
+    if (accelerate_draw) {
+        // glBindBufferRange below also changes the generic buffer binding point, so we sync the
+        // state first
+        state.draw.uniform_buffer = uniform_buffer.GetHandle();
+        state.Apply();
 
-    std::size_t uniform_size = uniform_size_aligned_vs + uniform_size_aligned_fs;
-    std::size_t used_bytes = 0;
-    u8* uniforms;
-    GLintptr offset;
-    bool invalidate;
-    std::tie(uniforms, offset, invalidate) =
-        uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
+        u8* uniforms;
+        GLintptr offset;
+        std::tie(uniforms, offset, std::ignore) =
+            uniform_buffer.Map(uniform_size_aligned_vs, uniform_buffer_alignment);
 
-    if (sync_vs) {
         VSUniformData vs_uniforms;
         vs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+        std::memcpy(uniforms, &vs_uniforms, sizeof(vs_uniforms));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::VS),
-                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(VSUniformData));
-        used_bytes += uniform_size_aligned_vs;
+                          uniform_buffer.GetHandle(), offset, sizeof(VSUniformData));
+        uniform_buffer.Unmap(uniform_size_aligned_vs);
+        uniform_bytes += sizeof(VSUniformData);
     }
 
-    if (sync_fs || invalidate) {
-        std::memcpy(uniforms + used_bytes, &uniform_block_data.data, sizeof(UniformData));
-        glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::Common),
-                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(UniformData));
-        uniform_block_data.dirty = false;
-        used_bytes += uniform_size_aligned_fs;
-    }
+    AccountUpload(0, uniform_bytes);
+}
 
-    uniform_buffer.Unmap(used_bytes);
+void RasterizerOpenGL::AccountUpload(u64 lut_bytes, u64 uniform_bytes) {
+    const int frame = VideoCore::g_renderer->GetCurrentFrame();
+    if (frame != upload_stats_frame) {
+        last_frame_upload_stats = frame_upload_stats;
+        frame_upload_stats = {};
+        upload_stats_frame = frame;
+        upload_stats_frames++;
+    }
+    frame_upload_stats.lut_bytes += lut_bytes;
+    frame_upload_stats.uniform_bytes += uniform_bytes;
+    total_upload_stats.lut_bytes += lut_bytes;
+    total_upload_stats.uniform_bytes += uniform_bytes;
 }
 
 } // namespace OpenGL
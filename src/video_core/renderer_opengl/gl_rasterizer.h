@@ -4,14 +4,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <glad/glad.h>
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "common/math_util.h"
 #include "common/vector_math.h"
 #include "core/hw/gpu.h"
 #include "video_core/pica_state.h"
@@ -60,7 +63,41 @@ public:
                            u32 pixel_stride, ScreenInfo& screen_info) override;
     bool AccelerateDrawBatch(bool is_indexed) override;
 
+    struct UploadStats {
+        u64 lut_bytes = 0;     ///< Lighting, fog and procedural texture LUT data
+        u64 uniform_bytes = 0; ///< Vertex and fragment shader uniform data
+    };
+
+    /// Returns the bytes uploaded to the GPU during the last complete frame
+    UploadStats GetFrameUploadStats() const {
+        return last_frame_upload_stats;
+    }
+
+    struct DrawStats {
+        u64 pica_draws = 0; ///< Draws received from the PICA
+        u64 gl_draws = 0;   ///< Draws issued to OpenGL, after merging
+    };
+
+    DrawStats GetDrawStats() const {
+        return draw_stats;
+    }
+
 private:
+    /// Range of LUT entries modified since the last upload
+    struct LutDirtyRange {
+        u32 begin = 0;
+        u32 end = 0;
+
+        bool Empty() const {
+            return begin == end;
+        }
+
+        void Add(u32 index) {
+            begin = Empty() ? index : std::min(begin, index);
+            end = Empty() ? index + 1 : std::max(end, index + 1);
+        }
+    };
+
     struct SamplerInfo {
         using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
@@ -140,8 +177,11 @@ private:
     /// Syncs the clip coefficients to match the PICA register
     void SyncClipCoef();
 
-    /// Sets the OpenGL shader in accordance with the current PICA register state
-    void SetShader();
+    /**
+     * Sets the OpenGL shader in accordance with the current PICA register state
+     * @returns false if the ubershader is used while the shader compiles
+     */
+    bool SetShader();
 
     /// Syncs the cull mode to match the PICA register
     void SyncCullMode();
@@ -236,9 +276,33 @@ private:
     /// Upload the uniform blocks to the uniform buffer object
     void UploadUniforms(bool accelerate_draw);
 
+    /// Adds uploaded bytes to the counters of the current frame
+    void AccountUpload(u64 lut_bytes, u64 uniform_bytes);
+
+    /// Framebuffer state of a draw, needed once its vertices are submitted
+    struct DrawTargets {
+        Surface color_surface;
+        Surface depth_surface;
+        Common::Rectangle<u32> draw_rect;
+        u16 res_scale;
+        bool write_color_fb;
+        bool write_depth_fb;
+        bool shadow_rendering;
+        bool need_texture_barrier;
+    };
+
     /// Generic draw function for DrawTriangles and AccelerateDrawBatch
     bool Draw(bool accelerate, bool is_indexed);
 
+    /// Uploads the software vertex batch and draws it
+    void DrawVertexBatch();
+
+    /// Unbinds the textures of a draw and marks the surfaces it rendered to as dirty
+    void FinishDraw(const DrawTargets& targets);
+
+    /// Draws the software vertex batch that is kept open for merging, if there is one
+    void FlushPendingDraw();
+
     /// Internal implementation for AccelerateDrawBatch
     bool AccelerateDrawBatchInternal(bool is_indexed);
 
@@ -272,28 +336,37 @@ private:
 
     std::vector<HardwareVertex> vertex_batch;
 
+    /// Targets of the software vertex batch while it is kept open. Consecutive draws are appended
+    /// to it until a register they depend on changes.
+    std::optional<DrawTargets> pending_draw;
+    /// Registers when the open batch was set up, to tell which writes change its state
+    std::array<u32, Pica::Regs::NUM_REGS> pending_draw_regs;
+    DrawStats draw_stats;
+
     bool shader_dirty;
 
     struct {
         UniformData data;
-        std::array<bool, Pica::LightingRegs::NumLightingSampler> lighting_lut_dirty;
+        std::array<LutDirtyRange, Pica::LightingRegs::NumLightingSampler> lighting_lut_dirty;
         bool lighting_lut_dirty_any;
-        bool fog_lut_dirty;
-        bool proctex_noise_lut_dirty;
-        bool proctex_color_map_dirty;
-        bool proctex_alpha_map_dirty;
-        bool proctex_lut_dirty;
-        bool proctex_diff_lut_dirty;
+        LutDirtyRange fog_lut_dirty;
+        LutDirtyRange proctex_noise_lut_dirty;
+        LutDirtyRange proctex_color_map_dirty;
+        LutDirtyRange proctex_alpha_map_dirty;
+        LutDirtyRange proctex_lut_dirty;
+        LutDirtyRange proctex_diff_lut_dirty;
         bool dirty;
     } uniform_block_data = {};
 
+    /// Copy of the fragment uniforms last sent to uniform_buffer_fs, to upload only what changed
+    UniformData uploaded_uniform_data = {};
+
     std::unique_ptr<ShaderProgramManager> shader_program_manager;
 
     // They shall be big enough for about one frame.
     static constexpr std::size_t VERTEX_BUFFER_SIZE = 16 * 1024 * 1024;
     static constexpr std::size_t INDEX_BUFFER_SIZE = 1 * 1024 * 1024;
     static constexpr std::size_t UNIFORM_BUFFER_SIZE = 2 * 1024 * 1024;
-    static constexpr std::size_t TEXTURE_BUFFER_SIZE = 1 * 1024 * 1024;
 
     OGLVertexArray sw_vao; // VAO for software shader draw
     OGLVertexArray hw_vao; // VAO for hardware shader / accelerate draw
@@ -303,11 +376,11 @@ private:
     OGLStreamBuffer vertex_buffer;
     OGLStreamBuffer uniform_buffer;
     OGLStreamBuffer index_buffer;
-    OGLStreamBuffer texture_buffer;
+    OGLBuffer uniform_buffer_fs; // Fragment uniforms, updated in place
+    OGLBuffer lut_buffer;        // LUTs at fixed offsets, updated in place
     OGLFramebuffer framebuffer;
     GLint uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs;
-    std::size_t uniform_size_aligned_fs;
 
     SamplerInfo texture_cube_sampler;
 
@@ -322,6 +395,12 @@ private:
     std::array<GLvec4, 256> proctex_lut_data{};
     std::array<GLvec4, 256> proctex_diff_lut_data{};
 
+    UploadStats frame_upload_stats;
+    UploadStats last_frame_upload_stats;
+    UploadStats total_upload_stats;
+    int upload_stats_frame = 0;
+    u64 upload_stats_frames = 0;
+
     bool allow_shadow;
 };
 
@@ -17,6 +17,7 @@
 #include "common/alignment.h"
 #include "common/bit_field.h"
 #include "common/color.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/scope_exit.h"
@@ -1208,6 +1209,12 @@ void main() {
 }
 
 RasterizerCacheOpenGL::~RasterizerCacheOpenGL() {
+    if (residency_stats.evictions != 0) {
+        LOG_INFO(Render_OpenGL, "Evicted {} surfaces ({} MiB), {} MiB of guest memory was reloaded",
+                 residency_stats.evictions, residency_stats.evicted_bytes >> 20,
+                 residency_stats.reload_bytes >> 20);
+    }
+
     FlushAll();
     while (!surface_cache.empty()) {
         UnregisterSurface(*surface_cache.begin()->second.begin());
@@ -1287,6 +1294,11 @@ void RasterizerCacheOpenGL::ConvertD24S8toABGR(GLuint src_tex,
     glBindTexture(GL_TEXTURE_BUFFER, 0);
 }
 
+/// Marks the surface as used in the current frame
+static void MarkSurfaceUsed(const Surface& surface) {
+    surface->last_used_frame = VideoCore::g_renderer->GetCurrentFrame();
+}
+
 Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatch match_res_scale,
                                           bool load_if_create) {
     if (params.addr == 0 || params.height * params.width == 0) {
@@ -1327,6 +1339,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
         surface = CreateSurface(new_params);
         RegisterSurface(surface);
     }
+    MarkSurfaceUsed(surface);
 
     if (load_if_create) {
         ValidateSurface(surface, params.addr, params.size);
@@ -1408,8 +1421,11 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
         new_params.UpdateParams();
         // GetSurface will create the new surface and possibly adjust res_scale if necessary
         surface = GetSurface(new_params, match_res_scale, load_if_create);
-    } else if (load_if_create) {
-        ValidateSurface(surface, aligned_params.addr, aligned_params.size);
+    } else {
+        MarkSurfaceUsed(surface);
+        if (load_if_create) {
+            ValidateSurface(surface, aligned_params.addr, aligned_params.size);
+        }
     }
 
     return std::make_tuple(surface, surface->GetScaledSubRect(params));
@@ -1761,6 +1777,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetTexCopySurface(const SurfaceParams&
         surface_cache, params, ScaleMatch::Ignore);
 
     if (match_surface != nullptr) {
+        MarkSurfaceUsed(match_surface);
         ValidateSurface(match_surface, params.addr, params.size);
 
         SurfaceParams match_subrect;
@@ -1790,6 +1807,7 @@ void RasterizerCacheOpenGL::DuplicateSurface(const Surface& src_surface,
 
     dest_surface->invalid_regions -= src_surface->GetInterval();
     dest_surface->invalid_regions += src_surface->invalid_regions;
+    dest_surface->ForgetUploadHashes(src_surface->GetInterval());
 
     SurfaceRegions regions;
     for (const auto& pair : RangeFromInterval(dirty_regions, src_surface->GetInterval())) {
@@ -1802,6 +1820,17 @@ void RasterizerCacheOpenGL::DuplicateSurface(const Surface& src_surface,
     }
 }
 
+/// Hashes the guest memory in the interval, if it is contiguous in host memory
+static std::optional<u64> HashGuestMemory(SurfaceInterval interval) {
+    const u8* const first = VideoCore::g_memory->GetPhysicalPointer(boost::icl::first(interval));
+    const u8* const last = VideoCore::g_memory->GetPhysicalPointer(boost::icl::last(interval));
+    const std::size_t size = boost::icl::length(interval);
+    if (first == nullptr || last == nullptr || static_cast<std::size_t>(last - first) != size - 1) {
+        return std::nullopt;
+    }
+    return Common::ComputeHash64(first, size);
+}
+
 void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr, u32 size) {
     if (size == 0) {
         return;
@@ -1831,6 +1860,7 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
         if (copy_surface != nullptr) {
             SurfaceInterval copy_interval = params.GetCopyableInterval(copy_surface);
             CopySurface(copy_surface, surface, copy_interval);
+            surface->ForgetUploadHashes(copy_interval);
             surface->invalid_regions.erase(copy_interval);
             continue;
         }
@@ -1865,6 +1895,7 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
                 ConvertD24S8toABGR(reinterpret_surface->texture.handle, src_rect,
                                    surface->texture.handle, dest_rect);
 
+                surface->ForgetUploadHashes(convert_interval);
                 surface->invalid_regions.erase(convert_interval);
                 continue;
             }
@@ -1872,9 +1903,36 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
 
         // Load data from 3DS memory
         FlushRegion(params.addr, params.size);
+        for (const auto& evicted : RangeFromInterval(evicted_regions, params.GetInterval())) {
+            residency_stats.reload_bytes += boost::icl::length(evicted & params.GetInterval());
+        }
+        evicted_regions -= params.GetInterval();
+
+        // Custom textures replace the whole texture, so their uploads can't be tracked by range
+        std::optional<u64> upload_hash;
+        if (Settings::values.hash_texture_uploads && !Settings::values.custom_textures) {
+            upload_hash = HashGuestMemory(params.GetInterval());
+        }
+        if (upload_hash) {
+            VideoCore::g_texture_hash_lookups++;
+            const auto match = std::find(surface->upload_hashes.begin(),
+                                         surface->upload_hashes.end(),
+                                         std::make_pair(params.GetInterval(), *upload_hash));
+            if (match != surface->upload_hashes.end()) {
+                // The texture still holds the same data
+                VideoCore::g_texture_hash_hits++;
+                surface->invalid_regions.erase(params.GetInterval());
+                continue;
+            }
+        }
+
         surface->LoadGLBuffer(params.addr, params.end);
         surface->UploadGLTexture(surface->GetSubRect(params), read_framebuffer.handle,
                                  draw_framebuffer.handle);
+        surface->ForgetUploadHashes(params.GetInterval());
+        if (upload_hash) {
+            surface->upload_hashes.emplace_back(params.GetInterval(), *upload_hash);
+        }
         surface->invalid_regions.erase(params.GetInterval());
     }
 }
@@ -1932,6 +1990,7 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
         // Surfaces can't have a gap
         ASSERT(region_owner->width == region_owner->stride);
         region_owner->invalid_regions.erase(invalid_interval);
+        region_owner->ForgetUploadHashes(invalid_interval);
     }
 
     for (auto& pair : RangeFromInterval(surface_cache, invalid_interval)) {
@@ -1966,6 +2025,8 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
     } else {
         dirty_regions.erase(invalid_interval);
     }
+    // The memory changed, loading it again is no longer due to an eviction
+    evicted_regions -= invalid_interval;
 
     for (const OpenGL::Surface& remove_surface : remove_surfaces) {
         if (remove_surface == region_owner) {
@@ -1986,6 +2047,62 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
     remove_surfaces.clear();
 }
 
+void RasterizerCacheOpenGL::EvictSurfaces() {
+    const u64 budget = u64{Settings::values.texture_memory_budget} << 20;
+    const int current_frame = VideoCore::g_renderer->GetCurrentFrame();
+    if (budget == 0 || residency_stats.resident_bytes <= budget ||
+        eviction_frame == current_frame) {
+        return;
+    }
+    eviction_frame = current_frame;
+
+    SurfaceSet dirty_surfaces;
+    for (const auto& pair : dirty_regions) {
+        dirty_surfaces.insert(pair.second);
+    }
+
+    SurfaceSet unused_surfaces;
+    for (const auto& pair : surface_cache) {
+        for (const Surface& surface : pair.second) {
+            if (surface->last_used_frame != current_frame && surface->resident_bytes != 0) {
+                unused_surfaces.insert(surface);
+            }
+        }
+    }
+
+    // Clean surfaces first, as they don't have to be written back, then the least recently used
+    std::vector<std::pair<bool, Surface>> candidates;
+    candidates.reserve(unused_surfaces.size());
+    for (const Surface& surface : unused_surfaces) {
+        candidates.emplace_back(dirty_surfaces.count(surface) != 0, surface);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return std::tie(lhs.first, lhs.second->last_used_frame) <
+               std::tie(rhs.first, rhs.second->last_used_frame);
+    });
+
+    for (const auto& [dirty, surface] : candidates) {
+        if (residency_stats.resident_bytes <= budget) {
+            break;
+        }
+        if (dirty) {
+            FlushRegion(surface->addr, surface->size, surface);
+        }
+
+        SurfaceRegions valid_regions(surface->GetInterval());
+        valid_regions -= surface->invalid_regions;
+        evicted_regions += valid_regions;
+
+        residency_stats.evictions++;
+        residency_stats.evicted_bytes += surface->resident_bytes;
+        surface->UnlinkAllWatcher();
+        UnregisterSurface(surface);
+    }
+
+    LOG_DEBUG(Render_OpenGL, "{} MiB of textures resident after eviction, budget {} MiB",
+              residency_stats.resident_bytes >> 20, budget >> 20);
+}
+
 Surface RasterizerCacheOpenGL::CreateSurface(const SurfaceParams& params) {
     Surface surface = std::make_shared<CachedSurface>();
     static_cast<SurfaceParams&>(*surface) = params;
@@ -2006,6 +2123,12 @@ void RasterizerCacheOpenGL::RegisterSurface(const Surface& surface) {
     }
     surface->registered = true;
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
+    MarkSurfaceUsed(surface);
+    if (surface->type != SurfaceType::Fill) {
+        surface->resident_bytes = u64{surface->GetScaledWidth()} * surface->GetScaledHeight() *
+                                  CachedSurface::GetGLBytesPerPixel(surface->pixel_format);
+        residency_stats.resident_bytes += surface->resident_bytes;
+    }
     UpdatePagesCachedCount(surface->addr, surface->size, 1);
 }
 
@@ -2014,6 +2137,8 @@ void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
         return;
     }
     surface->registered = false;
+    residency_stats.resident_bytes -= surface->resident_bytes;
+    surface->resident_bytes = 0;
     UpdatePagesCachedCount(surface->addr, surface->size, -1);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
 }
@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <list>
 #include <memory>
 #include <set>
 #include <tuple>
+#include <utility>
+#include <vector>
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
@@ -352,6 +355,24 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
     bool registered = false;
     SurfaceRegions invalid_regions;
 
+    /// Frame the surface was last looked up in, the least recently used surfaces are evicted first
+    int last_used_frame = 0;
+    /// Video memory accounted to the texture while the surface is registered
+    u64 resident_bytes = 0;
+
+    /// Hashes of the guest memory the texture was last uploaded from, with the uploaded intervals
+    std::vector<std::pair<SurfaceInterval, u64>> upload_hashes;
+
+    /// Forgets the upload hashes overlapping an interval whose texture data is overwritten
+    void ForgetUploadHashes(SurfaceInterval interval) {
+        upload_hashes.erase(std::remove_if(upload_hashes.begin(), upload_hashes.end(),
+                                           [&interval](const auto& upload) {
+                                               return boost::icl::intersects(upload.first,
+                                                                             interval);
+                                           }),
+                            upload_hashes.end());
+    }
+
     u32 fill_size = 0; /// Number of bytes to read from fill_data
     std::array<u8, 4> fill_data;
 
@@ -435,6 +456,15 @@ struct CachedTextureCube {
 
 class RasterizerCacheOpenGL : NonCopyable {
 public:
+    struct ResidencyStats {
+        /// Video memory taken by the textures of cached surfaces
+        u64 resident_bytes = 0;
+        u64 evictions = 0;
+        u64 evicted_bytes = 0;
+        /// Guest memory that had to be decoded again because its surface was evicted
+        u64 reload_bytes = 0;
+    };
+
     RasterizerCacheOpenGL();
     ~RasterizerCacheOpenGL();
 
@@ -484,6 +514,18 @@ public:
     /// Flush all cached resources tracked by this cache manager
     void FlushAll();
 
+    /**
+     * Evicts the least recently used surfaces until their textures fit in the texture memory
+     * budget. Surfaces used in the current frame are kept, and clean surfaces go before dirty ones,
+     * which are written back to memory first. Runs at most once per frame, and must not be called
+     * while surfaces returned by the cache are still in use.
+     */
+    void EvictSurfaces();
+
+    ResidencyStats GetResidencyStats() const {
+        return residency_stats;
+    }
+
 private:
     void DuplicateSurface(const Surface& src_surface, const Surface& dest_surface);
 
@@ -507,6 +549,11 @@ private:
     SurfaceMap dirty_regions;
     SurfaceSet remove_surfaces;
 
+    /// Regions whose surfaces were evicted while valid, reloading them counts as reload cost
+    SurfaceRegions evicted_regions;
+    ResidencyStats residency_stats;
+    int eviction_frame = -1;
+
     OGLFramebuffer read_framebuffer;
     OGLFramebuffer draw_framebuffer;
 
@@ -245,6 +245,84 @@ PicaFSConfig PicaFSConfig::BuildFromRegs(const Pica::Regs& regs) {
     return res;
 }
 
+UberShaderConfig UberShaderConfig::BuildFromFSConfig(const PicaFSConfig& config) {
+    const PicaFSConfigState& state = config.state;
+    const PicaFSConfigState::Lighting& lighting = state.lighting;
+    const auto supported = [&lighting](LightingRegs::LightingSampler sampler) {
+        return LightingRegs::IsLightingSamplerSupported(lighting.config, sampler);
+    };
+
+    UberShaderConfig res{};
+
+    for (std::size_t i = 0; i < state.tev_stages.size(); ++i) {
+        res.tev_stages[i * 4 + 0] = state.tev_stages[i].sources_raw;
+        res.tev_stages[i * 4 + 1] = state.tev_stages[i].modifiers_raw;
+        res.tev_stages[i * 4 + 2] = state.tev_stages[i].ops_raw;
+        res.tev_stages[i * 4 + 3] = state.tev_stages[i].scales_raw;
+    }
+
+    res.state.alpha_test_func.Assign(static_cast<u32>(state.alpha_test_func));
+    res.state.scissor_test_mode.Assign(static_cast<u32>(state.scissor_test_mode));
+    res.state.texture0_type.Assign(static_cast<u32>(state.texture0_type));
+    res.state.texture2_use_coord1.Assign(state.texture2_use_coord1);
+    res.state.combiner_buffer_update_rgb.Assign(state.combiner_buffer_input & 0xF);
+    res.state.combiner_buffer_update_a.Assign(state.combiner_buffer_input >> 4);
+    res.state.w_buffering.Assign(state.depthmap_enable ==
+                                 RasterizerRegs::DepthBuffering::WBuffering);
+    res.state.fog_mode.Assign(static_cast<u32>(state.fog_mode));
+    res.state.fog_flip.Assign(state.fog_flip);
+    res.state.lighting_enable.Assign(lighting.enable);
+    res.state.shadow_rendering.Assign(state.shadow_rendering);
+    res.state.shadow_texture_orthographic.Assign(state.shadow_texture_orthographic);
+
+    res.lighting.src_num.Assign(lighting.src_num);
+    res.lighting.bump_mode.Assign(static_cast<u32>(lighting.bump_mode));
+    res.lighting.bump_selector.Assign(lighting.bump_selector);
+    res.lighting.bump_renorm.Assign(lighting.bump_renorm);
+    res.lighting.clamp_highlights.Assign(lighting.clamp_highlights);
+    res.lighting.enable_primary_alpha.Assign(lighting.enable_primary_alpha);
+    res.lighting.enable_secondary_alpha.Assign(lighting.enable_secondary_alpha);
+    res.lighting.enable_shadow.Assign(lighting.enable_shadow);
+    res.lighting.shadow_primary.Assign(lighting.shadow_primary);
+    res.lighting.shadow_secondary.Assign(lighting.shadow_secondary);
+    res.lighting.shadow_invert.Assign(lighting.shadow_invert);
+    res.lighting.shadow_alpha.Assign(lighting.shadow_alpha);
+    res.lighting.shadow_selector.Assign(lighting.shadow_selector);
+    res.lighting.cp_input_supported.Assign(lighting.config ==
+                                           LightingRegs::LightingConfig::Config7);
+
+    const bool spot_atten_supported =
+        supported(LightingRegs::LightingSampler::SpotlightAttenuation);
+    for (std::size_t i = 0; i < res.lights.size(); ++i) {
+        const PicaFSConfigState::Lighting::Light& light = lighting.light[i];
+        res.lights[i].num.Assign(light.num);
+        res.lights[i].directional.Assign(light.directional);
+        res.lights[i].two_sided_diffuse.Assign(light.two_sided_diffuse);
+        res.lights[i].dist_atten_enable.Assign(light.dist_atten_enable);
+        res.lights[i].spot_atten_enable.Assign(light.spot_atten_enable && spot_atten_supported);
+        res.lights[i].geometric_factor_0.Assign(light.geometric_factor_0);
+        res.lights[i].geometric_factor_1.Assign(light.geometric_factor_1);
+        res.lights[i].shadow_enable.Assign(light.shadow_enable);
+    }
+
+    const auto set_lut = [&](LutIndex index, const auto& lut,
+                             LightingRegs::LightingSampler sampler) {
+        res.luts[index].enable.Assign(lut.enable && supported(sampler));
+        res.luts[index].abs_input.Assign(lut.abs_input);
+        res.luts[index].type.Assign(lut.type);
+        res.lut_scales[index] = lut.scale;
+    };
+    set_lut(D0, lighting.lut_d0, LightingRegs::LightingSampler::Distribution0);
+    set_lut(D1, lighting.lut_d1, LightingRegs::LightingSampler::Distribution1);
+    set_lut(SP, lighting.lut_sp, LightingRegs::LightingSampler::SpotlightAttenuation);
+    set_lut(FR, lighting.lut_fr, LightingRegs::LightingSampler::Fresnel);
+    set_lut(RR, lighting.lut_rr, LightingRegs::LightingSampler::ReflectRed);
+    set_lut(RG, lighting.lut_rg, LightingRegs::LightingSampler::ReflectGreen);
+    set_lut(RB, lighting.lut_rb, LightingRegs::LightingSampler::ReflectBlue);
+
+    return res;
+}
+
 void PicaShaderConfigCommon::Init(const Pica::ShaderRegs& regs, Pica::Shader::ShaderSetup& setup) {
     program_hash = setup.GetProgramCodeHash();
     swizzle_hash = setup.GetSwizzleDataHash();
@@ -1232,9 +1310,35 @@ float ProcTexNoiseCoef(vec2 x) {
     }
 }
 
-std::string GenerateFragmentShader(const PicaFSConfig& config, bool separable_shader) {
-    const OpenGL::PicaFSConfigState& state = config.state;
+/// Merges the fragment depth and the green component of the TEV output into the shadow buffer
+static const std::string ShadowBufferUpdate = R"(#if ALLOW_SHADOW
+uint d = uint(clamp(depth, 0.0, 1.0) * 0xFFFFFF);
+uint s = uint(last_tex_env_out.g * 0xFF);
+ivec2 image_coord = ivec2(gl_FragCoord.xy);
 
+uint old = imageLoad(shadow_buffer, image_coord).x;
+uint new;
+uint old2;
+do {
+    old2 = old;
+
+    uvec2 ref = DecodeShadow(old);
+    if (d < ref.x) {
+        if (s == 0u) {
+            ref.x = d;
+        } else {
+            s = uint(float(s) / (shadow_bias_constant + shadow_bias_linear * float(d) / float(ref.x)));
+            ref.y = min(s, ref.y);
+        }
+    }
+    new = EncodeShadow(ref);
+
+} while ((old = imageAtomicCompSwap(shadow_buffer, image_coord, old, new)) != old2);
+#endif // ALLOW_SHADOW
+)";
+
+/// Returns the version, inputs, outputs and uniforms shared by all fragment shaders
+static std::string GetFragmentShaderHeader(bool separable_shader) {
     std::string out = R"(#version 330 core
 
 #extension GL_ARB_shader_image_load_store : enable
@@ -1271,7 +1375,15 @@ layout(r32ui) uniform uimage2D shadow_buffer;
 
     out += UniformBlockDef;
 
-    out += R"(
+    return out;
+}
+
+/**
+ * Returns the helper functions shared by all fragment shaders
+ * @param shadow_projection code that projects the coordinates of shadow textures, if any
+ */
+static std::string GetFragmentShaderHelpers(const std::string& shadow_projection) {
+    std::string out = R"(
 // Rotate the vector v by the quaternion q
 vec3 quaternion_rotate(vec4 q, vec3 v) {
     return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
@@ -1348,9 +1460,7 @@ float mix2(vec4 s, vec2 a) {
 
 vec4 shadowTexture(vec2 uv, float w) {
 )";
-    if (!config.state.shadow_texture_orthographic) {
-        out += "uv /= w;";
-    }
+    out += shadow_projection;
     out += "uint z = uint(max(0, int(min(abs(w), 1.0) * 0xFFFFFF) - shadow_texture_bias));";
     out += R"(
     vec2 coord = vec2(imageSize(shadow_texture_px)) * uv - vec2(0.5);
@@ -1461,6 +1571,15 @@ vec4 shadowTextureCube(vec2 uv, float w) {
 #endif
 )";
 
+    return out;
+}
+
+std::string GenerateFragmentShader(const PicaFSConfig& config, bool separable_shader) {
+    const OpenGL::PicaFSConfigState& state = config.state;
+
+    std::string out = GetFragmentShaderHeader(separable_shader);
+    out += GetFragmentShaderHelpers(state.shadow_texture_orthographic ? "" : "uv /= w;");
+
     if (config.state.proctex.enable)
         AppendProcTexSampler(out, config);
 
@@ -1483,10 +1602,11 @@ vec4 shadowTextureCube(vec2 uv, float w) {
         out += "if (";
         // Negate the condition if we have to keep only the pixels outside the scissor box
         if (state.scissor_test_mode == RasterizerRegs::ScissorMode::Include)
-            out += "!(gl_FragCoord.x >= scissor_x1 && "
-                   "gl_FragCoord.y >= scissor_y1 && "
-                   "gl_FragCoord.x < scissor_x2 && "
-                   "gl_FragCoord.y < scissor_y2)) discard;\n";
+            out += "!";
+        out += "(gl_FragCoord.x >= scissor_x1 && "
+               "gl_FragCoord.y >= scissor_y1 && "
+               "gl_FragCoord.x < scissor_x2 && "
+               "gl_FragCoord.y < scissor_y2)) discard;\n";
     }
 
     // After perspective divide, OpenGL transform z_over_w from [-1, 1] to [near, far]. Here we use
@@ -1540,38 +1660,497 @@ vec4 shadowTextureCube(vec2 uv, float w) {
     }
 
     if (state.shadow_rendering) {
-        out += R"(#if ALLOW_SHADOW
-uint d = uint(clamp(depth, 0.0, 1.0) * 0xFFFFFF);
-uint s = uint(last_tex_env_out.g * 0xFF);
-ivec2 image_coord = ivec2(gl_FragCoord.xy);
+        out += ShadowBufferUpdate;
+    } else {
+        out += "gl_FragDepth = depth;\n";
+        // Round the final fragment color to maintain the PICA's 8 bits of precision
+        out += "color = byteround(last_tex_env_out);\n";
+    }
 
-uint old = imageLoad(shadow_buffer, image_coord).x;
-uint new;
-uint old2;
-do {
-    old2 = old;
+    out += "}";
 
-    uvec2 ref = DecodeShadow(old);
-    if (d < ref.x) {
-        if (s == 0u) {
-            ref.x = d;
+    return out;
+}
+
+std::string GenerateUberFragmentShader(bool separable_shader) {
+    std::string out = GetFragmentShaderHeader(separable_shader);
+
+    // The bit fields decoded here are laid out in UberShaderConfig
+    out += R"(
+uniform uvec4 uber_tev_stages[NUM_TEV_STAGES];
+uniform uint uber_state;
+uniform uint uber_lighting;
+uniform uint uber_lights[NUM_LIGHTS];
+uniform uint uber_luts[7];
+uniform float uber_lut_scales[7];
+
+#define LUT_D0 0
+#define LUT_D1 1
+#define LUT_SP 2
+#define LUT_FR 3
+#define LUT_RR 4
+#define LUT_RG 5
+#define LUT_RB 6
+
+uint Bits(uint value, int offset, int count) {
+    return (value >> uint(offset)) & ((1u << uint(count)) - 1u);
+}
+
+bool Bit(uint value, int offset) {
+    return Bits(value, offset, 1) != 0u;
+}
+)";
+
+    out += GetFragmentShaderHelpers("if (!Bit(uber_state, 24)) uv /= w;");
+
+    out += R"(
+vec4 rounded_primary_color;
+vec4 primary_fragment_color;
+vec4 secondary_fragment_color;
+vec4 tex_color[4];
+vec4 combiner_buffer;
+vec4 last_tex_env_out;
+
+vec3 normal;
+vec3 tangent;
+vec3 light_vector;
+vec3 spot_dir;
+vec3 half_vector;
+
+vec4 SampleTexture0() {
+    switch (Bits(uber_state, 5, 3)) {
+    case 0u: // Texture2D
+        return textureLod(tex0, texcoord0, getLod(texcoord0 * vec2(textureSize(tex0, 0))));
+    case 1u: // TextureCube
+        return texture(tex_cube, vec3(texcoord0, texcoord0_w));
+    case 2u: // Shadow2D
+        return shadowTexture(texcoord0, texcoord0_w);
+    case 3u: // Projection2D
+        return textureProj(tex0, vec3(texcoord0, texcoord0_w));
+    case 4u: // ShadowCube
+        return shadowTextureCube(texcoord0, texcoord0_w);
+    default:
+        return vec4(0.0);
+    }
+}
+
+vec4 TevSource(uint source, int stage) {
+    switch (source) {
+    case 0u: return rounded_primary_color;
+    case 1u: return primary_fragment_color;
+    case 2u: return secondary_fragment_color;
+    case 3u: return tex_color[0];
+    case 4u: return tex_color[1];
+    case 5u: return tex_color[2];
+    case 6u: return tex_color[3];
+    case 13u: return combiner_buffer;
+    case 14u: return const_color[stage];
+    case 15u: return last_tex_env_out;
+    default: return vec4(0.0);
+    }
+}
+
+vec3 TevColorModifier(uint modifier, uint source, int stage) {
+    vec4 value = TevSource(source, stage);
+    switch (modifier) {
+    case 0u: return value.rgb;
+    case 1u: return vec3(1.0) - value.rgb;
+    case 2u: return value.aaa;
+    case 3u: return vec3(1.0) - value.aaa;
+    case 4u: return value.rrr;
+    case 5u: return vec3(1.0) - value.rrr;
+    case 8u: return value.ggg;
+    case 9u: return vec3(1.0) - value.ggg;
+    case 12u: return value.bbb;
+    case 13u: return vec3(1.0) - value.bbb;
+    default: return vec3(0.0);
+    }
+}
+
+float TevAlphaModifier(uint modifier, uint source, int stage) {
+    vec4 value = TevSource(source, stage);
+    switch (modifier) {
+    case 0u: return value.a;
+    case 1u: return 1.0 - value.a;
+    case 2u: return value.r;
+    case 3u: return 1.0 - value.r;
+    case 4u: return value.g;
+    case 5u: return 1.0 - value.g;
+    case 6u: return value.b;
+    default: return 1.0 - value.b;
+    }
+}
+
+vec3 TevColorCombine(uint operation, vec3 v[3]) {
+    vec3 result;
+    switch (operation) {
+    case 0u: result = v[0]; break;
+    case 1u: result = v[0] * v[1]; break;
+    case 2u: result = v[0] + v[1]; break;
+    case 3u: result = v[0] + v[1] - vec3(0.5); break;
+    case 4u: result = v[0] * v[2] + v[1] * (vec3(1.0) - v[2]); break;
+    case 5u: result = v[0] - v[1]; break;
+    case 6u:
+    case 7u: result = vec3(dot(v[0] - vec3(0.5), v[1] - vec3(0.5)) * 4.0); break;
+    case 8u: result = v[0] * v[1] + v[2]; break;
+    case 9u: result = min(v[0] + v[1], vec3(1.0)) * v[2]; break;
+    default: result = vec3(0.0); break;
+    }
+    return clamp(result, vec3(0.0), vec3(1.0));
+}
+
+float TevAlphaCombine(uint operation, float v[3]) {
+    float result;
+    switch (operation) {
+    case 0u: result = v[0]; break;
+    case 1u: result = v[0] * v[1]; break;
+    case 2u: result = v[0] + v[1]; break;
+    case 3u: result = v[0] + v[1] - 0.5; break;
+    case 4u: result = v[0] * v[2] + v[1] * (1.0 - v[2]); break;
+    case 5u: result = v[0] - v[1]; break;
+    case 8u: result = v[0] * v[1] + v[2]; break;
+    case 9u: result = min(v[0] + v[1], 1.0) * v[2]; break;
+    default: result = 0.0; break;
+    }
+    return clamp(result, 0.0, 1.0);
+}
+
+float TevMultiplier(uint scale) {
+    return scale < 3u ? float(1u << scale) : 1.0;
+}
+
+void WriteTevStage(int index) {
+    uvec4 stage = uber_tev_stages[index];
+    uint sources = stage.x;
+    uint modifiers = stage.y;
+    uint color_op = Bits(stage.z, 0, 4);
+    uint alpha_op = Bits(stage.z, 16, 4);
+
+    // Stages that pass the previous output through are skipped, like the specialized shaders do
+    bool pass_through = color_op == 0u && alpha_op == 0u && Bits(sources, 0, 4) == 15u &&
+                        Bits(sources, 16, 4) == 15u && Bits(modifiers, 0, 4) == 0u &&
+                        Bits(modifiers, 12, 3) == 0u && TevMultiplier(Bits(stage.w, 0, 2)) == 1.0 &&
+                        TevMultiplier(Bits(stage.w, 16, 2)) == 1.0;
+    if (!pass_through) {
+        vec3 color_results[3] = vec3[3](
+            TevColorModifier(Bits(modifiers, 0, 4), Bits(sources, 0, 4), index),
+            TevColorModifier(Bits(modifiers, 4, 4), Bits(sources, 4, 4), index),
+            TevColorModifier(Bits(modifiers, 8, 4), Bits(sources, 8, 4), index));
+        vec3 color_output = byteround(TevColorCombine(color_op, color_results));
+
+        float alpha_output;
+        if (color_op == 7u) {
+            // Dot3_RGBA also places its result in the alpha component
+            alpha_output = color_output[0];
         } else {
-            s = uint(float(s) / (shadow_bias_constant + shadow_bias_linear * float(d) / float(ref.x)));
-            ref.y = min(s, ref.y);
+            float alpha_results[3] = float[3](
+                TevAlphaModifier(Bits(modifiers, 12, 3), Bits(sources, 16, 4), index),
+                TevAlphaModifier(Bits(modifiers, 16, 3), Bits(sources, 20, 4), index),
+                TevAlphaModifier(Bits(modifiers, 20, 3), Bits(sources, 24, 4), index));
+            alpha_output = byteround(TevAlphaCombine(alpha_op, alpha_results));
         }
+
+        last_tex_env_out = vec4(
+            clamp(color_output * TevMultiplier(Bits(stage.w, 0, 2)), vec3(0.0), vec3(1.0)),
+            clamp(alpha_output * TevMultiplier(Bits(stage.w, 16, 2)), 0.0, 1.0));
     }
-    new = EncodeShadow(ref);
+}
 
-} while ((old = imageAtomicCompSwap(shadow_buffer, image_coord, old, new)) != old2);
-#endif // ALLOW_SHADOW
-)";
+float LookupLightingLUTInput(int lut, int sampler, uint light_num) {
+    uint config = uber_luts[lut];
+    float index;
+    switch (Bits(config, 2, 3)) {
+    case 0u: // NH
+        index = dot(normal, normalize(half_vector));
+        break;
+    case 1u: // VH
+        index = dot(normalize(view), normalize(half_vector));
+        break;
+    case 2u: // NV
+        index = dot(normal, normalize(view));
+        break;
+    case 3u: // LN
+        index = dot(light_vector, normal);
+        break;
+    case 4u: // SP
+        index = dot(light_vector, spot_dir);
+        break;
+    case 5u: // CP, only available with configuration 7
+        if (Bit(uber_lighting, 19)) {
+            vec3 half_angle_proj = normalize(half_vector) -
+                                   normal * dot(normal, normalize(half_vector));
+            index = dot(half_angle_proj, tangent);
+        } else {
+            index = 0.0;
+        }
+        break;
+    default:
+        index = 0.0;
+        break;
+    }
+
+    float value;
+    if (Bit(config, 1)) {
+        // The specialized shaders take the two sided flag of the light slot with the light's
+        // number, rather than of the light itself.
+        index = Bit(uber_lights[int(light_num)], 4) ? abs(index) : max(index, 0.0);
+        value = LookupLightingLUTUnsigned(sampler, index);
     } else {
-        out += "gl_FragDepth = depth;\n";
-        // Round the final fragment color to maintain the PICA's 8 bits of precision
-        out += "color = byteround(last_tex_env_out);\n";
+        value = LookupLightingLUTSigned(sampler, index);
     }
+    return uber_lut_scales[lut] * value;
+}
 
-    out += "}";
+void WriteLighting() {
+    vec4 diffuse_sum = vec4(0.0, 0.0, 0.0, 1.0);
+    vec4 specular_sum = vec4(0.0, 0.0, 0.0, 1.0);
+    vec3 refl_value = vec3(0.0);
+    float dot_product = 0.0;
+    float clamp_highlights = 1.0;
+    float geo_factor = 1.0;
+
+    vec3 surface_normal = vec3(0.0, 0.0, 1.0);
+    vec3 surface_tangent = vec3(1.0, 0.0, 0.0);
+    uint bump_mode = Bits(uber_lighting, 4, 2);
+    vec3 perturbation = 2.0 * tex_color[int(Bits(uber_lighting, 6, 2))].rgb - 1.0;
+    if (bump_mode == 1u) {
+        // Bump mapping with a normal map
+        surface_normal = perturbation;
+        if (Bit(uber_lighting, 8)) {
+            // Recompute the Z component of the normal, for a more precise result
+            float val = (1.0 - (surface_normal.x*surface_normal.x +
+                                surface_normal.y*surface_normal.y));
+            surface_normal.z = sqrt(max(val, 0.0));
+        }
+    } else if (bump_mode == 2u) {
+        // Bump mapping with a tangent map
+        surface_tangent = perturbation;
+    }
+
+    vec4 normalized_normquat = normalize(normquat);
+    normal = quaternion_rotate(normalized_normquat, surface_normal);
+    tangent = quaternion_rotate(normalized_normquat, surface_tangent);
+
+    vec4 shadow = vec4(1.0);
+    if (Bit(uber_lighting, 12)) {
+        shadow = tex_color[int(Bits(uber_lighting, 17, 2))];
+        if (Bit(uber_lighting, 15)) {
+            shadow = vec4(1.0) - shadow;
+        }
+    }
+
+    int src_num = int(Bits(uber_lighting, 0, 4));
+    for (int light_index = 0; light_index < src_num; ++light_index) {
+        uint light = uber_lights[light_index];
+        uint num = Bits(light, 0, 3);
+        LightSrc src = light_src[int(num)];
+
+        if (Bit(light, 3)) {
+            light_vector = normalize(src.position);
+        } else {
+            light_vector = normalize(src.position + view);
+        }
+        spot_dir = src.spot_direction;
+        half_vector = normalize(view) + light_vector;
+
+        if (Bit(light, 4)) {
+            dot_product = abs(dot(light_vector, normal));
+        } else {
+            dot_product = max(dot(light_vector, normal), 0.0);
+        }
+
+        if (Bit(uber_lighting, 9)) {
+            clamp_highlights = sign(dot_product);
+        }
+
+        float spot_atten = 1.0;
+        if (Bit(light, 6)) {
+            spot_atten = LookupLightingLUTInput(LUT_SP, 8 + int(num), num);
+        }
+
+        float dist_atten = 1.0;
+        if (Bit(light, 5)) {
+            float index = clamp(src.dist_atten_scale * length(-view - src.position) +
+                                src.dist_atten_bias, 0.0, 1.0);
+            dist_atten = LookupLightingLUTUnsigned(16 + int(num), index);
+        }
+
+        if (Bit(light, 7) || Bit(light, 8)) {
+            geo_factor = dot(half_vector, half_vector);
+            geo_factor = geo_factor == 0.0 ? 0.0 : min(dot_product / geo_factor, 1.0);
+        }
+
+        float d0_lut_value = 1.0;
+        if (Bit(uber_luts[LUT_D0], 0)) {
+            d0_lut_value = LookupLightingLUTInput(LUT_D0, 0, num);
+        }
+        vec3 specular_0 = d0_lut_value * src.specular_0;
+        if (Bit(light, 7)) {
+            specular_0 *= geo_factor;
+        }
+
+        refl_value.r = 1.0;
+        if (Bit(uber_luts[LUT_RR], 0)) {
+            refl_value.r = LookupLightingLUTInput(LUT_RR, 6, num);
+        }
+        refl_value.g = refl_value.r;
+        if (Bit(uber_luts[LUT_RG], 0)) {
+            refl_value.g = LookupLightingLUTInput(LUT_RG, 5, num);
+        }
+        refl_value.b = refl_value.r;
+        if (Bit(uber_luts[LUT_RB], 0)) {
+            refl_value.b = LookupLightingLUTInput(LUT_RB, 4, num);
+        }
+
+        float d1_lut_value = 1.0;
+        if (Bit(uber_luts[LUT_D1], 0)) {
+            d1_lut_value = LookupLightingLUTInput(LUT_D1, 1, num);
+        }
+        vec3 specular_1 = d1_lut_value * refl_value * src.specular_1;
+        if (Bit(light, 8)) {
+            specular_1 *= geo_factor;
+        }
+
+        // Only the last entry in the light slots applies the Fresnel factor
+        if (light_index == src_num - 1 && Bit(uber_luts[LUT_FR], 0)) {
+            float value = LookupLightingLUTInput(LUT_FR, 3, num);
+            if (Bit(uber_lighting, 10)) {
+                diffuse_sum.a = value;
+            }
+            if (Bit(uber_lighting, 11)) {
+                specular_sum.a = value;
+            }
+        }
+
+        vec3 shadow_primary = vec3(1.0);
+        vec3 shadow_secondary = vec3(1.0);
+        if (Bit(light, 9)) {
+            if (Bit(uber_lighting, 13)) {
+                shadow_primary = shadow.rgb;
+            }
+            if (Bit(uber_lighting, 14)) {
+                shadow_secondary = shadow.rgb;
+            }
+        }
+
+        diffuse_sum.rgb += ((src.diffuse * dot_product) + src.ambient) * dist_atten * spot_atten *
+                           shadow_primary;
+        specular_sum.rgb += (specular_0 + specular_1) * clamp_highlights * dist_atten *
+                            spot_atten * shadow_secondary;
+    }
+
+    // Apply shadow attenuation to alpha components if enabled
+    if (Bit(uber_lighting, 16)) {
+        if (Bit(uber_lighting, 10)) {
+            diffuse_sum.a *= shadow.a;
+        }
+        if (Bit(uber_lighting, 11)) {
+            specular_sum.a *= shadow.a;
+        }
+    }
+
+    diffuse_sum.rgb += lighting_global_ambient;
+    primary_fragment_color = clamp(diffuse_sum, vec4(0.0), vec4(1.0));
+    secondary_fragment_color = clamp(specular_sum, vec4(0.0), vec4(1.0));
+}
+
+bool AlphaTestFails(int alpha) {
+    switch (Bits(uber_state, 0, 3)) {
+    case 0u: return true;
+    case 2u: return alpha != alphatest_ref;
+    case 3u: return alpha == alphatest_ref;
+    case 4u: return alpha >= alphatest_ref;
+    case 5u: return alpha > alphatest_ref;
+    case 6u: return alpha <= alphatest_ref;
+    case 7u: return alpha < alphatest_ref;
+    default: return false;
+    }
+}
+
+void main() {
+    rounded_primary_color = byteround(primary_color);
+    primary_fragment_color = vec4(0.0);
+    secondary_fragment_color = vec4(0.0);
+
+    // Never
+    if (Bits(uber_state, 0, 3) == 0u) {
+        discard;
+    }
+
+    // Keep only the pixels inside the scissor box in the Include mode, and only the pixels outside
+    // of it in the Exclude mode
+    uint scissor_mode = Bits(uber_state, 3, 2);
+    if (scissor_mode != 0u) {
+        bool inside_scissor = gl_FragCoord.x >= scissor_x1 && gl_FragCoord.y >= scissor_y1 &&
+                              gl_FragCoord.x < scissor_x2 && gl_FragCoord.y < scissor_y2;
+        if (inside_scissor != (scissor_mode == 3u)) {
+            discard;
+        }
+    }
+
+    float z_over_w = 2.0 * gl_FragCoord.z - 1.0;
+    float depth = z_over_w * depth_scale + depth_offset;
+    if (Bit(uber_state, 17)) {
+        depth /= gl_FragCoord.w;
+    }
+
+    // All textures are sampled up front, in uniform control flow
+    tex_color[0] = SampleTexture0();
+    tex_color[1] = textureLod(tex1, texcoord1, getLod(texcoord1 * vec2(textureSize(tex1, 0))));
+    vec2 texcoord2_used = Bit(uber_state, 8) ? texcoord1 : texcoord2;
+    tex_color[2] = textureLod(tex2, texcoord2_used,
+                              getLod(texcoord2_used * vec2(textureSize(tex2, 0))));
+    tex_color[3] = vec4(0.0);
+
+    if (Bit(uber_state, 22)) {
+        WriteLighting();
+    }
+
+    combiner_buffer = vec4(0.0);
+    vec4 next_combiner_buffer = tev_combiner_buffer_color;
+    last_tex_env_out = vec4(0.0);
+    for (int index = 0; index < NUM_TEV_STAGES; ++index) {
+        WriteTevStage(index);
+
+        combiner_buffer = next_combiner_buffer;
+        if (index < 4) {
+            if (Bit(uber_state, 9 + index)) {
+                next_combiner_buffer.rgb = last_tex_env_out.rgb;
+            }
+            if (Bit(uber_state, 13 + index)) {
+                next_combiner_buffer.a = last_tex_env_out.a;
+            }
+        }
+    }
+
+    if (AlphaTestFails(int(last_tex_env_out.a * 255.0))) {
+        discard;
+    }
+
+    uint fog_mode = Bits(uber_state, 18, 3);
+    if (fog_mode == 5u) {
+        float fog_index = Bit(uber_state, 21) ? (1.0 - depth) * 128.0 : depth * 128.0;
+        float fog_i = clamp(floor(fog_index), 0.0, 127.0);
+        float fog_f = fog_index - fog_i;
+        vec2 fog_lut_entry = texelFetch(texture_buffer_lut_rg, int(fog_i) + fog_lut_offset).rg;
+        float fog_factor = fog_lut_entry.r + fog_lut_entry.g * fog_f;
+        fog_factor = clamp(fog_factor, 0.0, 1.0);
+        last_tex_env_out.rgb = mix(fog_color.rgb, last_tex_env_out.rgb, fog_factor);
+    } else if (fog_mode == 7u) {
+        // Gas mode is not implemented
+        discard;
+    }
+
+    if (Bit(uber_state, 23)) {
+)";
+    out += ShadowBufferUpdate;
+    out += R"(
+    } else {
+        gl_FragDepth = depth;
+        color = byteround(last_tex_env_out);
+    }
+}
+)";
 
     return out;
 }
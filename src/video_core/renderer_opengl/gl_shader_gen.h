@@ -10,6 +10,7 @@
 #include <optional>
 #include <string>
 #include <type_traits>
+#include "common/bit_field.h"
 #include "common/hash.h"
 #include "video_core/regs.h"
 #include "video_core/shader/shader.h"
@@ -138,6 +139,84 @@ struct PicaFSConfig : Common::HashableStruct<PicaFSConfigState> {
     bool TevStageUpdatesCombinerBufferAlpha(unsigned stage_index) const {
         return (stage_index < 4) && ((state.combiner_buffer_input >> 4) & (1 << stage_index));
     }
+
+    /// Whether the ubershader can render this configuration. Procedural textures are not
+    /// supported by it.
+    bool SupportedByUberShader() const {
+        return !state.proctex.enable;
+    }
+};
+
+/**
+ * The state of a PicaFSConfig, packed into the uniforms the ubershader reads it from. The bit field
+ * layouts must match the decoding in the shader generated by GenerateUberFragmentShader.
+ */
+struct UberShaderConfig {
+    union State {
+        u32 raw;
+        BitField<0, 3, u32> alpha_test_func;
+        BitField<3, 2, u32> scissor_test_mode;
+        BitField<5, 3, u32> texture0_type;
+        BitField<8, 1, u32> texture2_use_coord1;
+        BitField<9, 4, u32> combiner_buffer_update_rgb;
+        BitField<13, 4, u32> combiner_buffer_update_a;
+        BitField<17, 1, u32> w_buffering;
+        BitField<18, 3, u32> fog_mode;
+        BitField<21, 1, u32> fog_flip;
+        BitField<22, 1, u32> lighting_enable;
+        BitField<23, 1, u32> shadow_rendering;
+        BitField<24, 1, u32> shadow_texture_orthographic;
+    };
+
+    union Lighting {
+        u32 raw;
+        BitField<0, 4, u32> src_num;
+        BitField<4, 2, u32> bump_mode;
+        BitField<6, 2, u32> bump_selector;
+        BitField<8, 1, u32> bump_renorm;
+        BitField<9, 1, u32> clamp_highlights;
+        BitField<10, 1, u32> enable_primary_alpha;
+        BitField<11, 1, u32> enable_secondary_alpha;
+        BitField<12, 1, u32> enable_shadow;
+        BitField<13, 1, u32> shadow_primary;
+        BitField<14, 1, u32> shadow_secondary;
+        BitField<15, 1, u32> shadow_invert;
+        BitField<16, 1, u32> shadow_alpha;
+        BitField<17, 2, u32> shadow_selector;
+        BitField<19, 1, u32> cp_input_supported;
+    };
+
+    union Light {
+        u32 raw;
+        BitField<0, 3, u32> num;
+        BitField<3, 1, u32> directional;
+        BitField<4, 1, u32> two_sided_diffuse;
+        BitField<5, 1, u32> dist_atten_enable;
+        BitField<6, 1, u32> spot_atten_enable;
+        BitField<7, 1, u32> geometric_factor_0;
+        BitField<8, 1, u32> geometric_factor_1;
+        BitField<9, 1, u32> shadow_enable;
+    };
+
+    /// LUT enables already account for the samplers the lighting configuration supports
+    union Lut {
+        u32 raw;
+        BitField<0, 1, u32> enable;
+        BitField<1, 1, u32> abs_input;
+        BitField<2, 3, Pica::LightingRegs::LightingLutInput> type;
+    };
+
+    enum LutIndex : std::size_t { D0, D1, SP, FR, RR, RG, RB, NumLuts };
+
+    /// Sources, modifiers, operations and scales of each TEV stage
+    std::array<u32, 4 * 6> tev_stages;
+    State state;
+    Lighting lighting;
+    std::array<Light, 8> lights;
+    std::array<Lut, NumLuts> luts;
+    std::array<float, NumLuts> lut_scales;
+
+    static UberShaderConfig BuildFromFSConfig(const PicaFSConfig& config);
 };
 
 /**
@@ -226,6 +305,15 @@ std::string GenerateFixedGeometryShader(const PicaFixedGSConfig& config, bool se
  */
 std::string GenerateFragmentShader(const PicaFSConfig& config, bool separable_shader);
 
+/**
+ * Generates the GLSL source code of the ubershader, a fragment shader that can emulate every
+ * configuration PicaFSConfig::SupportedByUberShader() accepts. The configuration is read from
+ * uniforms, see UberShaderConfig, instead of being compiled in.
+ * @param separable_shader generates shader that can be used for separate shader object
+ * @returns String of the shader source code
+ */
+std::string GenerateUberFragmentShader(bool separable_shader);
+
 } // namespace OpenGL
 
 namespace std {
@@ -3,11 +3,16 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <boost/functional/hash.hpp>
 #include "core/core.h"
+#include "core/frontend/emu_window.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 
@@ -235,6 +240,10 @@ public:
         shaders.emplace(key, std::move(stage));
     }
 
+    bool Contains(const KeyConfigType& key) const {
+        return shaders.find(key) != shaders.end();
+    }
+
 private:
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage> shaders;
@@ -303,15 +312,161 @@ using FixedGeometryShaders =
 
 using FragmentShaders = ShaderCache<PicaFSConfig, &GenerateFragmentShader, GL_FRAGMENT_SHADER>;
 
+/**
+ * Compiles fragment shaders into separable programs on a background thread, which has a context
+ * shared with the rasterizer's current.
+ */
+class FragmentShaderCompiler {
+public:
+    struct Result {
+        PicaFSConfig config;
+        OGLProgram program;
+        std::chrono::steady_clock::time_point queue_time;
+    };
+
+    explicit FragmentShaderCompiler(std::unique_ptr<Frontend::GraphicsContext> context)
+        : thread(&FragmentShaderCompiler::Run, this, std::move(context)) {}
+
+    ~FragmentShaderCompiler() {
+        {
+            std::scoped_lock lock(mutex);
+            stop = true;
+        }
+        cv.notify_one();
+        thread.join();
+    }
+
+    void Queue(const PicaFSConfig& config, std::string source) {
+        {
+            std::scoped_lock lock(mutex);
+            jobs.push_back({config, std::move(source), std::chrono::steady_clock::now()});
+        }
+        cv.notify_one();
+    }
+
+    /// Returns the programs that finished compiling since the last call
+    std::vector<Result> TakeFinished() {
+        std::scoped_lock lock(mutex);
+        return std::exchange(finished, {});
+    }
+
+private:
+    struct Job {
+        PicaFSConfig config;
+        std::string source;
+        std::chrono::steady_clock::time_point queue_time;
+    };
+
+    void Run(std::unique_ptr<Frontend::GraphicsContext> context) {
+        context->MakeCurrent();
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [this] { return stop || !jobs.empty(); });
+                if (stop) {
+                    break;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            OGLShader shader;
+            shader.Create(job.source.c_str(), GL_FRAGMENT_SHADER);
+            OGLProgram program;
+            program.Create(true, {shader.handle});
+            // Objects are only guaranteed to be complete in other contexts once the commands that
+            // built them have finished
+            glFinish();
+
+            std::scoped_lock lock(mutex);
+            finished.push_back({job.config, std::move(program), job.queue_time});
+        }
+        context->DoneCurrent();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Job> jobs;
+    std::vector<Result> finished;
+    bool stop = false;
+    // Declared last, so that the members above exist by the time the thread starts
+    std::thread thread;
+};
+
 class ShaderProgramManager::Impl {
 public:
-    explicit Impl(bool separable, bool is_amd)
+    explicit Impl(bool separable, bool is_amd,
+                  std::unique_ptr<Frontend::GraphicsContext> compile_context)
         : is_amd(is_amd), separable(separable), programmable_vertex_shaders(separable),
           trivial_vertex_shader(separable), fixed_geometry_shaders(separable),
-          fragment_shaders(separable), disk_cache(separable) {
+          fragment_shaders(separable), uber_shader(separable), disk_cache(separable) {
         if (separable) {
             pipeline.Create();
         }
+        if (separable && compile_context) {
+            uber_shader.Create(GenerateUberFragmentShader(true).c_str(), GL_FRAGMENT_SHADER);
+            const GLuint handle = uber_shader.GetHandle();
+            uber_locations = {
+                glGetUniformLocation(handle, "uber_tev_stages"),
+                glGetUniformLocation(handle, "uber_state"),
+                glGetUniformLocation(handle, "uber_lighting"),
+                glGetUniformLocation(handle, "uber_lights"),
+                glGetUniformLocation(handle, "uber_luts"),
+                glGetUniformLocation(handle, "uber_lut_scales"),
+            };
+            compiler = std::make_unique<FragmentShaderCompiler>(std::move(compile_context));
+        }
+    }
+
+    ~Impl() {
+        if (stats.async_compiles != 0) {
+            LOG_INFO(Render_OpenGL,
+                     "Compiled {} fragment shaders in the background, {} ms on average and {} ms "
+                     "at most. The ubershader rendered {} draws meanwhile.",
+                     stats.async_compiles,
+                     stats.total_compile_latency.count() / stats.async_compiles / 1000,
+                     stats.max_compile_latency.count() / 1000, stats.ubershader_draws);
+        }
+    }
+
+    /// Swaps in the fragment shaders the compiler finished
+    void InjectCompiledShaders() {
+        const auto now = std::chrono::steady_clock::now();
+        for (FragmentShaderCompiler::Result& result : compiler->TakeFinished()) {
+            const auto latency =
+                std::chrono::duration_cast<std::chrono::microseconds>(now - result.queue_time);
+            stats.async_compiles++;
+            stats.total_compile_latency += latency;
+            stats.max_compile_latency = std::max(stats.max_compile_latency, latency);
+
+            pending_fragment_shaders.erase(result.config);
+            fragment_shaders.Inject(result.config, {}, std::move(result.program));
+        }
+    }
+
+    /// Renders with the ubershader, uploading the given configuration to it if it changed
+    void UseUberShader(const PicaFSConfig& config) {
+        const GLuint handle = uber_shader.GetHandle();
+        if (!uber_config || *uber_config != config) {
+            const UberShaderConfig uber = UberShaderConfig::BuildFromFSConfig(config);
+            glProgramUniform4uiv(handle, uber_locations.tev_stages,
+                                 static_cast<GLsizei>(uber.tev_stages.size() / 4),
+                                 uber.tev_stages.data());
+            glProgramUniform1ui(handle, uber_locations.state, uber.state.raw);
+            glProgramUniform1ui(handle, uber_locations.lighting, uber.lighting.raw);
+            glProgramUniform1uiv(handle, uber_locations.lights,
+                                 static_cast<GLsizei>(uber.lights.size()),
+                                 &uber.lights[0].raw);
+            glProgramUniform1uiv(handle, uber_locations.luts,
+                                 static_cast<GLsizei>(uber.luts.size()), &uber.luts[0].raw);
+            glProgramUniform1fv(handle, uber_locations.lut_scales,
+                                static_cast<GLsizei>(uber.lut_scales.size()),
+                                uber.lut_scales.data());
+            uber_config = config;
+        }
+        current.fs = handle;
+        stats.ubershader_draws++;
     }
 
     struct ShaderTuple {
@@ -349,14 +504,31 @@ public:
 
     FragmentShaders fragment_shaders;
 
+    OGLShaderStage uber_shader;
+    struct {
+        GLint tev_stages;
+        GLint state;
+        GLint lighting;
+        GLint lights;
+        GLint luts;
+        GLint lut_scales;
+    } uber_locations{};
+    /// The configuration currently uploaded to the ubershader
+    std::optional<PicaFSConfig> uber_config;
+    /// Fragment shaders queued on the compiler that did not finish yet
+    std::unordered_set<PicaFSConfig> pending_fragment_shaders;
+    std::unique_ptr<FragmentShaderCompiler> compiler;
+    Stats stats;
+
     bool separable;
     std::unordered_map<ShaderTuple, OGLProgram, ShaderTuple::Hash> program_cache;
     OGLPipeline pipeline;
     ShaderDiskCache disk_cache;
 };
 
-ShaderProgramManager::ShaderProgramManager(bool separable, bool is_amd)
-    : impl(std::make_unique<Impl>(separable, is_amd)) {}
+ShaderProgramManager::ShaderProgramManager(
+    bool separable, bool is_amd, std::unique_ptr<Frontend::GraphicsContext> compile_context)
+    : impl(std::make_unique<Impl>(separable, is_amd, std::move(compile_context))) {}
 
 ShaderProgramManager::~ShaderProgramManager() = default;
 
@@ -394,18 +566,36 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
     impl->current.gs = 0;
 }
 
-void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
+bool ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
     PicaFSConfig config = PicaFSConfig::BuildFromRegs(regs);
+    OpenGL::ShaderDiskCache& disk_cache = impl->disk_cache;
+    const auto save_to_disk_cache = [&](const ShaderDecompiler::ProgramResult& result) {
+        u64 unique_identifier = GetUniqueIdentifier(regs, {});
+        ShaderDiskCacheRaw raw{unique_identifier, ProgramType::FS, regs, {}};
+        disk_cache.SaveRaw(raw);
+        disk_cache.SaveDecompiled(unique_identifier, result);
+    };
+
+    if (impl->compiler) {
+        impl->InjectCompiledShaders();
+        if (!impl->fragment_shaders.Contains(config) && config.SupportedByUberShader()) {
+            if (impl->pending_fragment_shaders.insert(config).second) {
+                std::string result = GenerateFragmentShader(config, true);
+                save_to_disk_cache(result);
+                impl->compiler->Queue(config, std::move(result));
+            }
+            impl->UseUberShader(config);
+            return false;
+        }
+    }
+
     auto [handle, result] = impl->fragment_shaders.Get(config);
     impl->current.fs = handle;
     // Save FS to the disk cache if its a new shader
     if (result) {
-        OpenGL::ShaderDiskCache& disk_cache = impl->disk_cache;
-        u64 unique_identifier = GetUniqueIdentifier(regs, {});
-        ShaderDiskCacheRaw raw{unique_identifier, ProgramType::FS, regs, {}};
-        disk_cache.SaveRaw(raw);
-        disk_cache.SaveDecompiled(unique_identifier, *result);
+        save_to_disk_cache(*result);
     }
+    return true;
 }
 
 void ShaderProgramManager::ApplyTo(OpenGLState& state) {
@@ -435,6 +625,10 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     }
 }
 
+ShaderProgramManager::Stats ShaderProgramManager::GetStats() const {
+    return impl->stats;
+}
+
 void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     if (!impl->separable) {
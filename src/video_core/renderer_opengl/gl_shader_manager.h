@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <glad/glad.h>
 #include "video_core/rasterizer_interface.h"
@@ -17,6 +18,10 @@ namespace Core {
 class System;
 } // namespace Core
 
+namespace Frontend {
+class GraphicsContext;
+} // namespace Frontend
+
 namespace OpenGL {
 
 enum class UniformBindings : GLuint { Common, VS, GS };
@@ -99,7 +104,25 @@ static_assert(sizeof(VSUniformData) < 16384,
 /// A class that manage different shader stages and configures them with given config data.
 class ShaderProgramManager {
 public:
-    ShaderProgramManager(bool separable, bool is_amd);
+    /// Counters of the asynchronous fragment shader compilation
+    struct Stats {
+        /// Number of draws rendered with the ubershader
+        u64 ubershader_draws = 0;
+        /// Number of fragment shaders compiled in the background
+        u64 async_compiles = 0;
+        /// Time from requesting the fragment shaders to swapping them in, summed up and at most
+        std::chrono::microseconds total_compile_latency{};
+        std::chrono::microseconds max_compile_latency{};
+    };
+
+    /**
+     * @param compile_context a context shared with the rasterizer's. If given, and separable
+     *                        programs are supported, new fragment shaders are compiled on a
+     *                        background thread using it, and the ubershader renders in their place
+     *                        until they are ready.
+     */
+    ShaderProgramManager(bool separable, bool is_amd,
+                         std::unique_ptr<Frontend::GraphicsContext> compile_context);
     ~ShaderProgramManager();
 
     void LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -113,10 +136,17 @@ public:
 
     void UseTrivialGeometryShader();
 
-    void UseFragmentShader(const Pica::Regs& config);
+    /**
+     * Selects the fragment shader for the given Pica state.
+     * @returns false if the ubershader stands in for a shader that is still compiling. The caller
+     *          should then select the fragment shader again for the next draw.
+     */
+    bool UseFragmentShader(const Pica::Regs& config);
 
     void ApplyTo(OpenGLState& state);
 
+    Stats GetStats() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
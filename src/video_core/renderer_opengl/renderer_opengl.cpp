@@ -438,21 +438,48 @@ void RendererOpenGL::RenderVideoDumping() {
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frame_dumping_framebuffer.handle);
         DrawScreens(layout);
 
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, frame_dumping_pbos[current_pbo].handle);
-        glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, frame_dumping_pbos[next_pbo].handle);
+        FlushVideoDumpingPBOs(layout);
 
-        GLubyte* pixels = static_cast<GLubyte*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
-        VideoDumper::VideoFrame frame_data{layout.width, layout.height, pixels};
-        Core::System::GetInstance().VideoDumper().AddVideoFrame(frame_data);
+        FrameDumpingPBO& pbo = frame_dumping_pbos[next_pbo];
+        if (pbo.fence != nullptr) {
+            // Every PBO is in flight, wait for the oldest one
+            ReadVideoDumpingPBO(pbo, layout);
+        }
 
-        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.buffer.handle);
+        glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        current_pbo = (current_pbo + 1) % 2;
-        next_pbo = (current_pbo + 1) % 2;
+        pbo.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        next_pbo = (next_pbo + 1) % frame_dumping_pbos.size();
     }
 }
 
+void RendererOpenGL::FlushVideoDumpingPBOs(const Layout::FramebufferLayout& layout) {
+    for (std::size_t i = 0; i < frame_dumping_pbos.size(); ++i) {
+        FrameDumpingPBO& pbo = frame_dumping_pbos[(next_pbo + i) % frame_dumping_pbos.size()];
+        if (pbo.fence == nullptr) {
+            continue;
+        }
+        if (glClientWaitSync(pbo.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+        ReadVideoDumpingPBO(pbo, layout);
+    }
+}
+
+void RendererOpenGL::ReadVideoDumpingPBO(FrameDumpingPBO& pbo,
+                                         const Layout::FramebufferLayout& layout) {
+    glClientWaitSync(pbo.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(pbo.fence);
+    pbo.fence = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.buffer.handle);
+    const auto* pixels = static_cast<const u8*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    Core::System::GetInstance().VideoDumper().AddVideoFrame(layout.width, layout.height, pixels);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
 /**
  * Loads framebuffer from emulated memory into the active OpenGL texture.
  */
@@ -919,21 +946,27 @@ void RendererOpenGL::InitVideoDumpingGLObjects() {
                               frame_dumping_renderbuffer);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 
-    for (OpenGL::OGLBuffer& buffer : frame_dumping_pbos) {
-        buffer.Create();
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+    for (FrameDumpingPBO& pbo : frame_dumping_pbos) {
+        pbo.buffer.Create();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.buffer.handle);
         glBufferData(GL_PIXEL_PACK_BUFFER, layout.width * layout.height * 4, nullptr,
                      GL_STREAM_READ);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
+    next_pbo = 0;
 }
 
 void RendererOpenGL::ReleaseVideoDumpingGLObjects() {
     frame_dumping_framebuffer.Release();
     glDeleteRenderbuffers(1, &frame_dumping_renderbuffer);
 
-    for (OpenGL::OGLBuffer& buffer : frame_dumping_pbos) {
-        buffer.Release();
+    // Frames still being read back are dropped, as the dumper has already been stopped
+    for (FrameDumpingPBO& pbo : frame_dumping_pbos) {
+        if (pbo.fence != nullptr) {
+            glDeleteSync(pbo.fence);
+            pbo.fence = nullptr;
+        }
+        pbo.buffer.Release();
     }
 }
 
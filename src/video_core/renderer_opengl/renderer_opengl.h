@@ -67,6 +67,11 @@ public:
     void CleanupVideoDumping() override;
 
 private:
+    struct FrameDumpingPBO {
+        OGLBuffer buffer;
+        GLsync fence{};
+    };
+
     void InitOpenGLObjects();
     void ReloadSampler();
     void ReloadShader();
@@ -90,6 +95,11 @@ private:
 
     void InitVideoDumpingGLObjects();
     void ReleaseVideoDumpingGLObjects();
+    /// Hands finished frames to the video dumper in order, stopping at the first one still
+    /// being read back.
+    void FlushVideoDumpingPBOs(const Layout::FramebufferLayout& layout);
+    /// Waits for the readback into a PBO to finish and hands its frame to the video dumper.
+    void ReadVideoDumpingPBO(FrameDumpingPBO& pbo, const Layout::FramebufferLayout& layout);
 
     OpenGLState state;
 
@@ -126,10 +136,11 @@ private:
     std::atomic_bool prepare_video_dumping = false;
     std::atomic_bool cleanup_video_dumping = false;
 
-    // PBOs used to dump frames faster
-    std::array<OGLBuffer, 2> frame_dumping_pbos;
-    GLuint current_pbo = 1;
-    GLuint next_pbo = 0;
+    // Ring of PBOs used to read dumped frames back asynchronously. A frame is handed to the video
+    // dumper once the fence placed after its glReadPixels has been signaled.
+    std::array<FrameDumpingPBO, 3> frame_dumping_pbos;
+    /// Next PBO to read into. It is also the oldest one still in flight, if any.
+    std::size_t next_pbo = 0;
 };
 
 } // namespace OpenGL
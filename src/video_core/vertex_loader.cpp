@@ -1,4 +1,6 @@
+#include <cstring>
 #include <memory>
+#include <tuple>
 #include <boost/range/algorithm/fill.hpp>
 #include "common/alignment.h"
 #include "common/assert.h"
@@ -17,6 +19,39 @@
 
 namespace Pica {
 
+namespace {
+/**
+ * Loads an attribute of N elements of type T. The element count and type are known at compile
+ * time, so the compiler unrolls the conversion and vectorizes it where the host allows.
+ */
+template <typename T, u32 N>
+void LoadAttribute(const u8* source, Common::Vec4<float24>& attribute) {
+    std::array<T, N> elements;
+    std::memcpy(elements.data(), source, sizeof(elements));
+
+    // Default attribute values set if array elements have < 4 components. This
+    // is *not* carried over from the default attribute settings even if they're
+    // enabled for this attribute.
+    std::array<float, 4> values{0.0f, 0.0f, 0.0f, 1.0f};
+    for (u32 i = 0; i < N; ++i) {
+        values[i] = static_cast<float>(elements[i]);
+    }
+    for (u32 i = 0; i < 4; ++i) {
+        attribute[i] = float24::FromFloat32(values[i]);
+    }
+}
+
+using Loader = void (*)(const u8* source, Common::Vec4<float24>& attribute);
+
+template <typename T>
+constexpr std::array<Loader, 4> LoadersFor{LoadAttribute<T, 1>, LoadAttribute<T, 2>,
+                                           LoadAttribute<T, 3>, LoadAttribute<T, 4>};
+
+/// Fetch routines, indexed by VertexAttributeFormat and element count minus one
+constexpr std::array<std::array<Loader, 4>, 4> AttributeLoaders{
+    LoadersFor<s8>, LoadersFor<u8>, LoadersFor<s16>, LoadersFor<float>};
+} // Anonymous namespace
+
 void VertexLoader::Setup(const PipelineRegs& regs) {
     ASSERT_MSG(!is_setup, "VertexLoader is not intended to be setup more than once.");
 
@@ -69,73 +104,44 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
         }
     }
 
+    // Resolve the attribute arrays once for the whole batch, instead of once per vertex
+    base_address = attribute_config.GetPhysicalBaseAddress();
+    for (int i = 0; i < num_total_attributes; ++i) {
+        if (vertex_attribute_elements[i] == 0) {
+            continue;
+        }
+
+        const u32 element_size = attribute_config.GetElementSizeInBytes(i);
+        vertex_attribute_loaders[i] =
+            AttributeLoaders[static_cast<u32>(vertex_attribute_formats[i])]
+                            [vertex_attribute_elements[i] - 1];
+        vertex_attribute_sizes[i] = vertex_attribute_elements[i] * element_size;
+        std::tie(vertex_attribute_pointers[i], vertex_attribute_spans[i]) =
+            VideoCore::g_memory->GetPhysicalSpan(base_address + vertex_attribute_sources[i]);
+    }
+
     is_setup = true;
 }
 
-void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
-                              Shader::AttributeBuffer& input,
+void VertexLoader::LoadVertex(int index, int vertex, Shader::AttributeBuffer& input,
                               DebugUtils::MemoryAccessTracker& memory_accesses) {
     ASSERT_MSG(is_setup, "A VertexLoader needs to be setup before loading vertices.");
 
     for (int i = 0; i < num_total_attributes; ++i) {
         if (vertex_attribute_elements[i] != 0) {
             // Load per-vertex data from the loader arrays
-            u32 source_addr =
-                base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
+            const u32 offset = vertex_attribute_strides[i] * vertex;
 
             if (g_debug_context && Pica::g_debug_context->recorder) {
-                memory_accesses.AddAccess(
-                    source_addr,
-                    vertex_attribute_elements[i] *
-                        ((vertex_attribute_formats[i] == PipelineRegs::VertexAttributeFormat::FLOAT)
-                             ? 4
-                             : (vertex_attribute_formats[i] ==
-                                PipelineRegs::VertexAttributeFormat::SHORT)
-                                   ? 2
-                                   : 1));
+                memory_accesses.AddAccess(base_address + vertex_attribute_sources[i] + offset,
+                                          vertex_attribute_sizes[i]);
             }
 
-            switch (vertex_attribute_formats[i]) {
-            case PipelineRegs::VertexAttributeFormat::BYTE: {
-                const s8* srcdata = reinterpret_cast<const s8*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::UBYTE: {
-                const u8* srcdata = reinterpret_cast<const u8*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::SHORT: {
-                const s16* srcdata = reinterpret_cast<const s16*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::FLOAT: {
-                const float* srcdata = reinterpret_cast<const float*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            }
-
-            // Default attribute values set if array elements have < 4 components. This
-            // is *not* carried over from the default attribute settings even if they're
-            // enabled for this attribute.
-            for (unsigned int comp = vertex_attribute_elements[i]; comp < 4; ++comp) {
-                input.attr[i][comp] =
-                    comp == 3 ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
+            if (vertex_attribute_spans[i] >= vertex_attribute_sizes[i] &&
+                offset <= vertex_attribute_spans[i] - vertex_attribute_sizes[i]) {
+                vertex_attribute_loaders[i](vertex_attribute_pointers[i] + offset, input.attr[i]);
+            } else {
+                LoadAttributeSlow(i, vertex, input.attr[i]);
             }
 
             LOG_TRACE(HW_GPU,
@@ -161,4 +167,17 @@ void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
     }
 }
 
+void VertexLoader::LoadAttributeSlow(int i, int vertex, Common::Vec4<float24>& attribute) const {
+    const u32 source_addr =
+        base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
+    const auto [source, span] = VideoCore::g_memory->GetPhysicalSpan(source_addr);
+    if (span < vertex_attribute_sizes[i]) {
+        LOG_ERROR(HW_GPU, "Attribute {} of vertex {} is outside of memory at 0x{:08X}", i, vertex,
+                  source_addr);
+        attribute = {float24::Zero(), float24::Zero(), float24::Zero(), float24::FromFloat32(1.0f)};
+        return;
+    }
+    vertex_attribute_loaders[i](source, attribute);
+}
+
 } // namespace Pica
@@ -2,6 +2,8 @@
 
 #include <array>
 #include "common/common_types.h"
+#include "common/vector_math.h"
+#include "video_core/pica_types.h"
 #include "video_core/regs_pipeline.h"
 
 namespace Pica {
@@ -21,8 +23,12 @@ public:
         Setup(regs);
     }
 
+    /**
+     * Picks a specialized fetch routine for each attribute of the layout, and resolves the
+     * attribute arrays of the batch to host pointers.
+     */
     void Setup(const PipelineRegs& regs);
-    void LoadVertex(u32 base_address, int index, int vertex, Shader::AttributeBuffer& input,
+    void LoadVertex(int index, int vertex, Shader::AttributeBuffer& input,
                     DebugUtils::MemoryAccessTracker& memory_accesses);
 
     int GetNumTotalAttributes() const {
@@ -30,11 +36,25 @@ public:
     }
 
 private:
+    /// Converts one attribute to float24, filling the components it does not have.
+    using AttributeLoader = void (*)(const u8* source, Common::Vec4<float24>& attribute);
+
+    /// Loads an attribute whose array does not lie within a single memory area.
+    void LoadAttributeSlow(int i, int vertex, Common::Vec4<float24>& attribute) const;
+
+    u32 base_address = 0;
     std::array<u32, 16> vertex_attribute_sources;
     std::array<u32, 16> vertex_attribute_strides{};
     std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
     std::array<u32, 16> vertex_attribute_elements{};
     std::array<bool, 16> vertex_attribute_is_default;
+    std::array<AttributeLoader, 16> vertex_attribute_loaders{};
+    /// Size of one attribute, in bytes
+    std::array<u32, 16> vertex_attribute_sizes{};
+    /// Host pointer to the first attribute of each array
+    std::array<const u8*, 16> vertex_attribute_pointers{};
+    /// Number of bytes accessible through vertex_attribute_pointers
+    std::array<u32, 16> vertex_attribute_spans{};
     int num_total_attributes = 0;
     bool is_setup = false;
 };
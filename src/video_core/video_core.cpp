@@ -30,6 +30,8 @@ std::atomic<bool> g_renderer_screenshot_requested;
 void* g_screenshot_bits;
 std::function<void()> g_screenshot_complete_callback;
 Layout::FramebufferLayout g_screenshot_framebuffer_layout;
+std::atomic<u64> g_texture_hash_lookups;
+std::atomic<u64> g_texture_hash_hits;
 
 Memory::MemorySystem* g_memory;
 
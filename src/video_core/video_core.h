@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <memory>
+#include "common/common_types.h"
 #include "core/frontend/emu_window.h"
 
 namespace Frontend {
@@ -40,6 +41,9 @@ extern std::atomic<bool> g_renderer_screenshot_requested;
 extern void* g_screenshot_bits;
 extern std::function<void()> g_screenshot_complete_callback;
 extern Layout::FramebufferLayout g_screenshot_framebuffer_layout;
+// Texture reloads that were hashed, and those that skipped their upload because the hash matched
+extern std::atomic<u64> g_texture_hash_lookups;
+extern std::atomic<u64> g_texture_hash_hits;
 
 extern Memory::MemorySystem* g_memory;
 